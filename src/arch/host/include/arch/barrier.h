@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifdef __SOF_BARRIER_H__
+
+#ifndef __ARCH_BARRIER_H__
+#define __ARCH_BARRIER_H__
+
+/* use gcc atomic built-ins for host library */
+static inline void arch_barrier_release(void)
+{
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void arch_barrier_acquire(void)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+#endif /* __ARCH_BARRIER_H__ */
+
+#else
+
+#error "This file shouldn't be included from outside of sof/barrier.h"
+
+#endif /* __SOF_BARRIER_H__ */
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifdef __SOF_BARRIER_H__
+
+#ifndef __ARCH_BARRIER_H__
+#define __ARCH_BARRIER_H__
+
+/* memw waits for all previous loads and stores to complete */
+static inline void arch_barrier_release(void)
+{
+	__asm__ __volatile__("memw" : : : "memory");
+}
+
+static inline void arch_barrier_acquire(void)
+{
+	__asm__ __volatile__("memw" : : : "memory");
+}
+
+#endif /* __ARCH_BARRIER_H__ */
+
+#else
+
+#error "This file shouldn't be included from outside of sof/barrier.h"
+
+#endif /* __SOF_BARRIER_H__ */
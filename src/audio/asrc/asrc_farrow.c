@@ -203,6 +203,23 @@ static enum asrc_error_code initialise_buffer(struct comp_dev *dev,
 static enum asrc_error_code initialise_filter(struct comp_dev *dev,
 					      struct asrc_farrow *src_obj);
 
+/*
+ * Calculate the impulse response for the current time value. The
+ * impulse response only depends on the fractional time and the filter,
+ * so it is kept when the time value repeats, e.g. with integer
+ * conversion ratios.
+ */
+static inline void asrc_update_ir(struct asrc_farrow *src_obj)
+{
+	if (src_obj->ir_valid &&
+	    src_obj->ir_time_value == src_obj->time_value)
+		return;
+
+	(*src_obj->calc_ir)(src_obj);
+	src_obj->ir_time_value = src_obj->time_value;
+	src_obj->ir_valid = true;
+}
+
 /*
  * FUNCTION DEFINITIONS + GENERAL SETUP
  */
@@ -371,6 +388,7 @@ enum asrc_error_code asrc_initialise(struct comp_dev *dev,
 	 * src_obj in memory.
 	 */
 	src_obj->impulse_response = (int32_t *)(src_obj + 1);
+	src_obj->ir_valid = false;
 
 	/*
 	 * Load the filter coefficients and parameters.  This function
@@ -492,6 +510,7 @@ enum asrc_error_code asrc_set_fs_ratio(struct comp_dev *dev,
 				    src_obj->num_channels *
 				    (1 + src_obj->buffer_length / 2));
 	}
+	src_obj->ir_valid = false;
 
 	return ASRC_EC_OK;
 }
@@ -780,6 +799,9 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
 		return ASRC_EC_INVALID_CONVERSION_RATIO;
 	}
 
+	/* The impulse response must be calculated with the new filter */
+	src_obj->ir_valid = false;
+
 	return ASRC_EC_OK;
 }
 
@@ -1013,7 +1035,7 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 				break;
 
 			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
+			asrc_update_ir(src_obj);
 
 			/* Filter and write one output sample for each
 			 * channel to the output_buffer
@@ -1121,7 +1143,7 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 				break;
 
 			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
+			asrc_update_ir(src_obj);
 
 			/* Filter and write output sample to
 			 * output_buffer
@@ -1241,7 +1263,7 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
 			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
+			asrc_update_ir(src_obj);
 
 			/* Filter and write output sample to output_buffer */
 			asrc_fir_filter16(src_obj, output_buffers,
@@ -1345,7 +1367,7 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
 			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
+			asrc_update_ir(src_obj);
 
 			/* Filter and write output sample to output_buffer */
 			asrc_fir_filter32(src_obj, output_buffers,
@@ -8,104 +8,128 @@
 
 #include <sof/audio/asrc/asrc_farrow.h>
 #include <sof/audio/format.h>
+#include <sof/math/numbers.h>
+
+/*
+ * The channels are filtered in pairs in lock step so that each impulse
+ * response coefficient is loaded once for both channels. The ring buffer
+ * pointers walk backwards. An odd last channel is paired with itself.
+ */
+static inline void asrc_fir_pair16(const int32_t *filter_p,
+				   const int16_t *buffer0_p,
+				   const int16_t *buffer1_p, int length,
+				   int64_t *prod0, int64_t *prod1)
+{
+	int64_t acc0 = 0;
+	int64_t acc1 = 0;
+	int32_t coef;
+	int n;
+
+	/* Data is Q1.15, coefficients are Q1.30. Prod will be Qx.45. */
+	for (n = 0; n < length; n++) {
+		coef = *filter_p++;
+		acc0 += (int64_t)(*buffer0_p--) * coef;
+		acc1 += (int64_t)(*buffer1_p--) * coef;
+	}
+
+	*prod0 = acc0;
+	*prod1 = acc1;
+}
+
+static inline void asrc_fir_pair32(const int32_t *filter_p,
+				   const int32_t *buffer0_p,
+				   const int32_t *buffer1_p, int length,
+				   int64_t *prod0, int64_t *prod1)
+{
+	int64_t acc0 = 0;
+	int64_t acc1 = 0;
+	int32_t coef;
+	int n;
+
+	/* Data is Q1.31, coefficients are Q1.22. They are down scaled by 1
+	 * shift. In addition there C is implementation specific right shift
+	 * by 8. It gives headroom to calculate up to 256 taps FIR. The use
+	 * of 24 bits of 32 bits is not a practical limitation for quality.
+	 * The product is Qx.54.
+	 */
+	for (n = 0; n < length; n++) {
+		coef = *filter_p++ >> 8;
+		acc0 += (int64_t)(*buffer0_p--) * coef;
+		acc1 += (int64_t)(*buffer1_p--) * coef;
+	}
+
+	*prod0 = acc0;
+	*prod1 = acc1;
+}
+
+static inline int16_t asrc_fir_round16(int64_t prod)
+{
+	/* Shift left after accumulation, because interim results might
+	 * saturate during filtering. Round to 16 bit.
+	 */
+	return sat_int16(Q_SHIFT_RND(sat_int32(Q_SHIFT(prod, 45, 31)), 31, 15));
+}
+
+static inline int32_t asrc_fir_round32(int64_t prod)
+{
+	return sat_int32(Q_SHIFT(prod, 53, 31));
+}
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 		       int index_output_frame)
 {
-	int64_t prod;
-	int32_t prod32;
-	int16_t prod16;
-	int32_t *filter_p;
-	int16_t *buffer_p;
+	int16_t **ring = src_obj->ring_buffers16;
+	int pos = src_obj->buffer_write_position;
+	int nch = src_obj->num_channels;
+	int64_t prod0;
+	int64_t prod1;
+	int ch1;
 	int ch;
-	int n;
 	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		i = nch * index_output_frame;
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
-
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
-
-		/* Initialise the accumulator */
-		prod = 0;
-
-		/* Iterate over the filter bins.
-		 * Data is Q1.15, coefficients are Q1.30. Prod will be Qx.45.
-		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
+	for (ch = 0; ch < nch; ch += 2) {
+		ch1 = MIN(ch + 1, nch - 1);
+		asrc_fir_pair16(src_obj->impulse_response, &ring[ch][pos],
+				&ring[ch1][pos], src_obj->filter_length,
+				&prod0, &prod1);
 
-		/* Round 'prod' to 16 bit and store it in
-		 * (de-)interleaved format in the output buffers
-		 */
-		prod16 = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
-		output_buffers[ch][i] = prod16;
+		/* Store in (de-)interleaved format in the output buffers */
+		output_buffers[ch][i] = asrc_fir_round16(prod0);
+		output_buffers[ch1][i] = asrc_fir_round16(prod1);
 	}
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 		       int index_output_frame)
 {
-	int64_t prod;
-	int32_t prod32;
-	const int32_t *filter_p;
-	int32_t *buffer_p;
+	int32_t **ring = src_obj->ring_buffers32;
+	int pos = src_obj->buffer_write_position;
+	int nch = src_obj->num_channels;
+	int64_t prod0;
+	int64_t prod1;
+	int ch1;
 	int ch;
-	int n;
 	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		i = nch * index_output_frame;
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
-
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
+	for (ch = 0; ch < nch; ch += 2) {
+		ch1 = MIN(ch + 1, nch - 1);
+		asrc_fir_pair32(src_obj->impulse_response, &ring[ch][pos],
+				&ring[ch1][pos], src_obj->filter_length,
+				&prod0, &prod1);
 
-		/* Initialise the accumulator */
-		prod = 0;
-
-		/* Iterate over the filter bins. Data is Q1.31, coefficients
-		 * are Q1.22. They are down scaled by 1 shift. In addition
-		 * there C is implementation specific right shift by 8. It
-		 * gives headroom to calculate up to 256 taps FIR. The use
-		 * of 24 bits of 32 bits is not a practical limitation for
-		 * quality. The product is Qx.54.
-		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++ >> 8);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 53, 31));
-
-		/* Store 'prod' in (de-)interleaved format in the output
-		 * buffers
-		 */
-		output_buffers[ch][i] = prod32;
+		/* Store in (de-)interleaved format in the output buffers */
+		output_buffers[ch][i] = asrc_fir_round32(prod0);
+		output_buffers[ch1][i] = asrc_fir_round32(prod1);
 	}
 }
 
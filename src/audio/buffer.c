@@ -65,6 +65,7 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 
 	list_init(&buffer->source_list);
 	list_init(&buffer->sink_list);
+	list_init(&buffer->cb_list);
 	spinlock_init(buffer->lock);
 
 	return buffer;
@@ -74,13 +75,20 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 {
 	struct comp_buffer *buffer;
+	struct mm_usage *usage;
+	struct mm_usage *prev;
 
 	tr_info(&buffer_tr, "buffer new size 0x%x id %d.%d flags 0x%x",
 		desc->size, desc->comp.pipeline_id, desc->comp.id, desc->flags);
 
 	/* allocate buffer */
+	usage = mm_usage_new(MM_USAGE_BUFFER, desc->comp.id,
+			     desc->comp.pipeline_id);
+	prev = mm_usage_use(usage);
 	buffer = buffer_alloc(desc->size, desc->caps, PLATFORM_DCACHE_ALIGN);
+	mm_usage_use(prev);
 	if (buffer) {
+		buffer->mem_usage = usage;
 		buffer->id = desc->comp.id;
 		buffer->pipeline_id = desc->comp.pipeline_id;
 		buffer->core = desc->comp.core;
@@ -94,6 +102,8 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 			 &buffer_tr, sizeof(struct tr_ctx));
 
 		dcache_writeback_invalidate_region(buffer, sizeof(*buffer));
+	} else {
+		mm_usage_free(usage);
 	}
 
 	return buffer;
@@ -111,6 +121,7 @@ void buffer_zero(struct comp_buffer *buffer)
 
 int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 {
+	struct mm_usage *prev = NULL;
 	void *new_ptr = NULL;
 
 	/* validate request */
@@ -122,8 +133,13 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 	if (size == buffer->stream.size)
 		return 0;
 
+	/* stream stays charged to the buffer, not to the resizing component */
+	if (buffer->mem_usage)
+		prev = mm_usage_use(buffer->mem_usage);
 	new_ptr = rbrealloc(buffer->stream.addr, SOF_MEM_FLAG_NO_COPY,
 			    buffer->caps, size, buffer->stream.size);
+	if (buffer->mem_usage)
+		mm_usage_use(prev);
 
 	/* we couldn't allocate bigger chunk */
 	if (!new_ptr && size > buffer->stream.size) {
@@ -141,6 +157,38 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 	return 0;
 }
 
+/* Planar layout is used only when both connected components handle it */
+static uint32_t buffer_get_layout(struct comp_buffer *buffer,
+				  struct sof_ipc_stream_params *params)
+{
+	uint32_t frame_bytes;
+
+	if (params->buffer_fmt != SOF_IPC_BUFFER_NONINTERLEAVED)
+		return SOF_IPC_BUFFER_INTERLEAVED;
+
+	if (!buffer->source || !(buffer->source->drv->caps & COMP_CAPS_PLANAR) ||
+	    !buffer->sink || !(buffer->sink->drv->caps & COMP_CAPS_PLANAR))
+		return SOF_IPC_BUFFER_INTERLEAVED;
+
+	/* pipeline boundaries convert fixed point formats only */
+	switch (params->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+	case SOF_IPC_FRAME_S24_4LE:
+	case SOF_IPC_FRAME_S24_3LE:
+	case SOF_IPC_FRAME_S32_LE:
+		break;
+	default:
+		return SOF_IPC_BUFFER_INTERLEAVED;
+	}
+
+	/* each channel ring holds whole samples */
+	frame_bytes = get_frame_bytes(params->frame_fmt, params->channels);
+	if (!frame_bytes || buffer->stream.size % frame_bytes)
+		return SOF_IPC_BUFFER_INTERLEAVED;
+
+	return SOF_IPC_BUFFER_NONINTERLEAVED;
+}
+
 int buffer_set_params(struct comp_buffer *buffer, struct sof_ipc_stream_params *params,
 		      bool force_update)
 {
@@ -162,6 +210,8 @@ int buffer_set_params(struct comp_buffer *buffer, struct sof_ipc_stream_params *
 	}
 
 	buffer->buffer_fmt = params->buffer_fmt;
+	audio_stream_set_buffer_fmt(&buffer->stream,
+				    buffer_get_layout(buffer, params));
 	for (i = 0; i < SOF_IPC_MAX_CHANNELS; i++)
 		buffer->chmap[i] = params->chmap[i];
 
@@ -199,14 +249,15 @@ void buffer_free(struct comp_buffer *buffer)
 
 	buf_dbg(buffer, "buffer_free()");
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_FREE,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	notifier_obj_event(&buffer->cb_list, buffer->lock,
+			   NOTIFIER_ID_BUFFER_FREE, &cb_data);
 
 	/* In case some listeners didn't unregister from buffer's callbacks */
-	notifier_unregister_all(NULL, buffer);
+	notifier_obj_unregister_all(NULL, &buffer->cb_list, buffer->lock);
 
 	list_item_del(&buffer->source_list);
 	list_item_del(&buffer->sink_list);
+	mm_usage_free(buffer->mem_usage);
 	rfree(buffer->stream.addr);
 	rfree(buffer->lock);
 	rfree(buffer);
@@ -214,7 +265,6 @@ void buffer_free(struct comp_buffer *buffer)
 
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 {
-	uint32_t flags = 0;
 	struct buffer_cb_transact cb_data = {
 		.buffer = buffer,
 		.transaction_amount = bytes,
@@ -232,14 +282,15 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	buffer_lock(buffer, &flags);
+	if (buffer->inter_core)
+		audio_stream_produce_shared(&buffer->stream, bytes);
+	else
+		audio_stream_produce(&buffer->stream, bytes);
 
-	audio_stream_produce(&buffer->stream, bytes);
+	notifier_obj_event(&buffer->cb_list, buffer->lock,
+			   NOTIFIER_ID_BUFFER_PRODUCE, &cb_data);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
-
-	buffer_unlock(buffer, flags);
+	buffer_state_writeback(buffer);
 
 	addr = buffer->stream.addr;
 
@@ -254,7 +305,6 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 
 void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 {
-	uint32_t flags = 0;
 	struct buffer_cb_transact cb_data = {
 		.buffer = buffer,
 		.transaction_amount = bytes,
@@ -272,14 +322,12 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	buffer_lock(buffer, &flags);
-
 	audio_stream_consume(&buffer->stream, bytes);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	notifier_obj_event(&buffer->cb_list, buffer->lock,
+			   NOTIFIER_ID_BUFFER_CONSUME, &cb_data);
 
-	buffer_unlock(buffer, flags);
+	buffer_state_writeback(buffer);
 
 	addr = buffer->stream.addr;
 
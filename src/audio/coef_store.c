@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/coef_store.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/sof.h>
+#include <sof/spinlock.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Coefficient blobs are identified by crc32 and size and compared in full
+ * on a hash match. Derived tables are identified by their source address,
+ * type and parameter. A derived table holds a reference to the blob that
+ * contains its source so the address can't be reused while the table
+ * exists.
+ */
+
+/** \brief Stored blob or derived table. */
+struct coef_entry {
+	struct list_item list;		/**< list in store */
+	struct coef_entry *owner;	/**< blob containing the source */
+	const void *src;		/**< source of derived table */
+	enum coef_store_type type;	/**< entry type */
+	uint32_t key;			/**< crc32 of blob or table parameter */
+	uint32_t size;			/**< data size in bytes */
+	uint32_t refs;			/**< number of users */
+	void *data;			/**< blob or table */
+};
+
+static SHARED_DATA struct coef_store store;
+
+void coef_store_init(struct sof *sof)
+{
+	sof->coef_store = platform_shared_get(&store, sizeof(store));
+
+	spinlock_init(&sof->coef_store->lock);
+	list_init(&sof->coef_store->list);
+
+	platform_shared_commit(sof->coef_store, sizeof(*sof->coef_store));
+}
+
+static struct coef_entry *coef_find_blob(struct coef_store *cs,
+					 const void *data, uint32_t size,
+					 uint32_t key)
+{
+	struct list_item *item;
+	struct coef_entry *e;
+
+	list_for_item(item, &cs->list) {
+		e = container_of(item, struct coef_entry, list);
+		if (e->type == COEF_STORE_BLOB && e->key == key &&
+		    e->size == size && !memcmp(e->data, data, size))
+			return e;
+	}
+
+	return NULL;
+}
+
+static struct coef_entry *coef_find_derived(struct coef_store *cs,
+					    const void *src,
+					    enum coef_store_type type,
+					    uint32_t param)
+{
+	struct list_item *item;
+	struct coef_entry *e;
+
+	list_for_item(item, &cs->list) {
+		e = container_of(item, struct coef_entry, list);
+		if (e->type == type && e->src == src && e->key == param)
+			return e;
+	}
+
+	return NULL;
+}
+
+static struct coef_entry *coef_find_owner(struct coef_store *cs,
+					  const void *src)
+{
+	struct list_item *item;
+	struct coef_entry *e;
+	const char *p = src;
+
+	list_for_item(item, &cs->list) {
+		e = container_of(item, struct coef_entry, list);
+		if (e->type == COEF_STORE_BLOB && p >= (char *)e->data &&
+		    p < (char *)e->data + e->size)
+			return e;
+	}
+
+	return NULL;
+}
+
+static struct coef_entry *coef_find_data(struct coef_store *cs,
+					 const void *data)
+{
+	struct list_item *item;
+	struct coef_entry *e;
+
+	list_for_item(item, &cs->list) {
+		e = container_of(item, struct coef_entry, list);
+		if (e->data == data)
+			return e;
+	}
+
+	return NULL;
+}
+
+void *coef_store_adopt(void *data, size_t size)
+{
+	struct coef_store *cs = sof_get()->coef_store;
+	struct coef_entry *e;
+	struct coef_entry *new;
+	uint32_t flags;
+	uint32_t key;
+
+	if (!cs || !data)
+		return data;
+
+	/* Entry is allocated before the lookup so that no allocation is
+	 * done with the lock held.
+	 */
+	new = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
+		      sizeof(*new));
+	if (!new)
+		return data;
+
+	key = crc32(0, data, size);
+
+	spin_lock_irq(&cs->lock, flags);
+
+	e = coef_find_blob(cs, data, size, key);
+	if (e) {
+		e->refs++;
+	} else {
+		dcache_writeback_region(data, size);
+		new->type = COEF_STORE_BLOB;
+		new->key = key;
+		new->size = size;
+		new->refs = 1;
+		new->data = data;
+		list_item_append(&new->list, &cs->list);
+	}
+
+	platform_shared_commit(cs, sizeof(*cs));
+	spin_unlock_irq(&cs->lock, flags);
+
+	if (!e)
+		return data;
+
+	rfree(new);
+	rfree(data);
+	return e->data;
+}
+
+void *coef_store_derive(const void *src, enum coef_store_type type,
+			uint32_t param, size_t size,
+			void (*init)(void *data, void *ctx), void *ctx)
+{
+	struct coef_store *cs = sof_get()->coef_store;
+	struct coef_entry *owner = NULL;
+	struct coef_entry *new = NULL;
+	struct coef_entry *e = NULL;
+	uint32_t flags;
+	void *data;
+
+	if (cs) {
+		spin_lock_irq(&cs->lock, flags);
+
+		if (src)
+			owner = coef_find_owner(cs, src);
+
+		if (owner || !src) {
+			e = coef_find_derived(cs, src, type, param);
+			if (e)
+				e->refs++;
+		}
+
+		platform_shared_commit(cs, sizeof(*cs));
+		spin_unlock_irq(&cs->lock, flags);
+
+		if (e)
+			return e->data;
+
+		if (owner || !src)
+			new = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0,
+				      SOF_MEM_CAPS_RAM, sizeof(*new));
+	}
+
+	/* Table is computed without the lock held */
+	data = rballoc(0, SOF_MEM_CAPS_RAM, size);
+	if (!data) {
+		rfree(new);
+		return NULL;
+	}
+
+	bzero(data, size);
+	init(data, ctx);
+
+	/* Not shared if source is not a stored blob or no entry */
+	if (!new)
+		return data;
+
+	dcache_writeback_region(data, size);
+
+	spin_lock_irq(&cs->lock, flags);
+
+	/* Another instance may have derived the same table meanwhile */
+	e = coef_find_derived(cs, src, type, param);
+	if (e) {
+		e->refs++;
+	} else {
+		new->owner = owner;
+		new->src = src;
+		new->type = type;
+		new->key = param;
+		new->size = size;
+		new->refs = 1;
+		new->data = data;
+		list_item_append(&new->list, &cs->list);
+
+		/* caller keeps the owner alive until here */
+		if (owner)
+			owner->refs++;
+	}
+
+	platform_shared_commit(cs, sizeof(*cs));
+	spin_unlock_irq(&cs->lock, flags);
+
+	if (!e)
+		return data;
+
+	rfree(new);
+	rfree(data);
+	return e->data;
+}
+
+void *coef_store_get(void *data)
+{
+	struct coef_store *cs = sof_get()->coef_store;
+	struct coef_entry *e;
+	uint32_t flags;
+
+	if (!cs || !data)
+		return NULL;
+
+	spin_lock_irq(&cs->lock, flags);
+
+	e = coef_find_data(cs, data);
+	if (e)
+		e->refs++;
+
+	platform_shared_commit(cs, sizeof(*cs));
+	spin_unlock_irq(&cs->lock, flags);
+
+	return e ? data : NULL;
+}
+
+void coef_store_put(void *data)
+{
+	struct coef_store *cs = sof_get()->coef_store;
+	struct coef_entry *e = NULL;
+	uint32_t refs = 0;
+	uint32_t flags;
+
+	if (!data)
+		return;
+
+	if (cs) {
+		spin_lock_irq(&cs->lock, flags);
+
+		e = coef_find_data(cs, data);
+		if (e) {
+			refs = --e->refs;
+			if (!refs)
+				list_item_del(&e->list);
+		}
+
+		platform_shared_commit(cs, sizeof(*cs));
+		spin_unlock_irq(&cs->lock, flags);
+	}
+
+	/* still used by other instances */
+	if (refs)
+		return;
+
+	rfree(data);
+	if (!e)
+		return;
+
+	if (e->owner)
+		coef_store_put(e->owner->data);
+
+	rfree(e);
+}
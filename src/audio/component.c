@@ -4,6 +4,7 @@
 //
 // Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
 
+#include <sof/audio/coef_store.h>
 #include <sof/audio/component_ext.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
@@ -111,6 +112,8 @@ struct comp_dev *comp_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *cdev;
 	const struct comp_driver *drv;
+	struct mm_usage *usage;
+	struct mm_usage *prev;
 
 	/* find the driver for our new component */
 	drv = get_drv(comp);
@@ -130,14 +133,19 @@ struct comp_dev *comp_new(struct sof_ipc_comp *comp)
 		drv->tctx->uuid_p, comp->type, comp->pipeline_id, comp->id);
 
 	/* create the new component */
+	usage = mm_usage_new(MM_USAGE_COMP, comp->id, comp->pipeline_id);
+	prev = mm_usage_use(usage);
 	cdev = drv->ops.create(drv, comp);
+	mm_usage_use(prev);
 	if (!cdev) {
 		comp_cl_err(drv, "comp_new(): unable to create the new component");
+		mm_usage_free(usage);
 		return NULL;
 	}
 
 	list_init(&cdev->bsource_list);
 	list_init(&cdev->bsink_list);
+	cdev->mem_usage = usage;
 
 	return cdev;
 }
@@ -259,6 +267,8 @@ void sys_comp_init(struct sof *sof)
 	list_init(&sof->comp_drivers->list);
 
 	platform_shared_commit(sof->comp_drivers, sizeof(*sof->comp_drivers));
+
+	coef_store_init(sof);
 }
 
 void comp_get_copy_limits(struct comp_buffer *source, struct comp_buffer *sink,
@@ -385,11 +395,21 @@ struct comp_data_blob_handler {
 	void *data;		/**< pointer to data blob */
 	void *data_new;		/**< pointer to new data blob */
 	bool data_ready;	/**< set when data blob is fully received */
+	bool shared;		/**< blobs are kept in coefficient store */
 	uint32_t data_pos;	/**< indicates a data position in data
 				  *  sending/receiving process
 				  */
 };
 
+static void comp_release_data_blob(struct comp_data_blob_handler *blob_handler,
+				   void *data)
+{
+	if (blob_handler->shared)
+		coef_store_put(data);
+	else
+		rfree(data);
+}
+
 static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 {
 	assert(blob_handler);
@@ -397,8 +417,8 @@ static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 	if (!blob_handler->data)
 		return;
 
-	rfree(blob_handler->data);
-	rfree(blob_handler->data_new);
+	comp_release_data_blob(blob_handler, blob_handler->data);
+	comp_release_data_blob(blob_handler, blob_handler->data_new);
 	blob_handler->data = NULL;
 	blob_handler->data_new = NULL;
 	blob_handler->data_size = 0;
@@ -419,7 +439,7 @@ void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 		comp_dbg(blob_handler->dev, "comp_get_data_blob(): new data available");
 
 		/* Free "old" data blob and set data to data_new pointer */
-		rfree(blob_handler->data);
+		comp_release_data_blob(blob_handler, blob_handler->data);
 		blob_handler->data = blob_handler->data_new;
 		blob_handler->data_new = NULL;
 		blob_handler->data_ready = false;
@@ -490,6 +510,9 @@ int comp_init_data_blob(struct comp_data_blob_handler *blob_handler,
 		bzero(blob_handler->data, size);
 	}
 
+	if (blob_handler->shared)
+		blob_handler->data = coef_store_adopt(blob_handler->data, size);
+
 	blob_handler->data_new = NULL;
 	blob_handler->data_size = size;
 	blob_handler->data_ready = true;
@@ -570,12 +593,19 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 		/* The new configuration is OK to be applied */
 		blob_handler->data_ready = true;
 
+		/* Complete blob is read-only from now on */
+		if (blob_handler->shared)
+			blob_handler->data_new =
+				coef_store_adopt(blob_handler->data_new,
+						 blob_handler->data_size);
+
 		/* If component state is READY we can omit old
 		 * configuration immediately. When in playback/capture
 		 * the new configuration presence is checked in copy().
 		 */
 		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			rfree(blob_handler->data);
+			comp_release_data_blob(blob_handler,
+					       blob_handler->data);
 			blob_handler->data = NULL;
 		}
 
@@ -654,6 +684,18 @@ struct comp_data_blob_handler *comp_data_blob_handler_new(struct comp_dev *dev)
 	return handler;
 }
 
+struct comp_data_blob_handler *
+comp_data_blob_handler_new_shared(struct comp_dev *dev)
+{
+	struct comp_data_blob_handler *handler;
+
+	handler = comp_data_blob_handler_new(dev);
+	if (handler)
+		handler->shared = true;
+
+	return handler;
+}
+
 void comp_data_blob_handler_free(struct comp_data_blob_handler *blob_handler)
 {
 	if (!blob_handler)
@@ -5,6 +5,7 @@
 // Author: Sebastiano Carlucci <scarlucci@google.com>
 
 #include <sof/audio/buffer.h>
+#include <sof/audio/coef_store.h>
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
@@ -12,6 +13,7 @@
 #include <sof/audio/eq_iir/iir.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/memory.h>
@@ -41,7 +43,7 @@ DECLARE_TR_CTX(crossover_tr, SOF_UUID(crossover_uuid), LOG_LEVEL_INFO);
 
 static inline void crossover_free_config(struct sof_crossover_config **config)
 {
-	rfree(*config);
+	coef_store_put(*config);
 	*config = NULL;
 }
 
@@ -50,7 +52,7 @@ static inline void crossover_free_config(struct sof_crossover_config **config)
  */
 static inline void crossover_reset_state_lr4(struct iir_state_df2t *lr4)
 {
-	rfree(lr4->coef);
+	coef_store_put(lr4->coef);
 	rfree(lr4->delay);
 
 	lr4->coef = NULL;
@@ -72,15 +74,55 @@ static inline void crossover_reset_state_ch(struct crossover_state *ch_state)
 }
 
 /**
- * \brief Reset the state (coefficients and delay) of the crossover filter
- *	  across all channels
+ * \brief Frees the filters of all channels and releases the config.
  */
-static inline void crossover_reset_state(struct comp_data *cd)
+static void crossover_free_set(struct crossover_set *set)
 {
 	int i;
 
+	if (!set)
+		return;
+
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		crossover_reset_state_ch(&cd->state[i]);
+		crossover_reset_state_ch(&set->state[i]);
+
+	coef_store_put(set->config);
+	rfree(set);
+}
+
+static void crossover_free_sets(struct comp_data *cd)
+{
+	crossover_free_set(cd->set);
+	crossover_free_set(cd->set_new);
+	crossover_free_set(cd->set_old);
+	crossover_free_set(cd->set_done);
+	cd->set = NULL;
+	cd->set_new = NULL;
+	cd->set_old = NULL;
+	cd->set_done = NULL;
+	xfade_start(&cd->xfade, 0);
+}
+
+/**
+ * \brief Hands new filters over to a running copy(). An update copy() has
+ *	  not switched to yet is replaced, so only the latest one is applied.
+ */
+static void crossover_set_pending(struct comp_data *cd,
+				  struct crossover_set *set)
+{
+	struct crossover_set *superseded;
+	struct crossover_set *done;
+	uint32_t flags;
+
+	irq_local_disable(flags);
+	superseded = cd->set_new;
+	done = cd->set_done;
+	cd->set_new = set;
+	cd->set_done = NULL;
+	irq_local_enable(flags);
+
+	crossover_free_set(superseded);
+	crossover_free_set(done);
 }
 
 /**
@@ -172,30 +214,37 @@ static int crossover_assign_sinks(struct comp_dev *dev,
  *	       high/low pass filter.
  * \param[out] lr4 initialized struct
  */
-static int crossover_init_coef_lr4(struct sof_eq_iir_biquad_df2t *coef,
-				   struct iir_state_df2t *lr4)
+static void crossover_copy_coef_lr4(void *data, void *ctx)
 {
+	int32_t *lr4_coef = data;
 	int ret;
 
-	/* Only one set of coefficients is stored in config for both biquads
-	 * in series due to identity. To maintain the structure of
-	 * iir_state_df2t, it requires two copies of coefficients in a row.
-	 */
-	lr4->coef = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-			    sizeof(struct sof_eq_iir_biquad_df2t) * 2);
-	if (!lr4->coef)
-		return -ENOMEM;
-
 	/* coefficients of the first biquad */
-	ret = memcpy_s(lr4->coef, sizeof(struct sof_eq_iir_biquad_df2t),
-		       coef, sizeof(struct sof_eq_iir_biquad_df2t));
+	ret = memcpy_s(lr4_coef, sizeof(struct sof_eq_iir_biquad_df2t),
+		       ctx, sizeof(struct sof_eq_iir_biquad_df2t));
 	assert(!ret);
 
 	/* coefficients of the second biquad */
-	ret = memcpy_s(lr4->coef + SOF_EQ_IIR_NBIQUAD_DF2T,
+	ret = memcpy_s(lr4_coef + SOF_EQ_IIR_NBIQUAD_DF2T,
 		       sizeof(struct sof_eq_iir_biquad_df2t),
-		       coef, sizeof(struct sof_eq_iir_biquad_df2t));
+		       ctx, sizeof(struct sof_eq_iir_biquad_df2t));
 	assert(!ret);
+}
+
+static int crossover_init_coef_lr4(struct sof_eq_iir_biquad_df2t *coef,
+				   struct iir_state_df2t *lr4)
+{
+	/* Only one set of coefficients is stored in config for both biquads
+	 * in series due to identity. To maintain the structure of
+	 * iir_state_df2t, it requires two copies of coefficients in a row.
+	 * The copies are kept in the coefficient store and shared by the
+	 * channels and instances that use the same config.
+	 */
+	lr4->coef = coef_store_derive(coef, COEF_STORE_LR4, 0,
+				      sizeof(struct sof_eq_iir_biquad_df2t) * 2,
+				      crossover_copy_coef_lr4, coef);
+	if (!lr4->coef)
+		return -ENOMEM;
 
 	/* LR4 filters are two 2nd order filters, so only need 4 delay slots
 	 * delay[0..1] -> state for first biquad
@@ -247,17 +296,12 @@ static int crossover_init_coef_ch(struct sof_eq_iir_biquad_df2t *coef,
  *
  * \param nch number of channels in the audio stream.
  */
-static int crossover_init_coef(struct comp_data *cd, int nch)
+static int crossover_init_coef(struct crossover_set *set, int nch)
 {
 	struct sof_eq_iir_biquad_df2t *crossover;
-	struct sof_crossover_config *config = cd->config;
+	struct sof_crossover_config *config = set->config;
 	int ch, err;
 
-	if (!config) {
-		comp_cl_err(&comp_crossover, "crossover_init_coef(), no config is set");
-		return -EINVAL;
-	}
-
 	/* Sanity checks */
 	if (nch > PLATFORM_MAX_CHANNELS) {
 		comp_cl_err(&comp_crossover, "crossover_init_coef(), invalid channels count (%i)",
@@ -271,13 +315,11 @@ static int crossover_init_coef(struct comp_data *cd, int nch)
 	/* Collect the coef array and assign it to every channel */
 	crossover = config->coef;
 	for (ch = 0; ch < nch; ch++) {
-		err = crossover_init_coef_ch(crossover, &cd->state[ch],
+		err = crossover_init_coef_ch(crossover, &set->state[ch],
 					     config->num_sinks);
-		/* Free all previously allocated blocks in case of an error */
 		if (err < 0) {
 			comp_cl_err(&comp_crossover, "crossover_init_coef(), could not assign coefficients to ch %d",
 				    ch);
-			crossover_reset_state(cd);
 			return err;
 		}
 	}
@@ -286,20 +328,46 @@ static int crossover_init_coef(struct comp_data *cd, int nch)
 }
 
 /**
- * \brief Setup the state, coefficients and processing functions for crossover.
+ * \brief Setup the state, coefficients and split function for crossover.
  *
- * \param dev component device
+ * \param config configuration blob, referenced by the filters
+ * \param[out] set_out filters for the configuration
  */
-static int crossover_setup(struct comp_data *cd, int nch)
+static int crossover_setup(struct sof_crossover_config *config, int nch,
+			   struct crossover_set **set_out)
 {
-	int ret = 0;
+	struct crossover_set *set;
+	int ret;
+
+	set = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*set));
+	if (!set)
+		return -ENOMEM;
 
-	/* Reset any previous state */
-	crossover_reset_state(cd);
+	set->split = crossover_find_split_func(config->num_sinks);
+	if (!set->split) {
+		comp_cl_err(&comp_crossover, "crossover_setup(), No split function matching num_sinks %i",
+			    config->num_sinks);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	set->config = coef_store_get(config);
+	if (!set->config) {
+		ret = -ENOMEM;
+		goto err;
+	}
 
 	/* Assign LR4 coefficients from config */
-	ret = crossover_init_coef(cd, nch);
+	ret = crossover_init_coef(set, nch);
+	if (ret < 0)
+		goto err;
+
+	*set_out = set;
+	return 0;
 
+err:
+	/* Free all previously allocated blocks in case of an error */
+	crossover_free_set(set);
 	return ret;
 }
 
@@ -346,9 +414,8 @@ static struct comp_dev *crossover_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 
 	cd->crossover_process = NULL;
-	cd->crossover_split = NULL;
+	cd->crossover_pass = NULL;
 	cd->config = NULL;
-	cd->config_new = NULL;
 
 	if (bs) {
 		cd->config = rzalloc(SOF_MEM_ZONE_RUNTIME, 0,
@@ -361,6 +428,8 @@ static struct comp_dev *crossover_new(const struct comp_driver *drv,
 
 		ret = memcpy_s(cd->config, bs, ipc_crossover->data, bs);
 		assert(!ret);
+
+		cd->config = coef_store_adopt(cd->config, bs);
 	}
 
 	dev->state = COMP_STATE_READY;
@@ -377,9 +446,7 @@ static void crossover_free(struct comp_dev *dev)
 	comp_info(dev, "crossover_free()");
 
 	crossover_free_config(&cd->config);
-	crossover_free_config(&cd->config_new);
-
-	crossover_reset_state(cd);
+	crossover_free_sets(cd);
 
 	rfree(cd);
 	rfree(dev);
@@ -482,11 +549,54 @@ static int crossover_params(struct comp_dev *dev,
 	return err;
 }
 
+/**
+ * \brief Prepares filters for a config received while prepared or
+ *	  streaming. A running copy() switches to them and fades from the
+ *	  previous filters.
+ */
+static int crossover_update(struct comp_dev *dev,
+			    struct sof_crossover_config *config)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_buffer *source;
+	struct crossover_set *set;
+	int ret;
+
+	source = list_first_item(&dev->bsource_list, struct comp_buffer,
+				 sink_list);
+
+	if (!cd->crossover_process) {
+		comp_err(dev, "crossover_update(), No processing function matching frame_fmt %i",
+			 cd->source_format);
+		return -EINVAL;
+	}
+
+	ret = crossover_validate_config(dev, config);
+	if (ret < 0)
+		return ret;
+
+	ret = crossover_setup(config, source->stream.channels, &set);
+	if (ret < 0) {
+		comp_err(dev, "crossover_update(), setup failed");
+		return ret;
+	}
+
+	if (dev->state == COMP_STATE_ACTIVE) {
+		crossover_set_pending(cd, set);
+	} else {
+		crossover_free_sets(cd);
+		cd->set = set;
+	}
+
+	return 0;
+}
+
 static int crossover_cmd_set_data(struct comp_dev *dev,
 				  struct sof_ipc_ctrl_data *cdata)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct sof_crossover_config *request;
+	struct sof_crossover_config *config;
 	uint32_t bs;
 	int ret = 0;
 
@@ -498,42 +608,33 @@ static int crossover_cmd_set_data(struct comp_dev *dev,
 		request = (struct sof_crossover_config *)ASSUME_ALIGNED(cdata->data->data, 4);
 		bs = request->size;
 
-		/* Check that there is no work-in-progress previous request */
-		if (cd->config_new) {
-			comp_err(dev, "crossover_cmd_set_data(), busy with previous");
-			return -EBUSY;
-		}
-
 		/* Allocate and make a copy of the blob */
-		cd->config_new = rzalloc(SOF_MEM_ZONE_RUNTIME, 0,
-					 SOF_MEM_CAPS_RAM, bs);
-		if (!cd->config_new) {
+		config = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, bs);
+		if (!config) {
 			comp_err(dev, "crossover_cmd_set_data(), alloc fail");
 			return -EINVAL;
 		}
 
-		/* Copy the configuration. If the component state is ready
-		 * the Crossover will initialize in prepare().
-		 */
-		ret = memcpy_s(cd->config_new, bs, request, bs);
+		ret = memcpy_s(config, bs, request, bs);
 		assert(!ret);
 
-		/* If component state is READY we can omit old configuration
-		 * immediately. When in playback/capture the new configuration
-		 * presence is checked in copy().
-		 */
-		if (dev->state == COMP_STATE_READY)
-			crossover_free_config(&cd->config);
+		/* The configuration is read-only and shared from now on */
+		config = coef_store_adopt(config, bs);
 
-		/* If there is no existing configuration the received can
-		 * be set to current immediately. It will be applied in
-		 * prepare() when streaming starts.
+		/* If the component state is ready the Crossover will
+		 * initialize in prepare(). Otherwise the filters are set up
+		 * here for copy() to switch to.
 		 */
-		if (!cd->config) {
-			cd->config = cd->config_new;
-			cd->config_new = NULL;
+		if (dev->state >= COMP_STATE_PREPARE) {
+			ret = crossover_update(dev, config);
+			if (ret < 0) {
+				crossover_free_config(&config);
+				break;
+			}
 		}
 
+		crossover_free_config(&cd->config);
+		cd->config = config;
 		break;
 	default:
 		comp_err(dev, "crossover_cmd_set_data(), invalid command");
@@ -630,14 +731,14 @@ static int crossover_trigger(struct comp_dev *dev, int cmd)
 static int crossover_copy(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_crossover_config *config;
 	struct comp_buffer *source;
 	struct comp_buffer *sinks[SOF_CROSSOVER_MAX_STREAMS] = { NULL };
-	int i, ret;
+	int i;
 	uint32_t num_sinks;
 	uint32_t num_assigned_sinks = 0;
 	uint32_t frames = UINT_MAX;
 	uint32_t source_bytes, avail;
-	uint32_t flags = 0;
 	uint32_t sinks_bytes[SOF_CROSSOVER_MAX_STREAMS] = { 0 };
 
 	comp_dbg(dev, "crossover_copy()");
@@ -645,58 +746,59 @@ static int crossover_copy(struct comp_dev *dev)
 	source = list_first_item(&dev->bsource_list, struct comp_buffer,
 				 sink_list);
 
-	/* Check for changed configuration */
-	if (cd->config_new) {
-		crossover_free_config(&cd->config);
-		cd->config = cd->config_new;
-		cd->config_new = NULL;
-		ret = crossover_setup(cd, source->stream.channels);
-		if (ret < 0) {
-			comp_err(dev, "crossover_copy(), setup failed");
-			return -EINVAL;
-		}
+	/* Switch to filters prepared in IPC context once the previous fade
+	 * has ended. The outputs can be faded only if the previous filters
+	 * split to as many sinks.
+	 */
+	if (cd->set_new && !xfade_active(&cd->xfade)) {
+		cd->set_done = cd->set_old;
+		cd->set_old = cd->set;
+		cd->set = cd->set_new;
+		cd->set_new = NULL;
+		if (cd->set_old &&
+		    cd->set_old->config->num_sinks == cd->set->config->num_sinks)
+			xfade_start(&cd->xfade, cd->xfade_frames);
+		else
+			xfade_start(&cd->xfade, 0);
 	}
 
+	config = cd->set ? cd->set->config : NULL;
+
 	/* Use the assign_sink array from the config to route
 	 * the output to the corresponding sinks.
 	 * It is possible for an assigned sink to be in a different
 	 * state than the component. Therefore not all sinks are guaranteed
 	 * to be assigned: sink[i] can be NULL, 0 <= i <= config->num_sinks
 	 */
-	num_assigned_sinks = crossover_assign_sinks(dev, cd->config, sinks);
-	if (cd->config && num_assigned_sinks != cd->config->num_sinks)
+	num_assigned_sinks = crossover_assign_sinks(dev, config, sinks);
+	if (config && num_assigned_sinks != config->num_sinks)
 		comp_dbg(dev, "crossover_copy(), number of assigned sinks (%i) does not match number of sinks in config (%i).",
-			 num_assigned_sinks, cd->config->num_sinks);
+			 num_assigned_sinks, config->num_sinks);
 
 	/* If no config is set then assign the number of sinks to the number
 	 * of sinks that were assigned.
 	 */
-	if (cd->config)
-		num_sinks = cd->config->num_sinks;
+	if (config)
+		num_sinks = config->num_sinks;
 	else
 		num_sinks = num_assigned_sinks;
 
-	buffer_lock(source, &flags);
+	buffer_state_invalidate(source);
 
 	/* Check if source is active */
-	if (source->source->state != dev->state) {
-		buffer_unlock(source, flags);
+	if (source->source->state != dev->state)
 		return -EINVAL;
-	}
 
 	/* Find the number of frames to copy over */
 	for (i = 0; i < num_sinks; i++) {
 		if (!sinks[i])
 			continue;
-		buffer_lock(sinks[i], &flags);
+		buffer_state_invalidate(sinks[i]);
 		avail = audio_stream_avail_frames(&source->stream,
 						  &sinks[i]->stream);
 		frames = MIN(frames, avail);
-		buffer_unlock(sinks[i], flags);
 	}
 
-	buffer_unlock(source, flags);
-
 	source_bytes = frames * audio_stream_frame_bytes(&source->stream);
 
 	for (i = 0; i < num_sinks; i++) {
@@ -708,7 +810,12 @@ static int crossover_copy(struct comp_dev *dev)
 
 	/* Process crossover */
 	buffer_invalidate(source, source_bytes);
-	cd->crossover_process(dev, source, sinks, num_sinks, frames);
+	if (cd->set)
+		cd->crossover_process(dev, source, sinks, num_sinks, frames);
+	else
+		cd->crossover_pass(dev, source, sinks, num_sinks, frames);
+
+	xfade_advance(&cd->xfade, frames);
 
 	for (i = 0; i < num_sinks; i++) {
 		if (!sinks[i])
@@ -784,15 +891,18 @@ static int crossover_prepare(struct comp_dev *dev)
 		crossover_free_config(&cd->config);
 	}
 
-	if (cd->config) {
-		ret = crossover_setup(cd, source->stream.channels);
-		if (ret < 0) {
-			comp_err(dev, "crossover_prepare(), setup failed");
-			goto err;
-		}
+	cd->xfade_frames = xfade_frames(source->stream.rate);
+	cd->crossover_process = crossover_find_proc_func(cd->source_format);
+	cd->crossover_pass = crossover_find_proc_func_pass(cd->source_format);
+	if (!cd->crossover_pass) {
+		comp_err(dev, "crossover_prepare(), No passthrough function matching frame_fmt %i",
+			 cd->source_format);
+		ret = -EINVAL;
+		goto err;
+	}
 
-		cd->crossover_process =
-			crossover_find_proc_func(cd->source_format);
+	crossover_free_sets(cd);
+	if (cd->config) {
 		if (!cd->crossover_process) {
 			comp_err(dev, "crossover_prepare(), No processing function matching frame_fmt %i",
 				 cd->source_format);
@@ -800,26 +910,14 @@ static int crossover_prepare(struct comp_dev *dev)
 			goto err;
 		}
 
-		cd->crossover_split =
-			crossover_find_split_func(cd->config->num_sinks);
-		if (!cd->crossover_split) {
-			comp_err(dev, "crossover_prepare(), No split function matching num_sinks %i",
-				 cd->config->num_sinks);
-			ret = -EINVAL;
+		ret = crossover_setup(cd->config, source->stream.channels,
+				      &cd->set);
+		if (ret < 0) {
+			comp_err(dev, "crossover_prepare(), setup failed");
 			goto err;
 		}
 	} else {
 		comp_info(dev, "crossover_prepare(), setting crossover to passthrough mode");
-
-		cd->crossover_process =
-			crossover_find_proc_func_pass(cd->source_format);
-
-		if (!cd->crossover_process) {
-			comp_err(dev, "crossover_prepare(), No passthrough function matching frame_fmt %i",
-				 cd->source_format);
-			ret = -EINVAL;
-			goto err;
-		}
 	}
 
 	return 0;
@@ -840,7 +938,7 @@ static int crossover_reset(struct comp_dev *dev)
 
 	comp_info(dev, "crossover_reset()");
 
-	crossover_reset_state(cd);
+	crossover_free_sets(cd);
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 
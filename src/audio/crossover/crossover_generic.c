@@ -10,27 +10,29 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/crossover/crossover.h>
+#include <sof/math/numbers.h>
 
 /*
- * \brief Splits x into two based on the coefficients set in the lp
- *        and hp filters. The output of the lp is in y1, the output of
- *        the hp is in y2.
+ * \brief Splits a block of x into two based on the coefficients set in the
+ *        lp and hp filters. The output of the lp is in y1, the output of
+ *        the hp is in y2. The input may point to the same memory as y2.
  *
  * As a side effect, this function mutates the delay values of both
  * filters.
  */
 static inline void crossover_generic_lr4_split(struct iir_state_df2t *lp,
 					       struct iir_state_df2t *hp,
-					       int32_t x, int32_t *y1,
-					       int32_t *y2)
+					       const int32_t *x, int32_t *y1,
+					       int32_t *y2, int samples)
 {
-	*y1 = crossover_generic_process_lr4(x, lp);
-	*y2 = crossover_generic_process_lr4(x, hp);
+	crossover_generic_process_lr4(x, y1, samples, lp);
+	crossover_generic_process_lr4(x, y2, samples, hp);
 }
 
 /*
- * \brief Splits input signal into two and merges it back to it's
- *        original form.
+ * \brief Splits a block of input signal into two and merges it back to it's
+ *        original form. The output y may point to the same memory as x,
+ *        tmp is work memory for samples.
  *
  * With 3-way crossovers, one output goes through only one LR4 filter,
  * whereas the other two go through two LR4 filters. This causes the signals
@@ -39,50 +41,53 @@ static inline void crossover_generic_lr4_split(struct iir_state_df2t *lp,
  */
 static inline void crossover_generic_lr4_merge(struct iir_state_df2t *lp,
 					       struct iir_state_df2t *hp,
-					       int32_t x, int32_t *y)
+					       const int32_t *x, int32_t *y,
+					       int32_t *tmp, int samples)
 {
-	int32_t z1, z2;
+	int i;
 
-	z1 = crossover_generic_process_lr4(x, lp);
-	z2 = crossover_generic_process_lr4(x, hp);
-	*y = sat_int32(((int64_t)z1) + z2);
+	crossover_generic_process_lr4(x, tmp, samples, lp);
+	crossover_generic_process_lr4(x, y, samples, hp);
+	for (i = 0; i < samples; i++)
+		y[i] = sat_int32(((int64_t)tmp[i]) + y[i]);
 }
 
-static void crossover_generic_split_2way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_2way(const int32_t *in,
+					 int32_t out[][CROSSOVER_BLOCK_FRAMES],
+					 struct crossover_state *state,
+					 int samples)
 {
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &out[0], &out[1]);
+				    in, out[0], out[1], samples);
 }
 
-static void crossover_generic_split_3way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_3way(const int32_t *in,
+					 int32_t out[][CROSSOVER_BLOCK_FRAMES],
+					 struct crossover_state *state,
+					 int samples)
 {
-	int32_t z1, z2;
-
+	/* The intermediate signals z1 and z2 are in out[0] and out[2] */
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &z1, &z2);
+				    in, out[0], out[2], samples);
 	/* Realign the phase of z1 */
 	crossover_generic_lr4_merge(&state->lowpass[1], &state->highpass[1],
-				    z1, &out[0]);
+				    out[0], out[0], out[1], samples);
 	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[1], &out[2]);
+				    out[2], out[1], out[2], samples);
 }
 
-static void crossover_generic_split_4way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_4way(const int32_t *in,
+					 int32_t out[][CROSSOVER_BLOCK_FRAMES],
+					 struct crossover_state *state,
+					 int samples)
 {
-	int32_t z1, z2;
-
+	/* The intermediate signals z1 and z2 are in out[1] and out[3] */
 	crossover_generic_lr4_split(&state->lowpass[1], &state->highpass[1],
-				    in, &z1, &z2);
+				    in, out[1], out[3], samples);
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    z1, &out[0], &out[1]);
+				    out[1], out[0], out[1], samples);
 	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[2], &out[3]);
+				    out[3], out[2], out[3], samples);
 }
 
 #if CONFIG_FORMAT_S16LE
@@ -142,32 +147,40 @@ static void crossover_s16_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
 	const struct audio_stream *source_stream = &source->stream;
 	struct audio_stream *sink_stream;
+	int32_t in[CROSSOVER_BLOCK_FRAMES];
+	int32_t out[CROSSOVER_4WAY_NUM_SINKS][CROSSOVER_BLOCK_FRAMES];
 	int16_t *x, *y;
-	int ch, i, j;
-	int idx = 0;
+	int ch, i, j, k;
+	int idx;
+	int n;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
 
+	/* Each channel is split in blocks of CROSSOVER_BLOCK_FRAMES */
 	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source_stream, idx);
-			cd->crossover_split(*x << 16, out, state);
+		for (k = 0; k < frames; k += n) {
+			n = MIN(frames - k, CROSSOVER_BLOCK_FRAMES);
+			idx = k * nch + ch;
+			for (i = 0; i < n; i++) {
+				x = audio_stream_read_frag_s16(source_stream, idx);
+				in[i] = *x << 16;
+				idx += nch;
+			}
+
+			crossover_split_block(cd, ch, in, out, k, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s16(sink_stream,
-							       idx);
-				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
+				idx = k * nch + ch;
+				for (i = 0; i < n; i++) {
+					y = audio_stream_write_frag_s16(sink_stream, idx);
+					*y = sat_int16(Q_SHIFT_RND(out[j][i], 31, 15));
+					idx += nch;
+				}
 			}
-
-			idx += nch;
 		}
 	}
 }
@@ -181,32 +194,40 @@ static void crossover_s24_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
 	const struct audio_stream *source_stream = &source->stream;
 	struct audio_stream *sink_stream;
+	int32_t in[CROSSOVER_BLOCK_FRAMES];
+	int32_t out[CROSSOVER_4WAY_NUM_SINKS][CROSSOVER_BLOCK_FRAMES];
 	int32_t *x, *y;
-	int ch, i, j;
-	int idx = 0;
+	int ch, i, j, k;
+	int idx;
+	int n;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
 
+	/* Each channel is split in blocks of CROSSOVER_BLOCK_FRAMES */
 	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x << 8, out, state);
+		for (k = 0; k < frames; k += n) {
+			n = MIN(frames - k, CROSSOVER_BLOCK_FRAMES);
+			idx = k * nch + ch;
+			for (i = 0; i < n; i++) {
+				x = audio_stream_read_frag_s32(source_stream, idx);
+				in[i] = *x << 8;
+				idx += nch;
+			}
+
+			crossover_split_block(cd, ch, in, out, k, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
-				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
+				idx = k * nch + ch;
+				for (i = 0; i < n; i++) {
+					y = audio_stream_write_frag_s32(sink_stream, idx);
+					*y = sat_int24(Q_SHIFT_RND(out[j][i], 31, 23));
+					idx += nch;
+				}
 			}
-
-			idx += nch;
 		}
 	}
 }
@@ -220,32 +241,40 @@ static void crossover_s32_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
 	const struct audio_stream *source_stream = &source->stream;
 	struct audio_stream *sink_stream;
+	int32_t in[CROSSOVER_BLOCK_FRAMES];
+	int32_t out[CROSSOVER_4WAY_NUM_SINKS][CROSSOVER_BLOCK_FRAMES];
 	int32_t *x, *y;
-	int ch, i, j;
-	int idx = 0;
+	int ch, i, j, k;
+	int idx;
+	int n;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
 
+	/* Each channel is split in blocks of CROSSOVER_BLOCK_FRAMES */
 	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[0];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x, out, state);
+		for (k = 0; k < frames; k += n) {
+			n = MIN(frames - k, CROSSOVER_BLOCK_FRAMES);
+			idx = k * nch + ch;
+			for (i = 0; i < n; i++) {
+				x = audio_stream_read_frag_s32(source_stream, idx);
+				in[i] = *x;
+				idx += nch;
+			}
+
+			crossover_split_block(cd, ch, in, out, k, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
-				*y = out[j];
+				idx = k * nch + ch;
+				for (i = 0; i < n; i++) {
+					y = audio_stream_write_frag_s32(sink_stream, idx);
+					*y = out[j][i];
+					idx += nch;
+				}
 			}
-
-			idx += nch;
 		}
 	}
 }
@@ -331,7 +331,10 @@ static int dai_playback_params(struct comp_dev *dev, uint32_t period_bytes,
 	int err;
 
 	/* set processing function */
-	dd->process = pcm_get_conversion_function(local_fmt, dma_fmt);
+	if (audio_stream_is_planar(&dd->local_buffer->stream))
+		dd->process = pcm_convert_planar;
+	else
+		dd->process = pcm_get_conversion_function(local_fmt, dma_fmt);
 
 	/* set up DMA configuration */
 	config->direction = DMA_DIR_MEM_TO_DEV;
@@ -381,7 +384,10 @@ static int dai_capture_params(struct comp_dev *dev, uint32_t period_bytes,
 	int err;
 
 	/* set processing function */
-	dd->process = pcm_get_conversion_function(dma_fmt, local_fmt);
+	if (audio_stream_is_planar(&dd->local_buffer->stream))
+		dd->process = pcm_convert_planar;
+	else
+		dd->process = pcm_get_conversion_function(dma_fmt, local_fmt);
 
 	/* set up DMA configuration */
 	config->direction = DMA_DIR_DEV_TO_MEM;
@@ -800,7 +806,6 @@ static int dai_copy(struct comp_dev *dev)
 	uint32_t sink_samples;
 	uint32_t samples;
 	int ret = 0;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "dai_copy()");
 
@@ -811,7 +816,7 @@ static int dai_copy(struct comp_dev *dev)
 		return ret;
 	}
 
-	buffer_lock(buf, &flags);
+	buffer_state_invalidate(buf);
 
 	/* calculate minimum size to copy */
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
@@ -829,9 +834,11 @@ static int dai_copy(struct comp_dev *dev)
 		samples = MIN(samples, dd->period_bytes /
 			      get_sample_bytes(dma_fmt));
 	}
-	copy_bytes = samples * get_sample_bytes(dma_fmt);
 
-	buffer_unlock(buf, flags);
+	/* planar buffer pointers move by whole frames only */
+	if (audio_stream_is_planar(&buf->stream))
+		samples = ALIGN_DOWN(samples, buf->stream.channels);
+	copy_bytes = samples * get_sample_bytes(dma_fmt);
 
 	comp_dbg(dev, "dai_copy(), dir: %d copy_bytes= 0x%x, frames= %d",
 		 dev->direction, copy_bytes,
@@ -1052,6 +1059,7 @@ static const struct comp_driver comp_dai = {
 	.type	= SOF_COMP_DAI,
 	.uid	= SOF_RT_UUID(dai_comp_uuid),
 	.tctx	= &dai_comp_tr,
+	.caps	= COMP_CAPS_PLANAR,
 	.ops	= {
 		.create			= dai_new,
 		.free			= dai_free,
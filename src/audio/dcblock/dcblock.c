@@ -397,6 +397,7 @@ static const struct comp_driver comp_dcblock = {
 	.type = SOF_COMP_DCBLOCK,
 	.uid  = SOF_RT_UUID(dcblock_uuid),
 	.tctx = &dcblock_tr,
+	.caps = COMP_CAPS_PLANAR,
 	.ops  = {
 		 .create	= dcblock_new,
 		 .free		= dcblock_free,
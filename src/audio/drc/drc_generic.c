@@ -8,9 +8,414 @@
 #include <sof/audio/drc/drc.h>
 #include <sof/audio/drc/drc_math.h>
 #include <sof/audio/format.h>
+#include <sof/math/decibels.h>
+#include <sof/math/log.h>
 #include <sof/math/numbers.h>
 #include <stdint.h>
 
+#if CONFIG_COMP_DRC_FIXED_POINT
+
+#define DRC_ONE_Q30		Q_CONVERT_FLOAT(1.0, 30)
+#define DRC_ONE_Q24		Q_CONVERT_FLOAT(1.0, 24)
+#define DRC_HALF_Q24		Q_CONVERT_FLOAT(0.5, 24)
+#define DRC_TWELVE_Q24		Q_CONVERT_FLOAT(12.0, 24)
+#define DRC_NEG_TWO_DB_Q30	Q_CONVERT_FLOAT(0.7943282347242815, 30)
+#define DRC_LIN2DB_Q28		Q_CONVERT_FLOAT(6.020599913279624, 28) /* 20 * log10(2) */
+#define DRC_KNEE_EXP_MIN_Q27	Q_CONVERT_FLOAT(-11.5, 27)
+#define DRC_DB2LIN_Q30		Q_CONVERT_FLOAT(0.1660964047443681, 30) /* log2(10) / 20 */
+
+/* Q2.30 x Q2.30 -> Q2.30 */
+static inline int32_t drc_mult_q30(int32_t a, int32_t b)
+{
+	return (int32_t)Q_MULTSR_32X32((int64_t)a, b, 30, 30, 30);
+}
+
+/* Linear value Q2.30 to decibels Q8.24. The result saturates to -128 dB
+ * for very small values.
+ */
+static int32_t drc_lin2db_fixed(int32_t linear)
+{
+	int64_t log2x;
+
+	if (linear <= 0)
+		return INT32_MIN;
+
+	/* 20 * log10(x) = 20 * log10(2) * log2(x) */
+	log2x = (int64_t)log2_fixed(linear) - (30LL << LOG2_FIXED_OUTPUT_QY);
+	return sat_int32(Q_MULTSR_32X32(log2x, DRC_LIN2DB_Q28, 26, 28, 24));
+}
+
+/* Decibels Q8.24 to linear value Q2.30 */
+static int32_t drc_db2lin_fixed(int32_t db)
+{
+	int64_t arg;
+
+	/* 10^(x / 20) = 2^(x * log2(10) / 20) */
+	arg = Q_MULTSR_32X32((int64_t)db, DRC_DB2LIN_Q30, 24, 30, 26);
+	if (arg >= (1 << EXP2_FIXED_INPUT_QY))
+		return INT32_MAX;
+
+	if (arg < INT32_MIN)
+		return 0;
+
+	return exp2_fixed((int32_t)arg);
+}
+
+/* Square root of Q2.30 x, output is Q2.30 */
+static int32_t drc_sqrt_fixed(int32_t x)
+{
+	uint64_t v = (uint64_t)x << 30;
+	uint64_t bit = 1ULL << 62;
+	uint64_t r = 0;
+
+	while (bit > v)
+		bit >>= 2;
+
+	while (bit) {
+		if (v >= r + bit) {
+			v -= r + bit;
+			r = (r >> 1) + bit;
+		} else {
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (int32_t)r;
+}
+
+/* The inverse of warp_sin(), asin(x) * 2 / pi for Q2.30 x in 0 .. 1.0. The
+ * approximation asin(x) = pi / 2 - sqrt(1 - x) * poly(x) has max. error of
+ * 2e-8 (Abramowitz & Stegun 4.4.46). The coefficients are scaled by 2 / pi.
+ */
+static int32_t drc_asin_fixed(int32_t x)
+{
+	static const int32_t coef[8] = {
+		Q_CONVERT_FLOAT(0.9999999970, 30),
+		Q_CONVERT_FLOAT(-0.1366185883, 30),
+		Q_CONVERT_FLOAT(0.0566453043, 30),
+		Q_CONVERT_FLOAT(-0.0319419935, 30),
+		Q_CONVERT_FLOAT(0.0196665034, 30),
+		Q_CONVERT_FLOAT(-0.0108786820, 30),
+		Q_CONVERT_FLOAT(0.0042463279, 30),
+		Q_CONVERT_FLOAT(-0.0008037286, 30),
+	};
+	int32_t p;
+	int i;
+
+	/* The approximation is not exactly zero at zero. Zero desired gain
+	 * must stay zero for the gremlin case in drc_update_envelope().
+	 */
+	if (x <= 0)
+		return 0;
+
+	x = MIN(x, DRC_ONE_Q30);
+	p = coef[7];
+	for (i = 6; i >= 0; i--)
+		p = drc_mult_q30(p, x) + coef[i];
+
+	return DRC_ONE_Q30 - drc_mult_q30(drc_sqrt_fixed(DRC_ONE_Q30 - x), p);
+}
+
+/* This is the knee part of the compression curve. Returns the output level
+ * Q8.24 given the input level x Q2.30.
+ */
+static int32_t knee_curveK(const struct sof_drc_params *p, int32_t x)
+{
+	int32_t gamma;
+
+	/* The formula in knee_curveK is linear_threshold +
+	 * (1 - expf(-k * (x - linear_threshold))) / k
+	 * which simplifies to (alpha + beta * expf(gamma))
+	 * where alpha = linear_threshold + 1 / k
+	 *	 beta = -expf(k * linear_threshold) / k
+	 *	 gamma = -k * x
+	 * The exponent is Q5.27. Below the exp_fixed() range the
+	 * exponent is zero like in knee_expf().
+	 */
+	gamma = sat_int32(-Q_MULTSR_32X32((int64_t)p->K, x, 20, 30, 27));
+	if (gamma < DRC_KNEE_EXP_MIN_Q27)
+		return p->knee_alpha;
+
+	return p->knee_alpha +
+		(int32_t)Q_MULTSR_32X32((int64_t)p->knee_beta,
+					exp_fixed(gamma), 24, 20, 24);
+}
+
+/* Full compression curve with constant ratio after knee. Returns the ratio of
+ * output and input signal Q2.30 for input level x Q2.30.
+ */
+static int32_t volume_gain(const struct sof_drc_params *p, int32_t x)
+{
+	const int32_t knee_threshold =
+		sat_int32(Q_SHIFT_LEFT((int64_t)p->knee_threshold, 24, 30));
+	int64_t log2x;
+	int64_t t;
+
+	if (x < knee_threshold) {
+		if (x <= 0 || x < p->linear_threshold)
+			return DRC_ONE_Q30;
+
+		/* Q8.24 / Q2.30 -> Q2.30 */
+		return sat_int32(((int64_t)knee_curveK(p, x) << 36) / x);
+	}
+
+	/* Constant ratio after knee, see the floating point version:
+	 * y/x = ratio_base * x^(s - 1)
+	 *     = 2^(log2(ratio_base) + log2(x) * (s - 1))
+	 */
+	log2x = (int64_t)log2_fixed(x) - (30LL << LOG2_FIXED_OUTPUT_QY);
+	t = (int64_t)log2_fixed(p->ratio_base) -
+		(30LL << LOG2_FIXED_OUTPUT_QY);
+	t += Q_MULTSR_32X32(log2x, (int64_t)p->slope - DRC_ONE_Q30, 26, 30, 26);
+	if (t >= (1 << EXP2_FIXED_INPUT_QY))
+		return INT32_MAX;
+
+	if (t < INT32_MIN)
+		return 0;
+
+	return exp2_fixed((int32_t)t);
+}
+
+/* Update detector_average from the last input division. The pre-delay buffers
+ * contain s16 samples when nbyte is 2, otherwise Q1.31 samples.
+ */
+static void drc_update_detector_average(struct drc_state *state,
+					const struct sof_drc_params *p,
+					int nbyte, int nch)
+{
+	int32_t abs_input_array[DRC_DIVISION_FRAMES]; /* Q2.30 */
+	int32_t detector_average = state->detector_average; /* Q2.30 */
+	int32_t sample; /* Q2.30 */
+	int32_t gain; /* Q2.30 */
+	int32_t db_per_frame; /* Q8.24 */
+	int32_t sat_release_rate; /* Q2.30 */
+	int16_t *sample16_p;
+	int32_t *sample32_p;
+	int div_start, i, ch;
+
+	/* Calculate the start index of the last input division */
+	if (state->pre_delay_write_index == 0)
+		div_start = DRC_MAX_PRE_DELAY_FRAMES - DRC_DIVISION_FRAMES;
+	else
+		div_start = state->pre_delay_write_index - DRC_DIVISION_FRAMES;
+
+	/* The max abs value across all channels for this frame */
+	for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
+		abs_input_array[i] = 0;
+		for (ch = 0; ch < nch; ch++) {
+			if (nbyte == 2) {
+				sample16_p = (int16_t *)state->pre_delay_buffers[ch] +
+					     div_start + i;
+				sample = ABS((int32_t)*sample16_p) << 15;
+			} else {
+				sample32_p = (int32_t *)state->pre_delay_buffers[ch] +
+					     div_start + i;
+				sample = ABS((int64_t)*sample32_p) >> 1;
+			}
+			abs_input_array[i] = MAX(abs_input_array[i], sample);
+		}
+	}
+
+	for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
+		/* Compute compression amount from un-delayed signal */
+		gain = volume_gain(p, abs_input_array[i]);
+		if (gain > detector_average) {
+			if (gain > DRC_NEG_TWO_DB_Q30) {
+				detector_average +=
+					drc_mult_q30(gain - detector_average,
+						     p->sat_release_rate_at_neg_two_db);
+			} else {
+				db_per_frame = (int32_t)Q_MULTSR_32X32(
+					(int64_t)drc_lin2db_fixed(gain),
+					p->sat_release_frames_inv_neg, 24, 30, 24);
+				sat_release_rate =
+					drc_db2lin_fixed(db_per_frame) - DRC_ONE_Q30;
+				detector_average +=
+					drc_mult_q30(gain - detector_average,
+						     sat_release_rate);
+			}
+		} else {
+			detector_average = gain;
+		}
+
+		detector_average = MIN(detector_average, DRC_ONE_Q30);
+	}
+
+	state->detector_average = detector_average;
+}
+
+/* Updates the envelope_rate used for the next division */
+static void drc_update_envelope(struct drc_state *state, const struct sof_drc_params *p)
+{
+	/* Pre-warp so we get desired_gain after sin() warp below. */
+	int32_t scaled_desired_gain = drc_asin_fixed(state->detector_average);
+	int32_t compressor_gain = state->compressor_gain;
+	int32_t compression_diff_db; /* Q8.24 */
+	int32_t eff_atten_diff_db; /* Q8.24 */
+	int32_t envelope_rate; /* Q2.30 */
+	int64_t release_frames; /* Q20.12 */
+	int64_t db_per_frame; /* Q8.24 */
+	int64_t x;
+	int is_releasing = scaled_desired_gain > compressor_gain;
+
+	/* compression_diff_db is the difference between current compression
+	 * level and the desired level. The division of gains is a difference
+	 * in decibels. Zero desired gain is the gremlin case of the floating
+	 * point version.
+	 */
+	if (scaled_desired_gain > 0)
+		compression_diff_db =
+			sat_int32((int64_t)drc_lin2db_fixed(compressor_gain) -
+				  drc_lin2db_fixed(scaled_desired_gain));
+	else
+		compression_diff_db = is_releasing ? -DRC_ONE_Q24 : DRC_ONE_Q24;
+
+	if (is_releasing) {
+		/* Release mode - compression_diff_db should be negative dB */
+		state->max_attack_compression_diff_db = INT32_MIN;
+
+		/* Adaptive release - higher compression (lower
+		 * compression_diff_db) releases faster. Contain within range:
+		 * -12 -> 0 then scale to go from 0 -> 3
+		 */
+		x = compression_diff_db;
+		x = MAX(-DRC_TWELVE_Q24, x);
+		x = MIN(0, x);
+		x = (x + DRC_TWELVE_Q24) >> 2;
+
+		/* Compute adaptive release curve using 4th order polynomial.
+		 * Normal values for the polynomial coefficients would create a
+		 * monotonically increasing function.
+		 */
+		release_frames = p->kE;
+		release_frames = Q_MULTSR_32X32(release_frames, x, 12, 24, 12) + p->kD;
+		release_frames = Q_MULTSR_32X32(release_frames, x, 12, 24, 12) + p->kC;
+		release_frames = Q_MULTSR_32X32(release_frames, x, 12, 24, 12) + p->kB;
+		release_frames = Q_MULTSR_32X32(release_frames, x, 12, 24, 12) + p->kA;
+		release_frames = MAX(release_frames, 1);
+
+		db_per_frame = ((int64_t)p->kSpacingDb << 36) / release_frames;
+		envelope_rate = drc_db2lin_fixed(sat_int32(db_per_frame));
+	} else {
+		/* Attack mode - compression_diff_db should be positive dB */
+
+		/* As long as we're still in attack mode, use a rate based off
+		 * the largest compression_diff_db we've encountered so far.
+		 */
+		state->max_attack_compression_diff_db =
+			MAX(state->max_attack_compression_diff_db,
+			    compression_diff_db);
+
+		eff_atten_diff_db = MAX(DRC_HALF_Q24,
+					state->max_attack_compression_diff_db);
+
+		/* envelope_rate = 1 - x^(1 / attack_frames) with
+		 * x = 0.25 / eff_atten_diff_db, Q2.30 x and exponent.
+		 */
+		x = ((int64_t)1 << 52) / eff_atten_diff_db;
+		envelope_rate = DRC_ONE_Q30 -
+			pow_fixed((int32_t)x,
+				  sat_int32(((int64_t)1 << 50) /
+					    MAX(p->attack_frames, 1)));
+	}
+
+	state->envelope_rate = envelope_rate;
+	state->scaled_desired_gain = scaled_desired_gain;
+}
+
+/* Apply Q8.24 gain to the frame at index idx of the pre-delay buffers */
+static inline void drc_apply_gain(struct drc_state *state, int idx,
+				  int32_t gain, int nbyte, int nch)
+{
+	int16_t *sample16_p;
+	int32_t *sample32_p;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		if (nbyte == 2) {
+			sample16_p = (int16_t *)state->pre_delay_buffers[ch] + idx;
+			*sample16_p = sat_int16(Q_MULTSR_32X32((int64_t)*sample16_p,
+							       gain, 15, 24, 15));
+		} else {
+			sample32_p = (int32_t *)state->pre_delay_buffers[ch] + idx;
+			*sample32_p = sat_int32(Q_MULTSR_32X32((int64_t)*sample32_p,
+							       gain, 31, 24, 31));
+		}
+	}
+}
+
+/* Calculate compress_gain from the envelope and apply total_gain to compress
+ * the next output division.
+ */
+static void drc_compress_output(struct drc_state *state,
+				const struct sof_drc_params *p,
+				int nbyte, int nch)
+{
+	const int32_t envelope_rate = state->envelope_rate;
+	const int32_t scaled_desired_gain = state->scaled_desired_gain;
+	const int32_t compressor_gain = state->compressor_gain;
+	const int div_start = state->pre_delay_read_index;
+	int count = DRC_DIVISION_FRAMES / 4;
+	int64_t x[4]; /* Q2.30 */
+	int64_t c, base, r, r2, r4;
+	int32_t post_warp_compressor_gain; /* Q2.30 */
+	int32_t total_gain; /* Q8.24 */
+	int i, j, inc;
+
+	/* Exponential approach to desired gain. */
+	if (envelope_rate < DRC_ONE_Q30) {
+		/* Attack - reduce gain to desired. */
+		c = compressor_gain - scaled_desired_gain;
+		base = scaled_desired_gain;
+		r = DRC_ONE_Q30 - envelope_rate;
+	} else {
+		/* Release - exponentially increase gain to 1.0 */
+		c = compressor_gain;
+		base = 0;
+		r = envelope_rate;
+	}
+
+	x[0] = Q_MULTSR_32X32(c, r, 30, 30, 30);
+	for (j = 1; j < 4; j++)
+		x[j] = Q_MULTSR_32X32(x[j - 1], r, 30, 30, 30);
+	r2 = Q_MULTSR_32X32(r, r, 30, 30, 30);
+	r4 = Q_MULTSR_32X32(r2, r2, 30, 30, 30);
+
+	i = 0;
+	inc = 0;
+	while (1) {
+		for (j = 0; j < 4; j++) {
+			/* Warp pre-compression gain to smooth out sharp
+			 * exponential transition points.
+			 */
+			post_warp_compressor_gain = drc_sin_fixed(sat_int32(x[j] + base));
+
+			/* Calculate total gain using master gain. */
+			total_gain = (int32_t)Q_MULTSR_32X32((int64_t)p->master_linear_gain,
+							     post_warp_compressor_gain,
+							     24, 30, 24);
+
+			/* Apply final gain. */
+			drc_apply_gain(state, div_start + inc, total_gain, nbyte, nch);
+			inc++;
+		}
+
+		if (++i == count)
+			break;
+
+		for (j = 0; j < 4; j++) {
+			x[j] = Q_MULTSR_32X32(x[j], r4, 30, 30, 30);
+			if (envelope_rate >= DRC_ONE_Q30)
+				x[j] = MIN(DRC_ONE_Q30, x[j]);
+		}
+	}
+
+	state->compressor_gain = sat_int32(x[3] + base);
+}
+
+#else /* CONFIG_COMP_DRC_FIXED_POINT */
+
 /* This is the knee part of the compression curve. Returns the output level
  * given the input level x. */
 static float knee_curveK(const struct sof_drc_params *p, float x)
@@ -58,15 +463,20 @@ static float volume_gain(const struct sof_drc_params *p, float x)
 	return y;
 }
 
-/* Update detector_average from the last input division. */
-static void drc_update_detector_average(struct drc_state *state, const struct sof_drc_params *p, int nch)
+/* Update detector_average from the last input division. The pre-delay buffers
+ * contain s16 samples when nbyte is 2, otherwise Q1.31 samples.
+ */
+static void drc_update_detector_average(struct drc_state *state,
+					const struct sof_drc_params *p,
+					int nbyte, int nch)
 {
 	float abs_input_array[DRC_DIVISION_FRAMES];
 	const float sat_release_frames_inv_neg = Q_CONVERT_QTOF(p->sat_release_frames_inv_neg, 30);
 	const float sat_release_rate_at_neg_two_db = Q_CONVERT_QTOF(p->sat_release_rate_at_neg_two_db, 30);
 	float detector_average = Q_CONVERT_QTOF(state->detector_average, 30);
 	int div_start, i, ch;
-	int16_t *sample_p; /* only support s16 case for now */
+	int16_t *sample16_p;
+	int32_t *sample32_p;
 	float sample;
 	float gain;
 	int is_release;
@@ -84,8 +494,15 @@ static void drc_update_detector_average(struct drc_state *state, const struct so
 	for (i = 0; i < DRC_DIVISION_FRAMES; i++) {
 		abs_input_array[i] = 0.0f;
 		for (ch = 0; ch < nch; ch++) {
-			sample_p = (int16_t *)state->pre_delay_buffers[ch] + div_start + i;
-			sample = Q_CONVERT_QTOF((int32_t)*sample_p, 15);
+			if (nbyte == 2) {
+				sample16_p = (int16_t *)state->pre_delay_buffers[ch] +
+					     div_start + i;
+				sample = Q_CONVERT_QTOF((int32_t)*sample16_p, 15);
+			} else {
+				sample32_p = (int32_t *)state->pre_delay_buffers[ch] +
+					     div_start + i;
+				sample = Q_CONVERT_QTOF(*sample32_p, 31);
+			}
 			abs_input_array[i] = MAX(abs_input_array[i], ABS(sample));
 		}
 	}
@@ -233,9 +650,46 @@ static int16_t drc_float2s16(float f)
 	return (int16_t)i;
 }
 
+/* Convert an audio sample from floating point format to Q1.31 format and
+ * saturate to [-1.0, 1.0).
+ */
+static int32_t drc_float2s32(float f)
+{
+	f *= 2147483648.0f;
+	if (f >= 2147483648.0f)
+		return INT32_MAX;
+	if (f <= -2147483648.0f)
+		return INT32_MIN;
+	return (int32_t)((f > 0) ? (f + 0.5f) : (f - 0.5f));
+}
+
+/* Apply gain to the frame at index idx of the pre-delay buffers */
+static inline void drc_apply_gain(struct drc_state *state, int idx, float gain,
+				  int nbyte, int nch)
+{
+	int16_t *sample16_p;
+	int32_t *sample32_p;
+	float sample;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		if (nbyte == 2) {
+			sample16_p = (int16_t *)state->pre_delay_buffers[ch] + idx;
+			sample = Q_CONVERT_QTOF((int32_t)*sample16_p, 15);
+			*sample16_p = drc_float2s16(sample * gain);
+		} else {
+			sample32_p = (int32_t *)state->pre_delay_buffers[ch] + idx;
+			sample = Q_CONVERT_QTOF(*sample32_p, 31);
+			*sample32_p = drc_float2s32(sample * gain);
+		}
+	}
+}
+
 /* Calculate compress_gain from the envelope and apply total_gain to compress
  * the next output division. */
-static void drc_compress_output(struct drc_state *state, const struct sof_drc_params *p, int nch)
+static void drc_compress_output(struct drc_state *state,
+				const struct sof_drc_params *p,
+				int nbyte, int nch)
 {
 	const float master_linear_gain = Q_CONVERT_QTOF(p->master_linear_gain, 24);
 	const float envelope_rate = Q_CONVERT_QTOF(state->envelope_rate, 30);
@@ -249,9 +703,7 @@ static void drc_compress_output(struct drc_state *state, const struct sof_drc_pa
 	float post_warp_compressor_gain;
 	float total_gain;
 
-	int i, j, ch, inc;
-	int16_t *sample_p; /* only support s16 case for now */
-	float sample;
+	int i, j, inc;
 
 	/* Exponential approach to desired gain. */
 	if (envelope_rate < 1) {
@@ -277,11 +729,8 @@ static void drc_compress_output(struct drc_state *state, const struct sof_drc_pa
 				total_gain = master_linear_gain * post_warp_compressor_gain;
 
 				/* Apply final gain. */
-				for (ch = 0; ch < nch; ch++) {
-					sample_p = (int16_t *)state->pre_delay_buffers[ch] + div_start + inc;
-					sample = Q_CONVERT_QTOF((int32_t)*sample_p, 15);
-					*sample_p = drc_float2s16(sample * total_gain);
-				}
+				drc_apply_gain(state, div_start + inc, total_gain,
+					       nbyte, nch);
 				inc++;
 			}
 
@@ -315,11 +764,8 @@ static void drc_compress_output(struct drc_state *state, const struct sof_drc_pa
 				total_gain = master_linear_gain * post_warp_compressor_gain;
 
 				/* Apply final gain. */
-				for (ch = 0; ch < nch; ch++) {
-					sample_p = (int16_t *)state->pre_delay_buffers[ch] + div_start + inc;
-					sample = Q_CONVERT_QTOF((int32_t)*sample_p, 15);
-					*sample_p = drc_float2s16(sample * total_gain);
-				}
+				drc_apply_gain(state, div_start + inc, total_gain,
+					       nbyte, nch);
 				inc++;
 			}
 
@@ -334,17 +780,21 @@ static void drc_compress_output(struct drc_state *state, const struct sof_drc_pa
 	}
 }
 
+#endif /* CONFIG_COMP_DRC_FIXED_POINT */
+
 /* After one complete divison of samples have been received (and one divison of
  * samples have been output), we calculate shaped power average
  * (detector_average) from the input division, update envelope parameters from
  * detector_average, then prepare the next output division by applying the
  * envelope to compress the samples.
  */
-static void drc_process_one_division(struct drc_state *state, const struct sof_drc_params *p, int nch)
+static void drc_process_one_division(struct drc_state *state,
+				     const struct sof_drc_params *p,
+				     int nbyte, int nch)
 {
-	drc_update_detector_average(state, p, nch);
+	drc_update_detector_average(state, p, nbyte, nch);
 	drc_update_envelope(state, p);
-	drc_compress_output(state, p, nch);
+	drc_compress_output(state, p, nbyte, nch);
 }
 
 #if CONFIG_FORMAT_S16LE
@@ -360,22 +810,50 @@ static void drc_s16_default_pass(const struct comp_dev *dev,
 
 	for (i = 0; i < n; i++) {
 		x = audio_stream_read_frag_s16(source, i);
-		y = audio_stream_read_frag_s16(sink, i);
+		y = audio_stream_write_frag_s16(sink, i);
 		*y = *x;
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
-#if CONFIG_FORMAT_S16LE
-static void drc_s16_default(const struct comp_dev *dev,
-			    const struct audio_stream *source,
-			    struct audio_stream *sink,
-			    uint32_t frames)
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+static void drc_s32_default_pass(const struct comp_dev *dev,
+				 const struct audio_stream *source,
+				 struct audio_stream *sink,
+				 uint32_t frames)
 {
-	int16_t *x;
-	int16_t *y;
-	int16_t *pd_write;
-	int16_t *pd_read;
+	int32_t *x;
+	int32_t *y;
+	int i;
+	int n = source->channels * frames;
+
+	for (i = 0; i < n; i++) {
+		x = audio_stream_read_frag_s32(source, i);
+		y = audio_stream_write_frag_s32(sink, i);
+		*y = *x;
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+/* Stores one source sample to the pre-delay buffer and writes the delayed
+ * sample from the pre-delay buffer to sink.
+ */
+typedef void (*drc_sample_move)(const struct audio_stream *source,
+				struct audio_stream *sink, int idx,
+				int8_t *pd_write, const int8_t *pd_read);
+
+/* The shared part of the format specific processing functions. It is always
+ * inlined with a constant move function, so there is no indirect call per
+ * sample. The pre-delay buffers hold nbyte sized samples.
+ */
+static inline void drc_default(const struct comp_dev *dev,
+			       const struct audio_stream *source,
+			       struct audio_stream *sink,
+			       uint32_t frames, int nbyte,
+			       drc_sample_move move)
+{
+	int8_t *pd_write;
+	int8_t *pd_read;
 	int offset;
 	int i = 0;
 	int ch;
@@ -397,25 +875,22 @@ static void drc_s16_default(const struct comp_dev *dev,
 		for (ch = 0; ch < nch; ++ch) {
 			pd_write_index = state->pre_delay_write_index;
 			pd_read_index = state->pre_delay_read_index;
-			pd_write = (int16_t *)state->pre_delay_buffers[ch] + pd_write_index;
-			pd_read = (int16_t *)state->pre_delay_buffers[ch] + pd_read_index;
+			pd_write = state->pre_delay_buffers[ch] + pd_write_index * nbyte;
+			pd_read = state->pre_delay_buffers[ch] + pd_read_index * nbyte;
 			idx = ch;
 			for (i = 0; i < frames; ++i) {
-				x = audio_stream_read_frag_s16(source, idx);
-				y = audio_stream_read_frag_s16(sink, idx);
-				*pd_write = *x;
-				*y = *pd_read;
+				move(source, sink, idx, pd_write, pd_read);
 				if (++pd_write_index == DRC_MAX_PRE_DELAY_FRAMES) {
 					pd_write_index = 0;
-					pd_write = (int16_t *)state->pre_delay_buffers[ch];
+					pd_write = state->pre_delay_buffers[ch];
 				} else {
-					pd_write++;
+					pd_write += nbyte;
 				}
 				if (++pd_read_index == DRC_MAX_PRE_DELAY_FRAMES) {
 					pd_read_index = 0;
-					pd_read = (int16_t *)state->pre_delay_buffers[ch];
+					pd_read = state->pre_delay_buffers[ch];
 				} else {
-					pd_read++;
+					pd_read += nbyte;
 				}
 				idx += nch;
 			}
@@ -430,7 +905,7 @@ static void drc_s16_default(const struct comp_dev *dev,
 
 	if (!state->processed) {
 		drc_update_envelope(state, p);
-		drc_compress_output(state, p, nch);
+		drc_compress_output(state, p, nbyte, nch);
 		state->processed = 1;
 	}
 
@@ -442,16 +917,13 @@ static void drc_s16_default(const struct comp_dev *dev,
 		pd_write_index = state->pre_delay_write_index;
 		pd_read_index = state->pre_delay_read_index;
 		for (ch = 0; ch < nch; ++ch) {
-			pd_write = (int16_t *)state->pre_delay_buffers[ch] + pd_write_index;
-			pd_read = (int16_t *)state->pre_delay_buffers[ch] + pd_read_index;
+			pd_write = state->pre_delay_buffers[ch] + pd_write_index * nbyte;
+			pd_read = state->pre_delay_buffers[ch] + pd_read_index * nbyte;
 			idx = i * nch + ch;
 			for (f = 0; f < fragment; ++f) {
-				x = audio_stream_read_frag_s16(source, idx);
-				y = audio_stream_read_frag_s16(sink, idx);
-				*pd_write = *x;
-				*y = *pd_read;
-				pd_write++;
-				pd_read++;
+				move(source, sink, idx, pd_write, pd_read);
+				pd_write += nbyte;
+				pd_read += nbyte;
 				idx += nch;
 			}
 		}
@@ -463,11 +935,74 @@ static void drc_s16_default(const struct comp_dev *dev,
 
 		/* Process the input division (32 frames). */
 		if (offset == 0)
-			drc_process_one_division(state, p, nch);
+			drc_process_one_division(state, p, nbyte, nch);
 	}
 }
+
+#if CONFIG_FORMAT_S16LE
+static inline void drc_move_s16(const struct audio_stream *source,
+				struct audio_stream *sink, int idx,
+				int8_t *pd_write, const int8_t *pd_read)
+{
+	int16_t *x = audio_stream_read_frag_s16(source, idx);
+	int16_t *y = audio_stream_write_frag_s16(sink, idx);
+
+	*(int16_t *)pd_write = *x;
+	*y = *(const int16_t *)pd_read;
+}
+
+static void drc_s16_default(const struct comp_dev *dev,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink,
+			    uint32_t frames)
+{
+	drc_default(dev, source, sink, frames, sizeof(int16_t), drc_move_s16);
+}
 #endif /* CONFIG_FORMAT_S16LE */
 
+#if CONFIG_FORMAT_S24LE
+/* The S24_4LE samples are stored as Q1.31 to pre-delay buffers */
+static inline void drc_move_s24(const struct audio_stream *source,
+				struct audio_stream *sink, int idx,
+				int8_t *pd_write, const int8_t *pd_read)
+{
+	int32_t *x = audio_stream_read_frag_s32(source, idx);
+	int32_t *y = audio_stream_write_frag_s32(sink, idx);
+
+	*(int32_t *)pd_write = *x << 8;
+	*y = sat_int24(Q_SHIFT_RND(*(const int32_t *)pd_read, 31, 23));
+}
+
+static void drc_s24_default(const struct comp_dev *dev,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink,
+			    uint32_t frames)
+{
+	drc_default(dev, source, sink, frames, sizeof(int32_t), drc_move_s24);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static inline void drc_move_s32(const struct audio_stream *source,
+				struct audio_stream *sink, int idx,
+				int8_t *pd_write, const int8_t *pd_read)
+{
+	int32_t *x = audio_stream_read_frag_s32(source, idx);
+	int32_t *y = audio_stream_write_frag_s32(sink, idx);
+
+	*(int32_t *)pd_write = *x;
+	*y = *(const int32_t *)pd_read;
+}
+
+static void drc_s32_default(const struct comp_dev *dev,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink,
+			    uint32_t frames)
+{
+	drc_default(dev, source, sink, frames, sizeof(int32_t), drc_move_s32);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
 const struct drc_proc_fnmap drc_proc_fnmap[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -475,11 +1010,11 @@ const struct drc_proc_fnmap drc_proc_fnmap[] = {
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-	//{ SOF_IPC_FRAME_S24_4LE, drc_s24_default },
+	{ SOF_IPC_FRAME_S24_4LE, drc_s24_default },
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-	//{ SOF_IPC_FRAME_S32_LE, drc_s32_default },
+	{ SOF_IPC_FRAME_S32_LE, drc_s32_default },
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
@@ -490,11 +1025,11 @@ const struct drc_proc_fnmap drc_proc_fnmap_pass[] = {
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-	//{ SOF_IPC_FRAME_S24_4LE, drc_s32_default_pass },
+	{ SOF_IPC_FRAME_S24_4LE, drc_s32_default_pass },
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-	//{ SOF_IPC_FRAME_S32_LE, drc_s32_default_pass },
+	{ SOF_IPC_FRAME_S32_LE, drc_s32_default_pass },
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
@@ -8,16 +8,21 @@
 
 #include <sof/audio/eq_fir/eq_fir.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/coef_store.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
+#include <sof/audio/xfade.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
+#include <sof/math/fft.h>
 #include <sof/math/fir_config.h>
+#include <sof/math/fir_fft.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/ut.h>
@@ -30,6 +35,7 @@
 #include <user/fir.h>
 #include <user/trace.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -41,19 +47,49 @@ DECLARE_SOF_RT_UUID("eq-fir", eq_fir_uuid, 0x43a90ce7, 0xf3a5, 0x41df,
 
 DECLARE_TR_CTX(eq_fir_tr, SOF_UUID(eq_fir_uuid), LOG_LEVEL_INFO);
 
+/* In automatic mode a response is computed with partitioned FFT convolution
+ * if direct form is not possible or if the FFT convolution is estimated to
+ * need less than 1/EQ_FIR_FFT_MIN_GAIN of the direct form multiplications.
+ * The FFT convolution delays the output so it is not used for marginal gain.
+ * If any response needs it, all channels are computed with FFT convolution.
+ */
+#define EQ_FIR_FFT_MIN_GAIN	4
+
+/* Filters prepared from one configuration blob. The sets are allocated and
+ * freed in IPC context, copy() only switches to a prepared set.
+ */
+struct eq_fir_set {
+	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct fir_fft_state fir_fft[PLATFORM_MAX_CHANNELS]; /**< FFT filters */
+	struct fir_fft_coef *fir_fft_coef[PLATFORM_MAX_CHANNELS]; /**< shared */
+	struct sof_fir_coef_data *fir_fft_resp[PLATFORM_MAX_CHANNELS];
+	struct fir_fft_coef fir_fft_bypass;	/**< delay for bypass channels */
+	struct fft_plan *fft_plan;		/**< FFT for FFT filters, shared */
+	struct sof_eq_fir_config *config;	/**< referenced blob */
+	int32_t *fir_delay;			/**< pointer to allocated RAM */
+	void *fir_fft_data;			/**< FFT filters RAM */
+	bool fft;				/**< all channels use FFT */
+};
+
 /* src component private data */
 struct comp_data {
-	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct eq_fir_set *set;			/**< filters in use */
+	struct eq_fir_set *set_new;		/**< filters for copy() to use */
+	struct eq_fir_set *set_old;		/**< filters faded out */
+	struct eq_fir_set *set_done;		/**< faded out, for IPC to free */
+	struct xfade xfade;			/**< fade from set_old to set */
+	uint32_t xfade_frames;			/**< fade length */
 	struct comp_data_blob_handler *model_handler;
-	struct sof_eq_fir_config *config;
 	enum sof_ipc_frame source_format;	/**< source frame format */
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
-	int32_t *fir_delay;			/**< pointer to allocated RAM */
-	size_t fir_delay_size;			/**< allocated size */
 	void (*eq_fir_func)(struct fir_state_32x16 fir[],
 			    const struct audio_stream *source,
 			    struct audio_stream *sink,
 			    int frames, int nch);
+	void (*eq_fir_fft_func)(struct fir_fft_state fir[],
+				const struct audio_stream *source,
+				struct audio_stream *sink,
+				int frames, int nch);
 };
 
 /*
@@ -116,18 +152,21 @@ static inline int set_fir_func(struct comp_dev *dev)
 	case SOF_IPC_FRAME_S16_LE:
 		comp_info(dev, "set_fir_func(), SOF_IPC_FRAME_S16_LE");
 		set_s16_fir(cd);
+		cd->eq_fir_fft_func = eq_fir_fft_s16;
 		break;
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
 	case SOF_IPC_FRAME_S24_4LE:
 		comp_info(dev, "set_fir_func(), SOF_IPC_FRAME_S24_4LE");
 		set_s24_fir(cd);
+		cd->eq_fir_fft_func = eq_fir_fft_s24;
 		break;
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
 	case SOF_IPC_FRAME_S32_LE:
 		comp_info(dev, "set_fir_func(), SOF_IPC_FRAME_S32_LE");
 		set_s32_fir(cd);
+		cd->eq_fir_fft_func = eq_fir_fft_s32;
 		break;
 #endif /* CONFIG_FORMAT_S32LE */
 	default:
@@ -149,29 +188,83 @@ static void eq_fir_passthrough(struct fir_state_32x16 fir[],
 	audio_stream_copy(source, 0, sink, 0, frames * nch);
 }
 
-static void eq_fir_free_delaylines(struct comp_data *cd)
+static void eq_fir_free_set(struct eq_fir_set *set)
 {
-	struct fir_state_32x16 *fir = cd->fir;
-	int i = 0;
+	int i;
 
-	/* Free the common buffer for all EQs and point then
-	 * each FIR channel delay line to NULL.
-	 */
-	rfree(cd->fir_delay);
-	cd->fir_delay = NULL;
-	cd->fir_delay_size = 0;
+	if (!set)
+		return;
+
+	rfree(set->fir_delay);
+	rfree(set->fir_fft_data);
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		fir[i].delay = NULL;
+		coef_store_put(set->fir_fft_coef[i]);
+
+	coef_store_put(set->fft_plan);
+	coef_store_put(set->config);
+	rfree(set);
+}
+
+static void eq_fir_free_sets(struct comp_data *cd)
+{
+	eq_fir_free_set(cd->set);
+	eq_fir_free_set(cd->set_new);
+	eq_fir_free_set(cd->set_old);
+	eq_fir_free_set(cd->set_done);
+	cd->set = NULL;
+	cd->set_new = NULL;
+	cd->set_old = NULL;
+	cd->set_done = NULL;
+	xfade_start(&cd->xfade, 0);
+}
+
+/* Hands new filters over to a running copy(). An update copy() has not
+ * switched to yet is replaced by them, so only the latest one is applied.
+ */
+static void eq_fir_set_pending(struct comp_data *cd, struct eq_fir_set *set)
+{
+	struct eq_fir_set *superseded;
+	struct eq_fir_set *done;
+	uint32_t flags;
+
+	irq_local_disable(flags);
+	superseded = cd->set_new;
+	done = cd->set_done;
+	cd->set_new = set;
+	cd->set_done = NULL;
+	irq_local_enable(flags);
+
+	eq_fir_free_set(superseded);
+	eq_fir_free_set(done);
 }
 
-static int eq_fir_init_coef(struct sof_eq_fir_config *config,
-			    struct fir_state_32x16 *fir, int nch)
+static bool eq_fir_use_fft(struct sof_fir_coef_data *eq, int block)
+{
+	switch (eq->mode) {
+	case SOF_FIR_MODE_TIME:
+		return false;
+	case SOF_FIR_MODE_FFT:
+		return true;
+	default:
+		return eq->length > SOF_FIR_MAX_LENGTH ||
+			eq->length > EQ_FIR_FFT_MIN_GAIN *
+			fir_fft_cost(eq->length, block);
+	}
+}
+
+static int eq_fir_init_coef(struct eq_fir_set *set, int nch, int block)
 {
 	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
+	struct sof_fir_coef_data *ch_resp[PLATFORM_MAX_CHANNELS];
+	struct sof_eq_fir_config *config = set->config;
+	struct fir_state_32x16 *fir = set->fir;
 	struct sof_fir_coef_data *eq;
 	int16_t *assign_response;
 	int16_t *coef_data;
 	size_t size_sum = 0;
+	bool need_fft = false;
+	bool need_time = false;
+	bool use_fft = false;
 	int resp = 0;
 	int i;
 	int j;
@@ -208,7 +301,7 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 		}
 	}
 
-	/* Initialize 1st phase */
+	/* Find the response of each channel, NULL for bypass */
 	for (i = 0; i < nch; i++) {
 		/* Check for not reading past blob response to channel assign
 		 * map. The previous channel response is assigned for any
@@ -220,6 +313,48 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 			resp = assign_response[i];
 
 		if (resp < 0) {
+			ch_resp[i] = NULL;
+			continue;
+		}
+
+		if (resp >= config->number_of_responses) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), requested response %d exceeds what has been defined",
+				    resp);
+			return -EINVAL;
+		}
+
+		eq = lookup[resp];
+		if (eq->mode > SOF_FIR_MODE_FFT) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), invalid mode %u for response %d",
+				    eq->mode, resp);
+			return -EINVAL;
+		}
+
+		ch_resp[i] = eq;
+		if (eq->mode == SOF_FIR_MODE_FFT ||
+		    eq->length > SOF_FIR_MAX_LENGTH)
+			need_fft = true;
+		if (eq->mode == SOF_FIR_MODE_TIME)
+			need_time = true;
+		if (eq_fir_use_fft(eq, block))
+			use_fft = true;
+	}
+
+	/* The FFT filters delay the output by the partition length, so all
+	 * channels are filtered in the same mode to keep them aligned.
+	 */
+	if (need_fft && need_time) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), direct form responses can't be used with FFT");
+		return -EINVAL;
+	}
+
+	use_fft = use_fft && !need_time;
+	set->fft = use_fft;
+
+	/* Initialize 1st phase */
+	for (i = 0; i < nch; i++) {
+		eq = ch_resp[i];
+		if (!eq) {
 			/* Initialize EQ channel to bypass and continue with
 			 * next channel response.
 			 */
@@ -229,14 +364,17 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 			continue;
 		}
 
-		if (resp >= config->number_of_responses) {
-			comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), requested response %d exceeds what has been defined",
-				    resp);
-			return -EINVAL;
+		/* The FFT filters are set up after the direct form delay
+		 * lines.
+		 */
+		if (use_fft) {
+			comp_cl_info(&comp_eq_fir, "eq_fir_init_coef(), ch %d is set to FFT filter",
+				     i);
+			fir_reset(&fir[i]);
+			set->fir_fft_resp[i] = eq;
+			continue;
 		}
 
-		/* Initialize EQ coefficients. */
-		eq = lookup[resp];
 		s = fir_delay_size(eq);
 		if (s > 0) {
 			size_sum += s;
@@ -255,8 +393,8 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 #endif
 
 		fir_init_coef(&fir[i], eq);
-		comp_cl_info(&comp_eq_fir, "eq_fir_init_coef(), ch %d is set to response = %d",
-			     i, resp);
+		comp_cl_info(&comp_eq_fir, "eq_fir_init_coef(), ch %d is set to direct form filter",
+			     i);
 	}
 
 	return size_sum;
@@ -275,37 +413,226 @@ static void eq_fir_init_delay(struct fir_state_32x16 *fir,
 	}
 }
 
-static int eq_fir_setup(struct comp_data *cd, int nch)
+/* Context for computing the shared FFT tables */
+struct eq_fir_fft_ctx {
+	struct sof_fir_coef_data *eq;
+	struct fft_plan *plan;
+	struct icomplex32 *buf;
+	int block;
+};
+
+static void eq_fir_init_fft_plan(void *data, void *ctx)
+{
+	struct eq_fir_fft_ctx *c = ctx;
+	struct fft_plan *plan = data;
+	void *tables = plan + 1;
+
+	fft_plan_init(plan, 2 * c->block, &tables);
+}
+
+static void eq_fir_init_fft_coef(void *data, void *ctx)
+{
+	struct eq_fir_fft_ctx *c = ctx;
+	struct fir_fft_coef *coef = data;
+	void *h = coef + 1;
+
+	fir_fft_init_coef(coef, c->eq, c->block, c->plan, c->buf, &h);
+}
+
+static int eq_fir_setup_fft(struct eq_fir_set *set, int nch, int block)
+{
+	struct eq_fir_fft_ctx ctx;
+	struct sof_fir_coef_data *eq;
+	struct fir_fft_coef *coef;
+	struct icomplex32 *buf;
+	void *data;
+	size_t size;
+	int fft_size = 2 * block;
+	int s;
+	int i;
+	int j;
+
+	/* The FFT work buffer is shared by all channels. The FFT tables and
+	 * the response spectra are kept in the coefficient store and shared
+	 * with other instances that use the same blob.
+	 */
+	size = fft_size * sizeof(struct icomplex32);
+	for (i = 0; i < nch; i++) {
+		eq = set->fir_fft_resp[i];
+		if (!eq) {
+			size += fir_fft_bypass_delay_size(block);
+			continue;
+		}
+
+		s = fir_fft_delay_size(eq, block);
+		if (s < 0) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_setup_fft(), FIR length %d is invalid",
+				    eq->length);
+			return s;
+		}
+
+		size += s;
+	}
+
+	set->fir_fft_data = rballoc(0, SOF_MEM_CAPS_RAM, size);
+	if (!set->fir_fft_data) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_setup_fft(), allocation failed for size %u",
+			    size);
+		return -ENOMEM;
+	}
+
+	memset(set->fir_fft_data, 0, size);
+	buf = set->fir_fft_data;
+	data = buf + fft_size;
+
+	ctx.buf = buf;
+	ctx.block = block;
+	set->fft_plan = coef_store_derive(NULL, COEF_STORE_FFT_PLAN, fft_size,
+					 sizeof(struct fft_plan) +
+					 fft_plan_size(fft_size),
+					 eq_fir_init_fft_plan, &ctx);
+	if (!set->fft_plan) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_setup_fft(), FFT plan allocation failed");
+		return -ENOMEM;
+	}
+
+	ctx.plan = set->fft_plan;
+	fir_fft_init_bypass(&set->fir_fft_bypass, block);
+	for (i = 0; i < nch; i++) {
+		eq = set->fir_fft_resp[i];
+		if (!eq) {
+			fir_fft_init_delay(&set->fir_fft[i], &set->fir_fft_bypass,
+					   set->fft_plan, buf, &data);
+			continue;
+		}
+
+		for (j = 0; j < i; j++) {
+			if (set->fir_fft_resp[j] == eq)
+				break;
+		}
+
+		if (j == i) {
+			ctx.eq = eq;
+			set->fir_fft_coef[i] =
+				coef_store_derive(eq, COEF_STORE_FIR_FFT, block,
+						  sizeof(struct fir_fft_coef) +
+						  fir_fft_coef_size(eq, block),
+						  eq_fir_init_fft_coef, &ctx);
+			if (!set->fir_fft_coef[i]) {
+				comp_cl_err(&comp_eq_fir, "eq_fir_setup_fft(), spectra allocation failed");
+				return -ENOMEM;
+			}
+		}
+
+		coef = set->fir_fft_coef[j];
+		fir_fft_init_delay(&set->fir_fft[i], coef, set->fft_plan, buf,
+				   &data);
+	}
+
+	return 0;
+}
+
+static int eq_fir_setup(struct sof_eq_fir_config *config, int nch,
+			int frames, struct eq_fir_set **set_out)
 {
+	struct eq_fir_set *set;
+	int block = fir_fft_block_length(frames);
 	int delay_size;
+	int ret;
+	int i;
+
+	set = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*set));
+	if (!set)
+		return -ENOMEM;
 
-	/* Free existing FIR channels data if it was allocated */
-	eq_fir_free_delaylines(cd);
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		fir_reset(&set->fir[i]);
+		fir_fft_reset(&set->fir_fft[i]);
+	}
+
+	/* The blob is kept while the filters point to it */
+	set->config = coef_store_get(config);
+	if (!set->config) {
+		ret = -ENOMEM;
+		goto err;
+	}
 
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_fir_init_coef(cd->config, cd->fir, nch);
-	if (delay_size < 0)
-		return delay_size; /* Contains error code */
+	delay_size = eq_fir_init_coef(set, nch, block);
+	if (delay_size < 0) {
+		ret = delay_size; /* Contains error code */
+		goto err;
+	}
+
+	if (set->fft) {
+		ret = eq_fir_setup_fft(set, nch, block);
+		if (ret < 0)
+			goto err;
+	}
 
 	/* If all channels were set to bypass there's no need to
-	 * allocate delay. Just return with success.
+	 * allocate delay.
 	 */
-	if (!delay_size)
-		return 0;
-
-	/* Allocate all FIR channels data in a big chunk and clear it */
-	cd->fir_delay = rballoc(0, SOF_MEM_CAPS_RAM, delay_size);
-	if (!cd->fir_delay) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_setup(), delay allocation failed for size %d",
-			    delay_size);
-		return -ENOMEM;
+	if (delay_size) {
+		/* Allocate all FIR channels data in a big chunk and clear it */
+		set->fir_delay = rballoc(0, SOF_MEM_CAPS_RAM, delay_size);
+		if (!set->fir_delay) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_setup(), delay allocation failed for size %d",
+				    delay_size);
+			ret = -ENOMEM;
+			goto err;
+		}
+
+		memset(set->fir_delay, 0, delay_size);
+
+		/* Assign delay line to each channel EQ */
+		eq_fir_init_delay(set->fir, set->fir_delay, nch);
 	}
 
-	memset(cd->fir_delay, 0, delay_size);
-	cd->fir_delay_size = delay_size;
+	*set_out = set;
+	return 0;
+
+err:
+	eq_fir_free_set(set);
+	return ret;
+}
+
+/* Prepares filters for a new blob received while prepared or streaming. A
+ * running copy() switches to them and fades from the previous filters.
+ */
+static int eq_fir_update(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_eq_fir_config *config;
+	struct comp_buffer *sourceb;
+	struct eq_fir_set *set;
+	int ret;
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+
+	/* Pass-through is replaced by the FIR function for the format, a
+	 * missing set is processed with eq_fir_passthrough().
+	 */
+	ret = set_fir_func(dev);
+	if (ret < 0)
+		return ret;
+
+	config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	ret = eq_fir_setup(config, sourceb->stream.channels, dev->frames,
+			   &set);
+	if (ret < 0) {
+		comp_err(dev, "eq_fir_update(), failed FIR setup");
+		return ret;
+	}
+
+	if (dev->state == COMP_STATE_ACTIVE) {
+		eq_fir_set_pending(cd, set);
+	} else {
+		eq_fir_free_sets(cd);
+		cd->set = set;
+	}
 
-	/* Assign delay line to each channel EQ */
-	eq_fir_init_delay(cd->fir, cd->fir_delay, nch);
 	return 0;
 }
 
@@ -322,7 +649,6 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 	struct sof_ipc_comp_process *ipc_fir
 		= (struct sof_ipc_comp_process *)comp;
 	size_t bs = ipc_fir->size;
-	int i;
 	int ret;
 
 	comp_cl_info(&comp_eq_fir, "eq_fir_new()");
@@ -354,13 +680,12 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 
 	cd->eq_fir_func = NULL;
-	cd->fir_delay = NULL;
-	cd->fir_delay_size = 0;
+	cd->eq_fir_fft_func = NULL;
 
 	/* component model data handler */
-	cd->model_handler = comp_data_blob_handler_new(dev);
+	cd->model_handler = comp_data_blob_handler_new_shared(dev);
 	if (!cd->model_handler) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_new(): comp_data_blob_handler_new() failed.");
+		comp_cl_err(&comp_eq_fir, "eq_fir_new(): comp_data_blob_handler_new_shared() failed.");
 		rfree(dev);
 		rfree(cd);
 		return NULL;
@@ -377,9 +702,6 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 		return NULL;
 	}
 
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		fir_reset(&cd->fir[i]);
-
 	dev->state = COMP_STATE_READY;
 	return dev;
 }
@@ -390,7 +712,7 @@ static void eq_fir_free(struct comp_dev *dev)
 
 	comp_info(dev, "eq_fir_free()");
 
-	eq_fir_free_delaylines(cd);
+	eq_fir_free_sets(cd);
 	comp_data_blob_handler_free(cd->model_handler);
 
 	rfree(cd);
@@ -426,7 +748,17 @@ static int fir_cmd_set_data(struct comp_dev *dev,
 	switch (cdata->cmd) {
 	case SOF_CTRL_CMD_BINARY:
 		comp_info(dev, "fir_cmd_set_data(), SOF_CTRL_CMD_BINARY");
+
 		ret = comp_data_blob_set_cmd(cd->model_handler, cdata);
+		if (ret < 0)
+			break;
+
+		/* Filters for a prepared component are set up here, not in
+		 * copy()
+		 */
+		if (dev->state >= COMP_STATE_PREPARE &&
+		    comp_is_new_data_blob_available(cd->model_handler))
+			ret = eq_fir_update(dev);
 		break;
 	default:
 		comp_err(dev, "fir_cmd_set_data(): invalid cdata->cmd");
@@ -473,6 +805,27 @@ static int eq_fir_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+static void eq_fir_run(void *ctx, void *data,
+		       const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = ctx;
+	struct eq_fir_set *set = data;
+
+	if (!set) {
+		eq_fir_passthrough(NULL, source, sink, frames,
+				   source->channels);
+		return;
+	}
+
+	if (set->fft)
+		cd->eq_fir_fft_func(set->fir_fft, source, sink, frames,
+				    source->channels);
+	else
+		cd->eq_fir_func(set->fir, source, sink, frames,
+				source->channels);
+}
+
 static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 			   struct comp_buffer *sink, int frames,
 			   uint32_t source_bytes, uint32_t sink_bytes)
@@ -481,8 +834,14 @@ static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_invalidate(source, source_bytes);
 
-	cd->eq_fir_func(cd->fir, &source->stream, &sink->stream, frames,
-			source->stream.channels);
+	/* The FIR functions need an even number of frames */
+	if (xfade_active(&cd->xfade))
+		xfade_process(&cd->xfade, eq_fir_run, cd, cd->set_old,
+			      cd->set, &source->stream, &sink->stream,
+			      frames, 2);
+	else
+		eq_fir_run(cd, cd->set, &source->stream, &sink->stream,
+			   frames);
 
 	buffer_writeback(sink, sink_bytes);
 
@@ -498,7 +857,6 @@ static int eq_fir_copy(struct comp_dev *dev)
 	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int ret;
 	int n;
 
 	comp_dbg(dev, "eq_fir_copy()");
@@ -506,14 +864,15 @@ static int eq_fir_copy(struct comp_dev *dev)
 	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
 				  sink_list);
 
-	/* Check for changed configuration */
-	if (comp_is_new_data_blob_available(cd->model_handler)) {
-		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
-		ret = eq_fir_setup(cd, sourceb->stream.channels);
-		if (ret < 0) {
-			comp_err(dev, "eq_fir_copy(), failed FIR setup");
-			return ret;
-		}
+	/* Switch to filters prepared in IPC context once the previous fade
+	 * has ended. The previous ones are faded out and freed there.
+	 */
+	if (cd->set_new && !xfade_active(&cd->xfade)) {
+		cd->set_done = cd->set_old;
+		cd->set_old = cd->set;
+		cd->set = cd->set_new;
+		cd->set_new = NULL;
+		xfade_start(&cd->xfade, cd->xfade_frames);
 	}
 
 	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
@@ -546,6 +905,7 @@ static int eq_fir_prepare(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct sof_ipc_comp_config *config = dev_comp_config(dev);
+	struct sof_eq_fir_config *blob;
 	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
 	uint32_t sink_period_bytes;
@@ -581,10 +941,13 @@ static int eq_fir_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
-	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	blob = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	cd->xfade_frames = xfade_frames(sourceb->stream.rate);
 
-	if (cd->config) {
-		ret = eq_fir_setup(cd, sourceb->stream.channels);
+	eq_fir_free_sets(cd);
+	if (blob) {
+		ret = eq_fir_setup(blob, sourceb->stream.channels, dev->frames,
+				   &cd->set);
 		if (ret < 0) {
 			comp_err(dev, "eq_fir_prepare(): eq_fir_setup failed.");
 			goto err;
@@ -605,16 +968,14 @@ err:
 
 static int eq_fir_reset(struct comp_dev *dev)
 {
-	int i;
 	struct comp_data *cd = comp_get_drvdata(dev);
 
 	comp_info(dev, "eq_fir_reset()");
 
-	eq_fir_free_delaylines(cd);
+	eq_fir_free_sets(cd);
 
 	cd->eq_fir_func = NULL;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		fir_reset(&cd->fir[i]);
+	cd->eq_fir_fft_func = NULL;
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
@@ -624,6 +985,10 @@ static const struct comp_driver comp_eq_fir = {
 	.type = SOF_COMP_EQ_FIR,
 	.uid = SOF_RT_UUID(eq_fir_uuid),
 	.tctx = &eq_fir_tr,
+#if FIR_GENERIC
+	/* The HiFi FIR functions address the buffers as interleaved rings */
+	.caps = COMP_CAPS_PLANAR,
+#endif
 	.ops = {
 		.create = eq_fir_new,
 		.free = eq_fir_free,
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/eq_fir/eq_fir.h>
+#include <sof/audio/format.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/numbers.h>
+#include <stdint.h>
+
+/* Max. number of frames to convert to Q1.31 for a channel at a time. The
+ * channel is read from audio_stream_channel_ptr() on with the stride of the
+ * stream, so the source and the sink may be interleaved or planar.
+ */
+#define EQ_FIR_FFT_BLOCK_FRAMES	64
+
+#if CONFIG_FORMAT_S16LE
+void eq_fir_fft_s16(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	int32_t buf[EQ_FIR_FFT_BLOCK_FRAMES];
+	int16_t *x0 = source->r_ptr;
+	int16_t *y0 = sink->w_ptr;
+	int16_t *x;
+	int16_t *y;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
+	int ch;
+	int i;
+
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+		n = MIN(n, EQ_FIR_FFT_BLOCK_FRAMES);
+		for (ch = 0; ch < nch; ch++) {
+			if (!fir[ch].coef)
+				continue;
+
+			x = audio_stream_channel_ptr(source, x0, ch);
+			y = audio_stream_channel_ptr(sink, y0, ch);
+			for (i = 0; i < n; i++)
+				buf[i] = x[i * x_inc] << 16;
+
+			fir_fft_32(&fir[ch], buf, buf, n);
+
+			for (i = 0; i < n; i++)
+				y[i * y_inc] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_fft_s24(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	int32_t buf[EQ_FIR_FFT_BLOCK_FRAMES];
+	int32_t *x0 = source->r_ptr;
+	int32_t *y0 = sink->w_ptr;
+	int32_t *x;
+	int32_t *y;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
+	int ch;
+	int i;
+
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+		n = MIN(n, EQ_FIR_FFT_BLOCK_FRAMES);
+		for (ch = 0; ch < nch; ch++) {
+			if (!fir[ch].coef)
+				continue;
+
+			x = audio_stream_channel_ptr(source, x0, ch);
+			y = audio_stream_channel_ptr(sink, y0, ch);
+			for (i = 0; i < n; i++)
+				buf[i] = x[i * x_inc] << 8;
+
+			fir_fft_32(&fir[ch], buf, buf, n);
+
+			for (i = 0; i < n; i++)
+				y[i * y_inc] = sat_int24(Q_SHIFT_RND(buf[i], 31, 23));
+		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_fft_s32(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	int32_t buf[EQ_FIR_FFT_BLOCK_FRAMES];
+	int32_t *x0 = source->r_ptr;
+	int32_t *y0 = sink->w_ptr;
+	int32_t *x;
+	int32_t *y;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
+	int ch;
+	int i;
+
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+		n = MIN(n, EQ_FIR_FFT_BLOCK_FRAMES);
+		for (ch = 0; ch < nch; ch++) {
+			if (!fir[ch].coef)
+				continue;
+
+			x = audio_stream_channel_ptr(source, x0, ch);
+			y = audio_stream_channel_ptr(sink, y0, ch);
+			for (i = 0; i < n; i++)
+				buf[i] = x[i * x_inc];
+
+			fir_fft_32(&fir[ch], buf, buf, n);
+
+			for (i = 0; i < n; i++)
+				y[i * y_inc] = buf[i];
+		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
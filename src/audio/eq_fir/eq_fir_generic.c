@@ -12,32 +12,56 @@
 
 #include <sof/audio/eq_fir/eq_fir.h>
 #include <sof/math/fir_generic.h>
+#include <sof/math/numbers.h>
 #include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/* Size of work buffer for converting the samples of a channel to Q1.31
+ * for the block FIR.
+ */
+#define EQ_FIR_BLOCK_SAMPLES	64
+
+/* The channels are filtered one at a time from the sample at
+ * audio_stream_channel_ptr() on with the stride of the stream, so the
+ * source and the sink may be interleaved or planar.
+ */
+
 #if CONFIG_FORMAT_S16LE
 void eq_fir_s16(struct fir_state_32x16 fir[], const struct audio_stream *source,
 		struct audio_stream *sink, int frames, int nch)
 {
-	struct fir_state_32x16 *filter;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
+	int16_t *x0 = source->r_ptr;
+	int16_t *y0 = sink->w_ptr;
 	int16_t *x;
 	int16_t *y;
-	int32_t z;
-	int idx;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
 	int ch;
 	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = fir_32x16(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+		n = MIN(n, EQ_FIR_BLOCK_SAMPLES);
+		for (ch = 0; ch < nch; ch++) {
+			x = audio_stream_channel_ptr(source, x0, ch);
+			y = audio_stream_channel_ptr(sink, y0, ch);
+			for (i = 0; i < n; i++)
+				buf[i] = x[i * x_inc] << 16;
+
+			fir_32x16_block(&fir[ch], buf, buf, n, 1);
+
+			for (i = 0; i < n; i++)
+				y[i * y_inc] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
 		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -46,24 +70,37 @@ void eq_fir_s16(struct fir_state_32x16 fir[], const struct audio_stream *source,
 void eq_fir_s24(struct fir_state_32x16 fir[], const struct audio_stream *source,
 		struct audio_stream *sink, int frames, int nch)
 {
-	struct fir_state_32x16 *filter;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
+	int32_t *x0 = source->r_ptr;
+	int32_t *y0 = sink->w_ptr;
 	int32_t *x;
 	int32_t *y;
-	int32_t z;
-	int idx;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
 	int ch;
 	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = fir_32x16(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+		n = MIN(n, EQ_FIR_BLOCK_SAMPLES);
+		for (ch = 0; ch < nch; ch++) {
+			x = audio_stream_channel_ptr(source, x0, ch);
+			y = audio_stream_channel_ptr(sink, y0, ch);
+			for (i = 0; i < n; i++)
+				buf[i] = x[i * x_inc] << 8;
+
+			fir_32x16_block(&fir[ch], buf, buf, n, 1);
+
+			for (i = 0; i < n; i++)
+				y[i * y_inc] = sat_int24(Q_SHIFT_RND(buf[i], 31, 23));
 		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
@@ -72,22 +109,45 @@ void eq_fir_s24(struct fir_state_32x16 fir[], const struct audio_stream *source,
 void eq_fir_s32(struct fir_state_32x16 fir[], const struct audio_stream *source,
 		struct audio_stream *sink, int frames, int nch)
 {
-	struct fir_state_32x16 *filter;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
+	int32_t *x0 = source->r_ptr;
+	int32_t *y0 = sink->w_ptr;
 	int32_t *x;
 	int32_t *y;
-	int idx;
+	int x_inc = audio_stream_channel_stride(source);
+	int y_inc = audio_stream_channel_stride(sink);
+	int remaining_frames = frames;
+	int n;
 	int ch;
 	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			*y = fir_32x16(filter, *x);
-			idx += nch;
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x0, sink, y0,
+					     remaining_frames);
+
+		if (x_inc == nch && y_inc == nch) {
+			/* Interleaved Q1.31 samples are filtered directly
+			 * from source to sink.
+			 */
+			fir_32x16_block(fir, x0, y0, n, nch);
+		} else {
+			n = MIN(n, EQ_FIR_BLOCK_SAMPLES);
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_channel_ptr(source, x0, ch);
+				y = audio_stream_channel_ptr(sink, y0, ch);
+				for (i = 0; i < n; i++)
+					buf[i] = x[i * x_inc];
+
+				fir_32x16_block(&fir[ch], buf, buf, n, 1);
+
+				for (i = 0; i < n; i++)
+					y[i * y_inc] = buf[i];
+			}
 		}
+
+		remaining_frames -= n;
+		x0 = audio_stream_wrap(source, x0 + n * x_inc);
+		y0 = audio_stream_wrap(sink, y0 + n * y_inc);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
@@ -8,18 +8,22 @@
 
 #include <sof/audio/component.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/coef_store.h>
 #include <sof/audio/eq_iir/eq_iir.h>
 #include <sof/audio/eq_iir/iir.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/audio/xfade.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/ut.h>
@@ -41,176 +45,288 @@ DECLARE_SOF_RT_UUID("eq-iir", eq_iir_uuid, 0x5150c0e6, 0x27f9, 0x4ec8,
 
 DECLARE_TR_CTX(eq_iir_tr, SOF_UUID(eq_iir_uuid), LOG_LEVEL_INFO);
 
+/* Filters prepared from one configuration blob. The sets are allocated and
+ * freed in IPC context, copy() only switches to a prepared set.
+ */
+struct eq_iir_set {
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct sof_eq_iir_config *config;	/**< referenced blob */
+	int64_t *iir_delay;			/**< pointer to allocated RAM */
+	eq_iir_func func;			/**< processing function */
+};
+
 /* IIR component private data */
 struct comp_data {
-	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct eq_iir_set *set;			/**< filters in use */
+	struct eq_iir_set *set_new;		/**< filters for copy() to use */
+	struct eq_iir_set *set_old;		/**< filters faded out */
+	struct eq_iir_set *set_done;		/**< faded out, for IPC to free */
+	struct xfade xfade;			/**< fade from set_old to set */
+	uint32_t xfade_frames;			/**< fade length */
 	struct comp_data_blob_handler *model_handler;
-	struct sof_eq_iir_config *config;
 	enum sof_ipc_frame source_format;	/**< source frame format */
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
-	int64_t *iir_delay;			/**< pointer to allocated RAM */
-	size_t iir_delay_size;			/**< allocated size */
-	eq_iir_func eq_iir_func;		/**< processing function */
+	eq_iir_func eq_iir_func;		/**< pass-through function */
 };
 
+/* Size of work buffer for converting samples to Q1.31 for the block IIR */
+#define EQ_IIR_BLOCK_SAMPLES	64
+
 #if CONFIG_FORMAT_S16LE
 /*
  * EQ IIR algorithm code
  */
 
-static void eq_iir_s16_default(const struct comp_dev *dev,
+static void eq_iir_s16_default(struct iir_state_df2t iir[],
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
 			       uint32_t frames)
 
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int16_t *x;
-	int16_t *y;
-	int32_t z;
-	int ch;
-	int i;
-	int idx;
+	int32_t buf[EQ_IIR_BLOCK_SAMPLES];
+	int16_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
 	int nch = source->channels;
+	int max_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	int remaining_frames = frames;
+	int n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, max_frames);
+		for (i = 0; i < n * nch; i++)
+			buf[i] = x[i] << 16;
+
+		iir_df2t_block_nch(iir, buf, buf, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-static void eq_iir_s24_default(const struct comp_dev *dev,
+static void eq_iir_s24_default(struct iir_state_df2t iir[],
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
 			       uint32_t frames)
 
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
+	int32_t buf[EQ_IIR_BLOCK_SAMPLES];
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
 	int nch = source->channels;
+	int max_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	int remaining_frames = frames;
+	int n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
-		}
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, max_frames);
+		for (i = 0; i < n * nch; i++)
+			buf[i] = x[i] << 8;
+
+		iir_df2t_block_nch(iir, buf, buf, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(buf[i], 31, 23));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-static void eq_iir_s32_default(const struct comp_dev *dev,
+static void eq_iir_s32_default(struct iir_state_df2t iir[],
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
 			       uint32_t frames)
 
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int idx;
-	int ch;
-	int i;
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
 	int nch = source->channels;
-
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			*y = iir_df2t(filter, *x);
-			idx += nch;
-		}
+	int remaining_frames = frames;
+	int n;
+
+	/* The Q1.31 samples are filtered directly from source to sink */
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		iir_df2t_block_nch(iir, x, y, n, nch);
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE
-static void eq_iir_s32_16_default(const struct comp_dev *dev,
+static void eq_iir_s32_16_default(struct iir_state_df2t iir[],
 				  const struct audio_stream *source,
 				  struct audio_stream *sink,
 				  uint32_t frames)
 
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int16_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
+	int32_t buf[EQ_IIR_BLOCK_SAMPLES];
+	int32_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
 	int nch = source->channels;
+	int max_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	int remaining_frames = frames;
+	int n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, max_frames);
+		iir_df2t_block_nch(iir, x, buf, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE
-static void eq_iir_s32_24_default(const struct comp_dev *dev,
+static void eq_iir_s32_24_default(struct iir_state_df2t iir[],
 				  const struct audio_stream *source,
 				  struct audio_stream *sink,
 				  uint32_t frames)
 
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int nch = source->channels;
+	int remaining_frames = frames;
+	int n;
 	int i;
+
+	/* Filter to sink and then convert the Q1.31 output in-place */
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		iir_df2t_block_nch(iir, x, y, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(y[i], 31, 23));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
+
+/* Reads n samples of a channel with the stride of the stream as Q1.31 */
+static void eq_iir_load(const struct audio_stream *source, const void *ptr,
+			int32_t *buf, int n)
+{
+	const int16_t *x16 = ptr;
+	const int32_t *x32 = ptr;
+	int inc = audio_stream_channel_stride(source);
+	int i;
+
+	switch (source->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		for (i = 0; i < n; i++)
+			buf[i] = x16[i * inc] << 16;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		for (i = 0; i < n; i++)
+			buf[i] = x32[i * inc] << 8;
+		break;
+	default:
+		for (i = 0; i < n; i++)
+			buf[i] = x32[i * inc];
+		break;
+	}
+}
+
+/* Writes n Q1.31 samples of a channel with the stride of the stream */
+static void eq_iir_store(struct audio_stream *sink, void *ptr,
+			 const int32_t *buf, int n)
+{
+	int16_t *y16 = ptr;
+	int32_t *y32 = ptr;
+	int inc = audio_stream_channel_stride(sink);
+	int i;
+
+	switch (sink->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		for (i = 0; i < n; i++)
+			y16[i * inc] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		for (i = 0; i < n; i++)
+			y32[i * inc] = sat_int24(Q_SHIFT_RND(buf[i], 31, 23));
+		break;
+	default:
+		for (i = 0; i < n; i++)
+			y32[i * inc] = buf[i];
+		break;
+	}
+}
+
+/* Filters channel by channel when the source or the sink is planar. The
+ * functions above filter all channels of interleaved frames together,
+ * this one converts the samples of a channel from the sample at
+ * audio_stream_channel_ptr() on to a work buffer instead. Any supported
+ * pair of formats is handled, and the samples are only converted for
+ * pass-through with iir set to NULL.
+ */
+static void eq_iir_planar(struct iir_state_df2t iir[],
+			  const struct audio_stream *source,
+			  struct audio_stream *sink,
+			  uint32_t frames)
+{
+	int32_t buf[EQ_IIR_BLOCK_SAMPLES];
+	char *x = source->r_ptr;
+	char *y = sink->w_ptr;
+	int x_inc = audio_stream_channel_stride(source) *
+		audio_stream_sample_bytes(source);
+	int y_inc = audio_stream_channel_stride(sink) *
+		audio_stream_sample_bytes(sink);
 	int nch = source->channels;
+	int n;
+	int ch;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+	while (frames) {
+		n = audio_stream_span_frames(source, x, sink, y, frames);
+		n = MIN(n, EQ_IIR_BLOCK_SAMPLES);
+		for (ch = 0; ch < nch; ch++) {
+			eq_iir_load(source, audio_stream_channel_ptr(source, x, ch),
+				    buf, n);
+			if (iir)
+				iir_df2t_block(&iir[ch], buf, buf, n);
+
+			eq_iir_store(sink, audio_stream_channel_ptr(sink, y, ch),
+				     buf, n);
 		}
+
+		frames -= n;
+		x = audio_stream_wrap(source, x + n * x_inc);
+		y = audio_stream_wrap(sink, y + n * y_inc);
 	}
 }
-#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
 
-static void eq_iir_pass(const struct comp_dev *dev,
+static void eq_iir_pass(struct iir_state_df2t iir[],
 			const struct audio_stream *source,
 			struct audio_stream *sink,
 			uint32_t frames)
@@ -219,7 +335,7 @@ static void eq_iir_pass(const struct comp_dev *dev,
 }
 
 #if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
-static void eq_iir_s32_s16_pass(const struct comp_dev *dev,
+static void eq_iir_s32_s16_pass(struct iir_state_df2t iir[],
 				const struct audio_stream *source,
 				struct audio_stream *sink,
 				uint32_t frames)
@@ -238,7 +354,7 @@ static void eq_iir_s32_s16_pass(const struct comp_dev *dev,
 #endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
-static void eq_iir_s32_s24_pass(const struct comp_dev *dev,
+static void eq_iir_s32_s24_pass(struct iir_state_df2t iir[],
 				const struct audio_stream *source,
 				struct audio_stream *sink,
 				uint32_t frames)
@@ -250,7 +366,7 @@ static void eq_iir_s32_s24_pass(const struct comp_dev *dev,
 
 	for (i = 0; i < n; i++) {
 		x = audio_stream_read_frag_s32(source, i);
-		y = audio_stream_write_frag_s16(sink, i);
+		y = audio_stream_write_frag_s32(sink, i);
 		*y = sat_int24(Q_SHIFT_RND(*x, 31, 23));
 	}
 }
@@ -326,19 +442,47 @@ static eq_iir_func eq_iir_find_func(enum sof_ipc_frame source_format,
 	return NULL;
 }
 
-static void eq_iir_free_delaylines(struct comp_data *cd)
+static void eq_iir_free_set(struct eq_iir_set *set)
 {
-	struct iir_state_df2t *iir = cd->iir;
-	int i = 0;
+	if (!set)
+		return;
 
-	/* Free the common buffer for all EQs and point then
-	 * each IIR channel delay line to NULL.
-	 */
-	rfree(cd->iir_delay);
-	cd->iir_delay = NULL;
-	cd->iir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir[i].delay = NULL;
+	rfree(set->iir_delay);
+	coef_store_put(set->config);
+	rfree(set);
+}
+
+static void eq_iir_free_sets(struct comp_data *cd)
+{
+	eq_iir_free_set(cd->set);
+	eq_iir_free_set(cd->set_new);
+	eq_iir_free_set(cd->set_old);
+	eq_iir_free_set(cd->set_done);
+	cd->set = NULL;
+	cd->set_new = NULL;
+	cd->set_old = NULL;
+	cd->set_done = NULL;
+	xfade_start(&cd->xfade, 0);
+}
+
+/* Hands new filters over to a running copy(). An update copy() has not
+ * switched to yet is replaced by them, so only the latest one is applied.
+ */
+static void eq_iir_set_pending(struct comp_data *cd, struct eq_iir_set *set)
+{
+	struct eq_iir_set *superseded;
+	struct eq_iir_set *done;
+	uint32_t flags;
+
+	irq_local_disable(flags);
+	superseded = cd->set_new;
+	done = cd->set_done;
+	cd->set_new = set;
+	cd->set_done = NULL;
+	irq_local_enable(flags);
+
+	eq_iir_free_set(superseded);
+	eq_iir_free_set(done);
 }
 
 static int eq_iir_init_coef(struct sof_eq_iir_config *config,
@@ -447,37 +591,93 @@ static void eq_iir_init_delay(struct iir_state_df2t *iir,
 	}
 }
 
-static int eq_iir_setup(struct comp_data *cd, int nch)
+static int eq_iir_setup(struct comp_data *cd,
+			struct sof_eq_iir_config *config, int nch,
+			struct eq_iir_set **set_out)
 {
+	struct eq_iir_set *set;
 	int delay_size;
+	int ret;
 
-	/* Free existing IIR channels data if it was allocated */
-	eq_iir_free_delaylines(cd);
+	set = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*set));
+	if (!set)
+		return -ENOMEM;
+
+	set->func = eq_iir_find_func(cd->source_format, cd->sink_format,
+				     fm_configured, ARRAY_SIZE(fm_configured));
+	if (!set->func) {
+		comp_cl_err(&comp_eq_iir, "eq_iir_setup(), No proc func");
+		ret = -EINVAL;
+		goto err;
+	}
+
+	/* The blob is kept while the filters point to it */
+	set->config = coef_store_get(config);
+	if (!set->config) {
+		ret = -ENOMEM;
+		goto err;
+	}
 
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_iir_init_coef(cd->config, cd->iir, nch);
-	if (delay_size < 0)
-		return delay_size; /* Contains error code */
+	delay_size = eq_iir_init_coef(config, set->iir, nch);
+	if (delay_size < 0) {
+		ret = delay_size; /* Contains error code */
+		goto err;
+	}
 
 	/* If all channels were set to bypass there's no need to
-	 * allocate delay. Just return with success.
+	 * allocate delay.
 	 */
-	if (!delay_size)
-		return 0;
-
-	/* Allocate all IIR channels data in a big chunk and clear it */
-	cd->iir_delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-				delay_size);
-	if (!cd->iir_delay) {
-		comp_cl_err(&comp_eq_iir, "eq_iir_setup(), delay allocation fail");
-		return -ENOMEM;
+	if (delay_size) {
+		/* Allocate all IIR channels data in a big chunk and clear it */
+		set->iir_delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0,
+					 SOF_MEM_CAPS_RAM, delay_size);
+		if (!set->iir_delay) {
+			comp_cl_err(&comp_eq_iir, "eq_iir_setup(), delay allocation fail");
+			ret = -ENOMEM;
+			goto err;
+		}
+
+		/* Assign delay line to each channel EQ */
+		eq_iir_init_delay(set->iir, set->iir_delay, nch);
 	}
 
-	memset(cd->iir_delay, 0, delay_size);
-	cd->iir_delay_size = delay_size;
+	*set_out = set;
+	return 0;
+
+err:
+	eq_iir_free_set(set);
+	return ret;
+}
+
+/* Prepares filters for a new blob received while prepared or streaming. A
+ * running copy() switches to them and fades from the previous filters.
+ */
+static int eq_iir_update(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_eq_iir_config *config;
+	struct comp_buffer *sourceb;
+	struct eq_iir_set *set;
+	int ret;
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+
+	config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	ret = eq_iir_setup(cd, config, sourceb->stream.channels, &set);
+	if (ret < 0) {
+		comp_err(dev, "eq_iir_update(), failed IIR setup");
+		return ret;
+	}
+
+	if (dev->state == COMP_STATE_ACTIVE) {
+		eq_iir_set_pending(cd, set);
+	} else {
+		eq_iir_free_sets(cd);
+		cd->set = set;
+	}
 
-	/* Assign delay line to each channel EQ */
-	eq_iir_init_delay(cd->iir, cd->iir_delay, nch);
 	return 0;
 }
 
@@ -494,7 +694,6 @@ static struct comp_dev *eq_iir_new(const struct comp_driver *drv,
 	struct sof_ipc_comp_process *ipc_iir =
 		(struct sof_ipc_comp_process *)comp;
 	size_t bs = ipc_iir->size;
-	int i;
 	int ret;
 
 	comp_cl_info(&comp_eq_iir, "eq_iir_new()");
@@ -526,13 +725,11 @@ static struct comp_dev *eq_iir_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 
 	cd->eq_iir_func = NULL;
-	cd->iir_delay = NULL;
-	cd->iir_delay_size = 0;
 
 	/* component model data handler */
-	cd->model_handler = comp_data_blob_handler_new(dev);
+	cd->model_handler = comp_data_blob_handler_new_shared(dev);
 	if (!cd->model_handler) {
-		comp_cl_err(&comp_eq_iir, "eq_iir_new(): comp_data_blob_handler_new() failed.");
+		comp_cl_err(&comp_eq_iir, "eq_iir_new(): comp_data_blob_handler_new_shared() failed.");
 		rfree(dev);
 		rfree(cd);
 		return NULL;
@@ -549,9 +746,6 @@ static struct comp_dev *eq_iir_new(const struct comp_driver *drv,
 		return NULL;
 	}
 
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df2t(&cd->iir[i]);
-
 	dev->state = COMP_STATE_READY;
 	return dev;
 }
@@ -562,7 +756,7 @@ static void eq_iir_free(struct comp_dev *dev)
 
 	comp_info(dev, "eq_iir_free()");
 
-	eq_iir_free_delaylines(cd);
+	eq_iir_free_sets(cd);
 	comp_data_blob_handler_free(cd->model_handler);
 
 	rfree(cd);
@@ -652,7 +846,17 @@ static int iir_cmd_set_data(struct comp_dev *dev,
 	switch (cdata->cmd) {
 	case SOF_CTRL_CMD_BINARY:
 		comp_info(dev, "iir_cmd_set_data(), SOF_CTRL_CMD_BINARY");
+
 		ret = comp_data_blob_set_cmd(cd->model_handler, cdata);
+		if (ret < 0)
+			break;
+
+		/* Filters for a prepared component are set up here, not in
+		 * copy()
+		 */
+		if (dev->state >= COMP_STATE_PREPARE &&
+		    comp_is_new_data_blob_available(cd->model_handler))
+			ret = eq_iir_update(dev);
 		break;
 	default:
 		comp_err(dev, "iir_cmd_set_data(), invalid command");
@@ -694,11 +898,26 @@ static int eq_iir_trigger(struct comp_dev *dev, int cmd)
 	comp_info(dev, "eq_iir_trigger()");
 
 	if (cmd == COMP_TRIGGER_START || cmd == COMP_TRIGGER_RELEASE)
-		assert(cd->eq_iir_func);
+		assert(cd->set || cd->eq_iir_func);
 
 	return comp_set_state(dev, cmd);
 }
 
+static void eq_iir_run(void *ctx, void *data,
+		       const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = ctx;
+	struct eq_iir_set *set = data;
+
+	if (audio_stream_is_planar(source) || audio_stream_is_planar(sink))
+		eq_iir_planar(set ? set->iir : NULL, source, sink, frames);
+	else if (set)
+		set->func(set->iir, source, sink, frames);
+	else
+		cd->eq_iir_func(NULL, source, sink, frames);
+}
+
 static void eq_iir_process(struct comp_dev *dev, struct comp_buffer *source,
 			   struct comp_buffer *sink, int frames,
 			   uint32_t source_bytes, uint32_t sink_bytes)
@@ -707,7 +926,13 @@ static void eq_iir_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_invalidate(source, source_bytes);
 
-	cd->eq_iir_func(dev, &source->stream, &sink->stream, frames);
+	if (xfade_active(&cd->xfade))
+		xfade_process(&cd->xfade, eq_iir_run, cd, cd->set_old,
+			      cd->set, &source->stream, &sink->stream,
+			      frames, 1);
+	else
+		eq_iir_run(cd, cd->set, &source->stream, &sink->stream,
+			   frames);
 
 	buffer_writeback(sink, sink_bytes);
 
@@ -723,21 +948,21 @@ static int eq_iir_copy(struct comp_dev *dev)
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
-	int ret;
 
 	comp_dbg(dev, "eq_iir_copy()");
 
 	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
 				  sink_list);
 
-	/* Check for changed configuration */
-	if (comp_is_new_data_blob_available(cd->model_handler)) {
-		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
-		ret = eq_iir_setup(cd, sourceb->stream.channels);
-		if (ret < 0) {
-			comp_err(dev, "eq_iir_copy(), failed IIR setup");
-			return ret;
-		}
+	/* Switch to filters prepared in IPC context once the previous fade
+	 * has ended. The previous ones are faded out and freed there.
+	 */
+	if (cd->set_new && !xfade_active(&cd->xfade)) {
+		cd->set_done = cd->set_old;
+		cd->set_old = cd->set;
+		cd->set = cd->set_new;
+		cd->set_new = NULL;
+		xfade_start(&cd->xfade, cd->xfade_frames);
 	}
 
 	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
@@ -757,6 +982,7 @@ static int eq_iir_prepare(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct sof_ipc_comp_config *config = dev_comp_config(dev);
+	struct sof_eq_iir_config *blob;
 	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
 	uint32_t sink_period_bytes;
@@ -792,26 +1018,20 @@ static int eq_iir_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
-	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	blob = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	cd->xfade_frames = xfade_frames(sourceb->stream.rate);
 
 	/* Initialize EQ */
 	comp_info(dev, "eq_iir_prepare(), source_format=%d, sink_format=%d",
 		  cd->source_format, cd->sink_format);
-	if (cd->config) {
-		ret = eq_iir_setup(cd, sourceb->stream.channels);
+	eq_iir_free_sets(cd);
+	if (blob) {
+		ret = eq_iir_setup(cd, blob, sourceb->stream.channels,
+				   &cd->set);
 		if (ret < 0) {
 			comp_err(dev, "eq_iir_prepare(), setup failed.");
 			goto err;
 		}
-		cd->eq_iir_func = eq_iir_find_func(cd->source_format,
-						   cd->sink_format,
-						   fm_configured,
-						   ARRAY_SIZE(fm_configured));
-		if (!cd->eq_iir_func) {
-			comp_err(dev, "eq_iir_prepare(), No proc func");
-			ret = -EINVAL;
-			goto err;
-		}
 		comp_info(dev, "eq_iir_prepare(), IIR is configured.");
 	} else {
 		cd->eq_iir_func = eq_iir_find_func(cd->source_format,
@@ -834,16 +1054,13 @@ err:
 
 static int eq_iir_reset(struct comp_dev *dev)
 {
-	int i;
 	struct comp_data *cd = comp_get_drvdata(dev);
 
 	comp_info(dev, "eq_iir_reset()");
 
-	eq_iir_free_delaylines(cd);
+	eq_iir_free_sets(cd);
 
 	cd->eq_iir_func = NULL;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df2t(&cd->iir[i]);
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
@@ -853,6 +1070,7 @@ static const struct comp_driver comp_eq_iir = {
 	.type = SOF_COMP_EQ_IIR,
 	.uid = SOF_RT_UUID(eq_iir_uuid),
 	.tctx = &eq_iir_tr,
+	.caps = COMP_CAPS_PLANAR,
 	.ops = {
 		.create = eq_iir_new,
 		.free = eq_iir_free,
@@ -259,9 +259,8 @@ static uint32_t host_get_copy_bytes_one_shot(struct comp_dev *dev)
 	struct dma_sg_elem *local_elem = hd->config.elem_array.elems;
 	uint32_t copy_bytes = 0;
 	uint32_t split_value;
-	uint32_t flags = 0;
 
-	buffer_lock(hd->local_buffer, &flags);
+	buffer_state_invalidate(hd->local_buffer);
 
 	/* calculate minimum size to copy */
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
@@ -269,8 +268,6 @@ static uint32_t host_get_copy_bytes_one_shot(struct comp_dev *dev)
 	else
 		copy_bytes = audio_stream_get_avail_bytes(&hd->local_buffer->stream);
 
-	buffer_unlock(hd->local_buffer, flags);
-
 	/* copy_bytes should be aligned to minimum possible chunk of
 	 * data to be copied by dma.
 	 */
@@ -332,7 +329,6 @@ static uint32_t host_get_copy_bytes_normal(struct comp_dev *dev)
 	uint32_t avail_bytes = 0;
 	uint32_t free_bytes = 0;
 	uint32_t copy_bytes = 0;
-	uint32_t flags = 0;
 	int ret;
 
 	/* get data sizes from DMA */
@@ -344,7 +340,7 @@ static uint32_t host_get_copy_bytes_normal(struct comp_dev *dev)
 		return 0;
 	}
 
-	buffer_lock(hd->local_buffer, &flags);
+	buffer_state_invalidate(hd->local_buffer);
 
 	/* calculate minimum size to copy */
 	if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
@@ -358,8 +354,6 @@ static uint32_t host_get_copy_bytes_normal(struct comp_dev *dev)
 		copy_bytes = MIN(
 			audio_stream_get_avail_bytes(&hd->local_buffer->stream), free_bytes);
 
-	buffer_unlock(hd->local_buffer, flags);
-
 	/* copy_bytes should be aligned to minimum possible chunk of
 	 * data to be copied by dma.
 	 */
@@ -641,6 +635,9 @@ static int host_params(struct comp_dev *dev,
 	struct dma_sg_config *config = &hd->config;
 	uint32_t period_count;
 	uint32_t period_bytes;
+	uint32_t sample_bytes;
+	uint32_t frame_bytes;
+	uint32_t copy_unit;
 	uint32_t buffer_size;
 	uint32_t addr_align;
 	uint32_t align;
@@ -686,6 +683,10 @@ static int host_params(struct comp_dev *dev,
 		return -EINVAL;
 	}
 
+	/* buffer must hold whole samples, also packed ones */
+	sample_bytes = audio_stream_sample_bytes(&hd->local_buffer->stream);
+	align *= sample_bytes / gcd(sample_bytes, align);
+
 	/* retrieve DMA buffer period count */
 	err = dma_get_attribute(hd->dma, DMA_ATTR_BUFFER_PERIOD_COUNT,
 				&period_count);
@@ -747,11 +748,11 @@ static int host_params(struct comp_dev *dev,
 	if (err < 0)
 		return err;
 
-	/* set up DMA configuration - copy in sample bytes. */
-	config->src_width =
-		audio_stream_sample_bytes(&hd->local_buffer->stream);
-	config->dest_width =
-		audio_stream_sample_bytes(&hd->local_buffer->stream);
+	/* set up DMA configuration - copy in sample bytes, packed samples
+	 * are copied in bytes.
+	 */
+	config->src_width = sample_bytes == 3 ? 1 : sample_bytes;
+	config->dest_width = config->src_width;
 	config->cyclic = 0;
 	config->irq_disabled = pipeline_is_timer_driven(dev->pipeline);
 	config->is_scheduling_source = comp_is_scheduling_source(dev);
@@ -786,6 +787,14 @@ static int host_params(struct comp_dev *dev,
 		return err;
 	}
 
+	/* copies must not split a sample, planar buffer pointers move by
+	 * whole frames only
+	 */
+	frame_bytes = audio_stream_frame_bytes(&hd->local_buffer->stream);
+	copy_unit = audio_stream_is_planar(&hd->local_buffer->stream) ?
+		frame_bytes : sample_bytes;
+	hd->dma_copy_align *= copy_unit / gcd(copy_unit, hd->dma_copy_align);
+
 	/* minimal copied data shouldn't be less than alignment */
 	hd->period_bytes = ALIGN_UP(period_bytes, hd->dma_copy_align);
 
@@ -797,9 +806,12 @@ static int host_params(struct comp_dev *dev,
 		host_copy_normal;
 
 	/* set processing function */
-	hd->process =
-		pcm_get_conversion_function(hd->local_buffer->stream.frame_fmt,
-					    hd->local_buffer->stream.frame_fmt);
+	if (audio_stream_is_planar(&hd->local_buffer->stream))
+		hd->process = pcm_convert_planar;
+	else
+		hd->process =
+			pcm_get_conversion_function(hd->local_buffer->stream.frame_fmt,
+						    hd->local_buffer->stream.frame_fmt);
 
 	return 0;
 }
@@ -917,6 +929,7 @@ static const struct comp_driver comp_host = {
 	.type	= SOF_COMP_HOST,
 	.uid	= SOF_RT_UUID(host_uuid),
 	.tctx	= &host_tr,
+	.caps	= COMP_CAPS_PLANAR,
 	.ops	= {
 		.create		= host_new,
 		.free		= host_free,
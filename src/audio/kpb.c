@@ -615,7 +615,6 @@ static int kpb_copy(struct comp_dev *dev)
 	struct comp_buffer *sink = NULL;
 	size_t copy_bytes = 0;
 	size_t sample_width = kpb->config.sampling_width;
-	uint32_t flags = 0;
 	struct draining_data *dd = &kpb->draining_task_data;
 
 	comp_dbg(dev, "kpb_copy()");
@@ -630,18 +629,15 @@ static int kpb_copy(struct comp_dev *dev)
 		goto out;
 	}
 
-	buffer_lock(source, &flags);
+	buffer_state_invalidate(source);
 
 	/* Validate source */
 	if (!source->stream.r_ptr) {
 		comp_err(dev, "kpb_copy(): invalid source pointers.");
 		ret = -EINVAL;
-		buffer_unlock(source, flags);
 		goto out;
 	}
 
-	buffer_unlock(source, flags);
-
 	switch (kpb->state) {
 	case KPB_STATE_RUN:
 		/* In normal RUN state we simply copy to our sink. */
@@ -654,18 +650,15 @@ static int kpb_copy(struct comp_dev *dev)
 			goto out;
 		}
 
-		buffer_lock(sink, &flags);
+		buffer_state_invalidate(sink);
 
 		/* Validate sink */
 		if (!sink->stream.w_ptr) {
 			comp_err(dev, "kpb_copy(): invalid selector sink pointers.");
 			ret = -EINVAL;
-			buffer_unlock(sink, flags);
 			goto out;
 		}
 
-		buffer_unlock(sink, flags);
-
 		copy_bytes = audio_stream_get_copy_bytes(&source->stream, &sink->stream);
 		if (!copy_bytes) {
 			comp_err(dev, "kpb_copy(): nothing to copy sink->free %d source->avail %d",
@@ -713,18 +706,15 @@ static int kpb_copy(struct comp_dev *dev)
 			goto out;
 		}
 
-		buffer_lock(sink, &flags);
+		buffer_state_invalidate(sink);
 
 		/* Validate sink */
 		if (!sink->stream.w_ptr) {
 			comp_err(dev, "kpb_copy(): invalid host sink pointers.");
 			ret = -EINVAL;
-			buffer_unlock(sink, flags);
 			goto out;
 		}
 
-		buffer_unlock(sink, flags);
-
 		copy_bytes = audio_stream_get_copy_bytes(&source->stream, &sink->stream);
 		if (!copy_bytes) {
 			comp_err(dev, "kpb_copy(): nothing to copy sink->free %d source->avail %d",
@@ -1312,45 +1302,29 @@ out:
 static void kpb_drain_samples(void *source, struct audio_stream *sink,
 			      size_t size, size_t sample_width)
 {
-#if CONFIG_FORMAT_S16LE || CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-	void *dst;
-	void *src = source;
-#endif
-	size_t i;
-	size_t j = 0;
-	size_t channel;
-	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
+	char *src = source;
+	char *dst = sink->w_ptr;
+	size_t bytes = size;
+	size_t n;
+	int ret;
 
-	switch (sample_width) {
-#if CONFIG_FORMAT_S16LE
-	case 16:
-		for (i = 0; i < frames; i++) {
-			for (channel = 0; channel < KPB_NUM_OF_CHANNELS; channel++) {
-				dst = audio_stream_write_frag_s16(sink, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-				src = ((int16_t *)src) + 1;
-				j++;
-			}
-		}
-		break;
-#endif /* CONFIG_FORMAT_S16LE */
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-	case 24:
-	case 32:
-		for (i = 0; i < frames; i++) {
-			for (channel = 0; channel < KPB_NUM_OF_CHANNELS; channel++) {
-				dst = audio_stream_write_frag_s32(sink, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-				src = ((int32_t *)src) + 1;
-				j++;
-			}
-		}
-		break;
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
-	default:
+	if (!kpb_is_sample_width_supported(sample_width)) {
 		comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
 		return;
 	}
+
+	/* history buffer segments may split packed frames, copy all
+	 * bytes, only sink may wrap
+	 */
+	while (bytes) {
+		n = MIN(bytes, audio_stream_bytes_without_wrap(sink, dst));
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+
+		bytes -= n;
+		src += n;
+		dst = audio_stream_wrap(sink, dst + n);
+	}
 }
 
 /**
@@ -1365,36 +1339,28 @@ static void kpb_buffer_samples(const struct audio_stream *source,
 			       uint32_t start, void *sink, size_t size,
 			       size_t sample_width)
 {
-	void *src;
-	void *dst = sink;
-	size_t i;
-	size_t j = start /
-		(sample_width == 16 ? sizeof(int16_t) : sizeof(int32_t));
-	size_t channel;
-	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
+	char *src = audio_stream_wrap(source, (char *)source->r_ptr + start);
+	char *dst = sink;
+	size_t bytes = size;
+	size_t n;
+	int ret;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < KPB_NUM_OF_CHANNELS; channel++) {
-			switch (sample_width) {
-			case 16:
-				src = audio_stream_read_frag_s16(source, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-				dst = ((int16_t *)dst) + 1;
-				break;
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-			case 24:
-			case 32:
-				src = audio_stream_read_frag_s32(source, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-				dst = ((int32_t *)dst) + 1;
-				break;
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE*/
-			default:
-				comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
-				return;
-			}
-			j++;
-		}
+	if (!kpb_is_sample_width_supported(sample_width)) {
+		comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
+		return;
+	}
+
+	/* history buffer segments may split packed frames, copy all
+	 * bytes, only source may wrap
+	 */
+	while (bytes) {
+		n = MIN(bytes, audio_stream_bytes_without_wrap(source, src));
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+
+		bytes -= n;
+		dst += n;
+		src = audio_stream_wrap(source, src + n);
 	}
 }
 
@@ -1431,10 +1397,10 @@ static inline bool kpb_is_sample_width_supported(uint32_t sampling_width)
 	case 16:
 	/* FALLTHROUGH */
 #endif /* CONFIG_FORMAT_S16LE */
-#if CONFIG_FORMAT_S24LE
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S24_3LE
 	case 24:
 	/* FALLTHROUGH */
-#endif /* CONFIG_FORMAT_S24LE */
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S24_3LE */
 #if CONFIG_FORMAT_S32LE
 	case 32:
 #endif /* CONFIG_FORMAT_S32LE */
@@ -1462,44 +1428,33 @@ static void kpb_copy_samples(struct comp_buffer *sink,
 			     struct comp_buffer *source, size_t size,
 			     size_t sample_width)
 {
-#if CONFIG_FORMAT_S16LE || CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-	void *dst;
-	void *src;
-#endif
-	size_t i;
-	size_t j = 0;
-	size_t channel;
 	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
 	struct audio_stream *istream = &source->stream;
 	struct audio_stream *ostream = &sink->stream;
+	char *src = istream->r_ptr;
+	char *dst = ostream->w_ptr;
+	size_t bytes;
+	size_t n;
+	int ret;
+
+	if (!kpb_is_sample_width_supported(sample_width)) {
+		comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
+		return;
+	}
+
+	bytes = frames * KPB_NUM_OF_CHANNELS *
+		(KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8);
 
 	buffer_invalidate(source, size);
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < KPB_NUM_OF_CHANNELS; channel++) {
-			switch (sample_width) {
-#if CONFIG_FORMAT_S16LE
-			case 16:
-				dst = audio_stream_write_frag_s16(ostream, j);
-				src = audio_stream_read_frag_s16(istream, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-				break;
-#endif /* CONFIG_FORMAT_S16LE */
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-			case 24:
-				/* FALLTHROUGH */
-			case 32:
-				dst = audio_stream_write_frag_s32(ostream, j);
-				src = audio_stream_read_frag_s32(istream, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-				break;
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE*/
-			default:
-				comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
-				return;
-			}
-			j++;
-		}
+	while (bytes) {
+		n = audio_stream_span_bytes(istream, src, ostream, dst, bytes);
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+
+		bytes -= n;
+		src = audio_stream_wrap(istream, src + n);
+		dst = audio_stream_wrap(ostream, dst + n);
 	}
 
 	buffer_writeback(sink, size);
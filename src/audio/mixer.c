@@ -49,31 +49,39 @@ static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
-	int16_t *src;
-	int16_t *dest;
+	int16_t *src[PLATFORM_MAX_STREAMS];
+	int16_t *dest = sink->w_ptr;
 	int32_t val;
+	int nch = sink->channels;
+	int samples = frames * nch;
+	int n;
 	int i;
 	int j;
-	int channel;
-	uint32_t frag = 0;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
 
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s16(sources[j],
-								 frag);
-				val += *src;
-			}
+	while (samples) {
+		/* largest run that none of the streams wraps in */
+		n = MIN(samples,
+			audio_stream_samples_without_wrap_s16(sink, dest));
+		for (j = 0; j < num_sources; j++)
+			n = MIN(n, audio_stream_samples_without_wrap_s16
+				(sources[j], src[j]));
 
-			dest = audio_stream_write_frag_s16(sink, frag);
+		for (i = 0; i < n; i++) {
+			val = 0;
+			for (j = 0; j < num_sources; j++)
+				val += src[j][i];
 
 			/* Saturate to 16 bits */
-			*dest = sat_int16(val);
-
-			frag++;
+			dest[i] = sat_int16(val);
 		}
+
+		samples -= n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -84,31 +92,39 @@ static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
-	int32_t *src;
-	int32_t *dest;
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	int32_t *dest = sink->w_ptr;
 	int64_t val;
+	int nch = sink->channels;
+	int samples = frames * nch;
+	int n;
 	int i;
 	int j;
-	int channel;
-	uint32_t frag = 0;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
 
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s32(sources[j],
-								 frag);
-				val += *src;
-			}
+	while (samples) {
+		/* largest run that none of the streams wraps in */
+		n = MIN(samples,
+			audio_stream_samples_without_wrap_s32(sink, dest));
+		for (j = 0; j < num_sources; j++)
+			n = MIN(n, audio_stream_samples_without_wrap_s32
+				(sources[j], src[j]));
 
-			dest = audio_stream_write_frag_s32(sink, frag);
+		for (i = 0; i < n; i++) {
+			val = 0;
+			for (j = 0; j < num_sources; j++)
+				val += src[j][i];
 
 			/* Saturate to 32 bits */
-			*dest = sat_int32(val);
-
-			frag++;
+			dest[i] = sat_int32(val);
 		}
+
+		samples -= n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
@@ -283,7 +299,6 @@ static int mixer_copy(struct comp_dev *dev)
 	uint32_t frames = INT32_MAX;
 	uint32_t source_bytes;
 	uint32_t sink_bytes;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "mixer_copy()");
 
@@ -312,19 +327,16 @@ static int mixer_copy(struct comp_dev *dev)
 	if (num_mix_sources == 0)
 		return 0;
 
-	buffer_lock(sink, &flags);
+	buffer_state_invalidate(sink);
 
 	/* check for underruns */
 	for (i = 0; i < num_mix_sources; i++) {
-		buffer_lock(sources[i], &flags);
+		buffer_state_invalidate(sources[i]);
 		frames = MIN(frames,
 			     audio_stream_avail_frames(sources_stream[i],
 						       &sink->stream));
-		buffer_unlock(sources[i], flags);
 	}
 
-	buffer_unlock(sink, flags);
-
 	/* Every source has the same format, so calculate bytes based
 	 * on the first one.
 	 */
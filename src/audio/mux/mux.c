@@ -359,7 +359,6 @@ static int demux_copy(struct comp_dev *dev)
 	uint32_t source_bytes;
 	uint32_t avail;
 	uint32_t sinks_bytes[MUX_MAX_STREAMS] = { 0 };
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "demux_copy()");
 
@@ -372,7 +371,7 @@ static int demux_copy(struct comp_dev *dev)
 	// align sink streams with their respective configurations
 	list_for_item(clist, &dev->bsink_list) {
 		sink = container_of(clist, struct comp_buffer, source_list);
-		buffer_lock(sink, &flags);
+		buffer_state_invalidate(sink);
 		if (sink->sink->state == dev->state) {
 			num_sinks++;
 			i = get_stream_index(cd, sink->pipeline_id);
@@ -380,7 +379,6 @@ static int demux_copy(struct comp_dev *dev)
 			sinks[i] = sink;
 			look_ups[i] = look_up;
 		}
-		buffer_unlock(sink, flags);
 	}
 
 	/* if there are no sinks active */
@@ -390,26 +388,21 @@ static int demux_copy(struct comp_dev *dev)
 	source = list_first_item(&dev->bsource_list, struct comp_buffer,
 				 sink_list);
 
-	buffer_lock(source, &flags);
+	buffer_state_invalidate(source);
 
 	/* check if source is active */
-	if (source->source->state != dev->state) {
-		buffer_unlock(source, flags);
+	if (source->source->state != dev->state)
 		return 0;
-	}
 
 	for (i = 0; i < MUX_MAX_STREAMS; i++) {
 		if (!sinks[i])
 			continue;
-		buffer_lock(sinks[i], &flags);
+		buffer_state_invalidate(sinks[i]);
 		avail = audio_stream_avail_frames(&source->stream,
 						  &sinks[i]->stream);
 		frames = MIN(frames, avail);
-		buffer_unlock(sinks[i], flags);
 	}
 
-	buffer_unlock(source, flags);
-
 	source_bytes = frames * audio_stream_frame_bytes(&source->stream);
 	for (i = 0; i < MUX_MAX_STREAMS; i++) {
 		if (!sinks[i])
@@ -454,7 +447,6 @@ static int mux_copy(struct comp_dev *dev)
 	uint32_t frames = -1;
 	uint32_t sources_bytes[MUX_MAX_STREAMS] = { 0 };
 	uint32_t sink_bytes;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "mux_copy()");
 
@@ -467,14 +459,12 @@ static int mux_copy(struct comp_dev *dev)
 	/* align source streams with their respective configurations */
 	list_for_item(clist, &dev->bsource_list) {
 		source = container_of(clist, struct comp_buffer, sink_list);
-		buffer_lock(source, &flags);
+		buffer_state_invalidate(source);
 		if (source->source->state == dev->state) {
 			num_sources++;
 			i = get_stream_index(cd, source->pipeline_id);
 			sources[i] = source;
 			sources_stream[i] = &source->stream;
-		} else {
-			buffer_unlock(source, flags);
 		}
 	}
 
@@ -485,19 +475,11 @@ static int mux_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
-	buffer_lock(sink, &flags);
+	buffer_state_invalidate(sink);
 
 	/* check if sink is active */
-	if (sink->sink->state != dev->state) {
-		for (i = 0; i < MUX_MAX_STREAMS; i++) {
-			if (!sources[i])
-				continue;
-			buffer_unlock(sources[i], flags);
-		}
-
-		buffer_unlock(sink, flags);
+	if (sink->sink->state != dev->state)
 		return 0;
-	}
 
 	for (i = 0; i < MUX_MAX_STREAMS; i++) {
 		if (!sources[i])
@@ -505,11 +487,8 @@ static int mux_copy(struct comp_dev *dev)
 		frames = MIN(frames,
 			     audio_stream_avail_frames(sources_stream[i],
 						       &sink->stream));
-		buffer_unlock(sources[i], flags);
 	}
 
-	buffer_unlock(sink, flags);
-
 	for (i = 0; i < MUX_MAX_STREAMS; i++) {
 		if (!sources[i])
 			continue;
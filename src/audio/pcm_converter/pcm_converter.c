@@ -11,6 +11,7 @@
  */
 
 #include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
 #include <sof/audio/pcm_converter.h>
 #include <sof/debug/panic.h>
 
@@ -20,8 +21,6 @@ int pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 {
 	const int s_size_in = audio_stream_sample_bytes(source);
 	const int s_size_out = audio_stream_sample_bytes(sink);
-	const int log2_s_size_in = ffs(s_size_in) - 1;
-	const int log2_s_size_out = ffs(s_size_out) - 1;
 	char *r_ptr = audio_stream_get_frag(source, source->r_ptr, ioffset,
 					    s_size_in);
 	char *w_ptr = audio_stream_get_frag(sink, sink->w_ptr, ooffset,
@@ -37,12 +36,11 @@ int pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 		return -EINVAL;
 
 	while (i < samples) {
-		/* calculate chunk size */
-		/* "">> log2_s_size" is equal "/ s_size" here */
-		N1 = audio_stream_bytes_without_wrap(source, r_ptr) >>
-			log2_s_size_in;
-		N2 = audio_stream_bytes_without_wrap(sink, w_ptr) >>
-			log2_s_size_out;
+		/* calculate chunk size, packed samples are 3 bytes */
+		N1 = audio_stream_bytes_without_wrap(source, r_ptr) /
+			s_size_in;
+		N2 = audio_stream_bytes_without_wrap(sink, w_ptr) /
+			s_size_out;
 		chunk = MIN(N1, N2);
 		chunk = MIN(chunk, samples - i);
 
@@ -57,3 +55,226 @@ int pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 
 	return samples;
 }
+
+/* reads fixed point sample as Q1.31 */
+static inline int32_t pcm_planar_get(const void *ptr, enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return *(const int16_t *)ptr << 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return *(const int32_t *)ptr << 8;
+	case SOF_IPC_FRAME_S24_3LE:
+		return load_s24_3le(ptr) << 8;
+	default:
+		return *(const int32_t *)ptr;
+	}
+}
+
+/* writes Q1.31 sample in fixed point format */
+static inline void pcm_planar_set(void *ptr, enum sof_ipc_frame fmt,
+				  int32_t sample)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)ptr = sat_int16(Q_SHIFT_RND(sample, 31, 15));
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)ptr = sat_int24(Q_SHIFT_RND(sample, 31, 23));
+		break;
+	case SOF_IPC_FRAME_S24_3LE:
+		store_s24_3le(ptr, sat_int24(Q_SHIFT_RND(sample, 31, 23)));
+		break;
+	default:
+		*(int32_t *)ptr = sample;
+		break;
+	}
+}
+
+int pcm_convert_planar(const struct audio_stream *source, uint32_t ioffset,
+		       struct audio_stream *sink, uint32_t ooffset,
+		       uint32_t samples)
+{
+	const enum sof_ipc_frame fmt_in = source->frame_fmt;
+	const enum sof_ipc_frame fmt_out = sink->frame_fmt;
+	const int s_size_in = audio_stream_sample_bytes(source);
+	const int s_size_out = audio_stream_sample_bytes(sink);
+	const int step_in = audio_stream_channel_stride(source) * s_size_in;
+	const int step_out = audio_stream_channel_stride(sink) * s_size_out;
+	const uint32_t nch = source->channels;
+	char *r_ptr = audio_stream_wrap(source, (char *)source->r_ptr +
+					audio_stream_ptr_bytes(source,
+							       ioffset * s_size_in));
+	char *w_ptr = audio_stream_wrap(sink, (char *)sink->w_ptr +
+					audio_stream_ptr_bytes(sink,
+							       ooffset * s_size_out));
+	uint32_t frames = samples / nch;
+	uint32_t chunk;
+	uint32_t ch;
+	uint32_t i;
+	char *x;
+	char *y;
+
+	/* assert enough avail/free samples in source and sink buffer */
+	if (audio_stream_get_avail_samples(source) < samples + ioffset)
+		return -EINVAL;
+	if (audio_stream_get_free_samples(sink) < samples + ooffset)
+		return -EINVAL;
+
+	while (frames) {
+		chunk = audio_stream_span_frames(source, r_ptr, sink, w_ptr,
+						 frames);
+
+		/* channel by channel, contiguous on the planar side */
+		for (ch = 0; ch < nch; ch++) {
+			x = audio_stream_channel_ptr(source, r_ptr, ch);
+			y = audio_stream_channel_ptr(sink, w_ptr, ch);
+			for (i = 0; i < chunk; i++) {
+				pcm_planar_set(y, fmt_out,
+					       pcm_planar_get(x, fmt_in));
+				x += step_in;
+				y += step_out;
+			}
+		}
+
+		r_ptr = audio_stream_wrap(source, r_ptr + chunk * step_in);
+		w_ptr = audio_stream_wrap(sink, w_ptr + chunk * step_out);
+		frames -= chunk;
+	}
+
+	return samples;
+}
+
+#if CONFIG_FORMAT_S24_3LE
+
+/* Packed 24 bit samples are byte aligned, so they are converted with plain
+ * byte access on all platforms.
+ */
+
+#if CONFIG_FORMAT_S16LE
+
+static void pcm_convert_s16_to_s24_3le_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const int16_t *src = psrc;
+	uint8_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, dst += 3)
+		store_s24_3le(dst, src[i] << 8);
+}
+
+static void pcm_convert_s24_3le_to_s16_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const uint8_t *src = psrc;
+	int16_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, src += 3)
+		dst[i] = sat_int16(Q_SHIFT_RND(load_s24_3le(src), 23, 15));
+}
+
+int pcm_convert_s16_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s16_to_s24_3le_lin);
+}
+
+int pcm_convert_s24_3le_to_s16(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s24_3le_to_s16_lin);
+}
+
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+
+static void pcm_convert_s24_to_s24_3le_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const int32_t *src = psrc;
+	uint8_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, dst += 3)
+		store_s24_3le(dst, src[i]);
+}
+
+static void pcm_convert_s24_3le_to_s24_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const uint8_t *src = psrc;
+	int32_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, src += 3)
+		dst[i] = load_s24_3le(src);
+}
+
+int pcm_convert_s24_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s24_to_s24_3le_lin);
+}
+
+int pcm_convert_s24_3le_to_s24(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s24_3le_to_s24_lin);
+}
+
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+
+static void pcm_convert_s32_to_s24_3le_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const int32_t *src = psrc;
+	uint8_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, dst += 3)
+		store_s24_3le(dst, sat_int24(Q_SHIFT_RND(src[i], 31, 23)));
+}
+
+static void pcm_convert_s24_3le_to_s32_lin(const void *psrc, void *pdst,
+					   uint32_t samples)
+{
+	const uint8_t *src = psrc;
+	int32_t *dst = pdst;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, src += 3)
+		dst[i] = load_s24_3le(src) << 8;
+}
+
+int pcm_convert_s32_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s32_to_s24_3le_lin);
+}
+
+int pcm_convert_s24_3le_to_s32(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+				     pcm_convert_s24_3le_to_s32_lin);
+}
+
+#endif /* CONFIG_FORMAT_S32LE */
+
+#endif /* CONFIG_FORMAT_S24_3LE */
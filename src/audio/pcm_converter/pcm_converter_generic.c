@@ -411,6 +411,21 @@ const struct pcm_func_map pcm_func_map[] = {
 	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s24_to_s32 },
 	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s32_to_s24 },
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S24_3LE
+	{ SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S24_3LE, audio_stream_copy },
+#endif /* CONFIG_FORMAT_S24_3LE */
+#if CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_3LE, pcm_convert_s16_to_s24_3le },
+	{ SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S16_LE, pcm_convert_s24_3le_to_s16 },
+#endif /* CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_3LE, pcm_convert_s24_to_s24_3le },
+	{ SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s24_3le_to_s24 },
+#endif /* CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_3LE, pcm_convert_s32_to_s24_3le },
+	{ SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s24_3le_to_s32 },
+#endif /* CONFIG_FORMAT_S24_3LE && CONFIG_FORMAT_S32LE */
 #if CONFIG_FORMAT_FLOAT
 	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_FLOAT, audio_stream_copy },
 #endif /* CONFIG_FORMAT_FLOAT */
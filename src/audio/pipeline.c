@@ -64,12 +64,15 @@ void pipeline_posn_init(struct sof *sof)
 
 static enum task_state pipeline_task(void *arg);
 static void pipeline_schedule_cancel(struct pipeline *p);
+static void pipeline_steps_build(struct pipeline *p);
 
 /* create new pipeline - returns pipeline id or negative error */
 struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 			      struct comp_dev *cd)
 {
 	struct sof_ipc_stream_posn posn;
+	struct mm_usage *usage;
+	struct mm_usage *prev;
 	struct pipeline *p;
 	int ret;
 
@@ -77,11 +80,16 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 		     pipe_desc->pipeline_id, pipe_desc->period,
 		     pipe_desc->priority);
 
+	/* charged with its components and buffers */
+	usage = mm_usage_new(MM_USAGE_PIPELINE, pipe_desc->pipeline_id,
+			     pipe_desc->pipeline_id);
+	prev = mm_usage_use(usage);
+
 	/* allocate new pipeline */
 	p = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*p));
 	if (!p) {
 		pipe_cl_err("pipeline_new(): Out of Memory");
-		return NULL;
+		goto err;
 	}
 
 	/* init pipeline */
@@ -99,7 +107,7 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 		pipe_err(p, "pipeline_new(): pipeline_posn_offset_get failed %d",
 			 ret);
 		rfree(p);
-		return NULL;
+		goto err;
 	}
 
 	/* just for retrieving valid ipc_msg header */
@@ -110,15 +118,24 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 	if (!p->msg) {
 		pipe_err(p, "pipeline_new(): ipc_msg_init failed");
 		rfree(p);
-		return NULL;
+		goto err;
 	}
 
+	p->mem_usage = usage;
+	mm_usage_use(prev);
+
 	return p;
+
+err:
+	mm_usage_use(prev);
+	mm_usage_free(usage);
+	return NULL;
 }
 
 int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 		     int dir)
 {
+	struct comp_dev *peer;
 	uint32_t flags;
 
 	if (dir == PPL_CONN_DIR_COMP_TO_BUFFER)
@@ -133,6 +150,16 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 	comp_writeback(comp);
 	irq_local_enable(flags);
 
+	/* graph has changed, flattened copy schedules are stale. A running
+	 * pipeline may be using its steps, so they are only marked here and
+	 * freed or rebuilt by the trigger and reset of their own pipeline.
+	 */
+	peer = buffer_get_comp(buffer, dir);
+	if (comp->pipeline)
+		pipeline_steps_invalidate(comp->pipeline);
+	if (peer && peer->pipeline)
+		pipeline_steps_invalidate(peer->pipeline);
+
 	return 0;
 }
 
@@ -262,6 +289,10 @@ int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 	p->source_comp = source;
 	p->sink_comp = sink;
 	p->status = COMP_STATE_READY;
+	pipeline_steps_free(p);
+
+	/* sized on the first reset, streams run from the heap until then */
+	p->arena = arena_new();
 
 	/* show heap status */
 	heap_trace_all(0);
@@ -332,8 +363,13 @@ int pipeline_free(struct pipeline *p)
 
 	ipc_msg_free(p->msg);
 
+	pipeline_steps_free(p);
+
 	pipeline_posn_offset_put(p->posn_offset);
 
+	arena_free(p->arena);
+	mm_usage_free(p->mem_usage);
+
 	/* now free the pipeline */
 	rfree(p);
 
@@ -494,7 +530,9 @@ static int pipeline_comp_params(struct comp_dev *current,
 	/* set comp direction */
 	current->direction = ppl_data->params->params.direction;
 
+	arena_use(current->pipeline->arena);
 	err = comp_params(current, &ppl_data->params->params);
+	arena_use(NULL);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
@@ -647,7 +685,9 @@ static int pipeline_comp_prepare(struct comp_dev *current,
 	if (err < 0)
 		return err;
 
+	arena_use(current->pipeline->arena);
 	err = comp_prepare(current);
+	arena_use(NULL);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
@@ -822,6 +862,16 @@ static void pipeline_schedule_triggered(struct pipeline_walk_context *ctx,
 	struct pipeline *p;
 	uint32_t flags;
 
+	/* flatten the graphs of pipelines about to be scheduled, so the copy
+	 * doesn't need to walk them every period
+	 */
+	if (cmd == COMP_TRIGGER_START || cmd == COMP_TRIGGER_RELEASE) {
+		list_for_item(tlist, &ctx->pipelines) {
+			p = container_of(tlist, struct pipeline, list);
+			pipeline_steps_build(p);
+		}
+	}
+
 	irq_local_disable(flags);
 
 	list_for_item(tlist, &ctx->pipelines) {
@@ -932,6 +982,9 @@ static int pipeline_comp_reset(struct comp_dev *current,
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
+	/* room for what the stream allocated outside the arena */
+	arena_fit(current->pipeline->arena);
+
 	return pipeline_for_each_comp(current, ctx, dir);
 }
 
@@ -954,6 +1007,8 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 			 ret, dev_comp_id(host));
 	}
 
+	pipeline_steps_free(p);
+
 	return ret;
 }
 
@@ -995,6 +1050,197 @@ static int pipeline_comp_copy(struct comp_dev *current,
 	return err;
 }
 
+/* data used by pipeline_comp_step() while flattening the graph */
+struct pipeline_steps_data {
+	struct comp_dev *start;
+	struct pipeline_step *steps;	/* NULL when only counting */
+	int count;
+	int parent;
+};
+
+static int pipeline_comp_step(struct comp_dev *current,
+			      struct comp_buffer *calling_buf,
+			      struct pipeline_walk_context *ctx, int dir)
+{
+	struct pipeline_steps_data *sd = ctx->comp_data;
+	int parent = sd->parent;
+	int first = sd->count;
+	int idx;
+	int i;
+	int err;
+
+	/* same static pruning as pipeline_comp_copy() */
+	if (!comp_is_single_pipeline(current, sd->start))
+		return 0;
+
+	if (dir == PPL_DIR_DOWNSTREAM) {
+		/* current is copied before the components it feeds */
+		idx = sd->count++;
+		if (sd->steps) {
+			sd->steps[idx].comp = current;
+			sd->steps[idx].parent = parent;
+		}
+
+		sd->parent = idx;
+		err = pipeline_for_each_comp(current, ctx, dir);
+		sd->parent = parent;
+
+		return err;
+	}
+
+	/* current is copied after the components feeding it */
+	err = pipeline_for_each_comp(current, ctx, dir);
+	if (err < 0)
+		return err;
+
+	idx = sd->count++;
+	if (sd->steps) {
+		sd->steps[idx].comp = current;
+		sd->steps[idx].parent = -1;
+
+		/* steps just added by this walk level are children of current */
+		for (i = first; i < idx; i++)
+			if (sd->steps[i].parent < 0)
+				sd->steps[i].parent = idx;
+	}
+
+	return 0;
+}
+
+static void pipeline_copy_start(struct pipeline *p, struct comp_dev **start,
+				uint32_t *dir)
+{
+	if (p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
+		*dir = PPL_DIR_UPSTREAM;
+		*start = p->sink_comp;
+	} else {
+		*dir = PPL_DIR_DOWNSTREAM;
+		*start = p->source_comp;
+	}
+}
+
+/* Flatten the component graph into an array of steps in the order used by
+ * the pipeline copy. Only the topology is captured here, component states
+ * are still checked every period. If this fails the copy just falls back
+ * to walking the graph.
+ */
+static void pipeline_steps_build(struct pipeline *p)
+{
+	struct pipeline_steps_data sd;
+	struct pipeline_walk_context walk_ctx = {
+		.comp_func = pipeline_comp_step,
+		.comp_data = &sd,
+		.skip_incomplete = true,
+	};
+	struct comp_dev *start;
+	uint32_t dir;
+
+	if (!p->source_comp || !p->sink_comp)
+		return;
+
+	pipeline_copy_start(p, &start, &dir);
+
+	/* already up to date */
+	if (p->steps && p->steps_start == start)
+		return;
+
+	pipeline_steps_free(p);
+
+	/* count the steps first */
+	sd.start = start;
+	sd.steps = NULL;
+	sd.count = 0;
+	sd.parent = -1;
+	if (walk_ctx.comp_func(start, NULL, &walk_ctx, dir) < 0 || !sd.count)
+		return;
+
+	sd.steps = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			   sd.count * sizeof(*sd.steps));
+	if (!sd.steps) {
+		pipe_warn(p, "pipeline_steps_build(): no memory, walking graph");
+		return;
+	}
+
+	sd.count = 0;
+	if (walk_ctx.comp_func(start, NULL, &walk_ctx, dir) < 0) {
+		rfree(sd.steps);
+		return;
+	}
+
+	p->steps = sd.steps;
+	p->num_steps = sd.count;
+	p->steps_start = start;
+
+	pipe_dbg(p, "pipeline_steps_build(), %u steps", p->num_steps);
+}
+
+void pipeline_steps_free(struct pipeline *p)
+{
+	struct pipeline_step *steps = p->steps;
+
+	if (!steps)
+		return;
+
+	p->steps = NULL;
+	p->num_steps = 0;
+	p->steps_start = NULL;
+	rfree(steps);
+}
+
+/* Copy data following the flattened schedule. A step is run when its
+ * component is active and the step it was reached from has been run, i.e.
+ * the same pruning as done by pipeline_comp_copy() during the graph walk.
+ */
+static int pipeline_copy_steps(struct pipeline *p, uint32_t dir)
+{
+	struct pipeline_step *steps = p->steps;
+	struct pipeline_step *step;
+	int n = p->num_steps;
+	int err;
+	int i;
+
+	if (dir == PPL_DIR_DOWNSTREAM) {
+		for (i = 0; i < n; i++) {
+			step = &steps[i];
+			step->run = (step->parent < 0 ||
+				     steps[step->parent].run) &&
+				    comp_is_active(step->comp);
+			if (!step->run)
+				continue;
+
+			err = comp_copy(step->comp);
+			if (err < 0)
+				return err;
+
+			/* don't go further on this path */
+			if (err == PPL_STATUS_PATH_STOP)
+				step->run = false;
+		}
+
+		return 0;
+	}
+
+	/* parents are stored after their children going upstream, so select
+	 * the steps first and then copy in order
+	 */
+	for (i = n - 1; i >= 0; i--) {
+		step = &steps[i];
+		step->run = (step->parent < 0 || steps[step->parent].run) &&
+			    comp_is_active(step->comp);
+	}
+
+	for (i = 0; i < n; i++) {
+		if (!steps[i].run)
+			continue;
+
+		err = comp_copy(steps[i].comp);
+		if (err < 0)
+			return err;
+	}
+
+	return 0;
+}
+
 /* Copy data across all pipeline components.
  * For capture pipelines it always starts from source component
  * and continues downstream and for playback pipelines it first
@@ -1012,18 +1258,17 @@ static int pipeline_copy(struct pipeline *p)
 	uint32_t dir;
 	int ret;
 
-	if (p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
-		dir = PPL_DIR_UPSTREAM;
-		start = p->sink_comp;
+	pipeline_copy_start(p, &start, &dir);
+
+	if (p->steps && p->steps_start == start) {
+		ret = pipeline_copy_steps(p, dir);
 	} else {
-		dir = PPL_DIR_DOWNSTREAM;
-		start = p->source_comp;
-	}
+		data.start = start;
+		data.p = p;
 
-	data.start = start;
-	data.p = p;
+		ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+	}
 
-	ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
 	if (ret < 0)
 		pipe_err(p, "pipeline_copy(): ret = %d, start->comp.id = %u, dir = %u",
 			 ret, dev_comp_id(start), dir);
@@ -49,6 +49,13 @@
 #define MAX_FIR_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_FIR_DELAY_SIZE)
 #define MAX_OUT_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_OUT_DELAY_SIZE)
 
+/* Runtime designed filters follow the quality of the coefficient set */
+#if CONFIG_COMP_SRC_TINY
+#define SRC_RUNTIME_QUALITY	SRC_QUALITY_LOW
+#else
+#define SRC_RUNTIME_QUALITY	SRC_QUALITY_HIGH
+#endif
+
 static const struct comp_driver comp_src;
 
 /* c1c5326d-8390-46b4-aa47-95c3beca6550 */
@@ -106,6 +113,43 @@ static int src_find_fs(int fs_list[], int list_length, int fs)
 	return -EINVAL;
 }
 
+/* Finds the stages from coefficient tables or designs them */
+static int src_find_stages(struct src_param *a, int fs_in, int fs_out)
+{
+	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
+	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
+	a->stage1 = NULL;
+	a->stage2 = NULL;
+
+#if CONFIG_COMP_SRC_RUNTIME
+	/* Release the design for previous rates */
+	src_design_put(a->design);
+	a->design = NULL;
+#endif
+
+	if (a->idx_in >= 0 && a->idx_out >= 0) {
+		a->stage1 = src_table1[a->idx_out][a->idx_in];
+		a->stage2 = src_table2[a->idx_out][a->idx_in];
+
+		/* Check from stage1 parameter for a deleted in/out rate
+		 * combination.
+		 */
+		if (a->stage1->filter_length >= 1)
+			return 0;
+	}
+
+#if CONFIG_COMP_SRC_RUNTIME
+	a->design = src_design_get(fs_in, fs_out, SRC_RUNTIME_QUALITY);
+	if (a->design) {
+		a->stage1 = a->design->stage1;
+		a->stage2 = a->design->stage2;
+		return 0;
+	}
+#endif
+
+	return -EINVAL;
+}
+
 /* Calculates buffers to allocate for a SRC mode */
 int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 		       int source_frames)
@@ -122,25 +166,16 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	}
 
 	a->nch = nch;
-	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
-	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
 
 	/* Check that both in and out rates are supported */
-	if (a->idx_in < 0 || a->idx_out < 0) {
+	if (src_find_stages(a, fs_in, fs_out) < 0) {
 		comp_cl_err(&comp_src, "src_buffer_lengths(): rates not supported, fs_in: %u, fs_out: %u",
 			    fs_in, fs_out);
 		return -EINVAL;
 	}
 
-	stage1 = src_table1[a->idx_out][a->idx_in];
-	stage2 = src_table2[a->idx_out][a->idx_in];
-
-	/* Check from stage1 parameter for a deleted in/out rate combination.*/
-	if (stage1->filter_length < 1) {
-		comp_cl_err(&comp_src, "src_buffer_lengths(): Non-supported combination sfs_in = %d, fs_out = %d",
-			    fs_in, fs_out);
-		return -EINVAL;
-	}
+	stage1 = a->stage1;
+	stage2 = a->stage2;
 
 	a->fir_s1 = nch * src_fir_delay_length(stage1);
 	a->out_s1 = nch * src_out_delay_length(stage1);
@@ -270,12 +305,12 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	int n_stages;
 	int ret;
 
-	if (p->idx_in < 0 || p->idx_out < 0)
+	if (!p->stage1 || !p->stage2)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
-	stage1 = src_table1[p->idx_out][p->idx_in];
-	stage2 = src_table2[p->idx_out][p->idx_in];
+	stage1 = p->stage1;
+	stage2 = p->stage2;
 	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
@@ -284,10 +319,10 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	 * stage length is one if conversion needs only one stage.
 	 * If input and output rate is the same return 0 to
 	 * use a simple copy function instead of 1 stage FIR with one
-	 * tap.
+	 * tap. Same rates have one tap in both stages.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
-	if (p->idx_in == p->idx_out)
+	if (n_stages == 1 && src->stage1->filter_length == 1)
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -504,6 +539,10 @@ static void src_free(struct comp_dev *dev)
 	if (cd->delay_lines)
 		rfree(cd->delay_lines);
 
+#if CONFIG_COMP_SRC_RUNTIME
+	src_design_put(cd->param.design);
+#endif
+
 	rfree(cd);
 	rfree(dev);
 }
@@ -764,7 +803,6 @@ static int src_copy(struct comp_dev *dev)
 	struct comp_buffer *source;
 	struct comp_buffer *sink;
 	int ret;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "src_copy()");
 
@@ -774,8 +812,8 @@ static int src_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
-	buffer_lock(source, &flags);
-	buffer_lock(sink, &flags);
+	buffer_state_invalidate(source);
+	buffer_state_invalidate(sink);
 
 	/* Get from buffers and SRC conversion specific block constraints
 	 * how many frames can be processed. If sufficient number of samples
@@ -783,9 +821,6 @@ static int src_copy(struct comp_dev *dev)
 	 */
 	ret = src_get_copy_limits(cd, source, sink);
 
-	buffer_unlock(sink, flags);
-	buffer_unlock(source, flags);
-
 	if (ret) {
 		comp_info(dev, "No data to process.");
 		return PPL_STATUS_PATH_STOP;
@@ -927,6 +962,10 @@ static SHARED_DATA struct comp_driver_info comp_src_info = {
 
 UT_STATIC void sys_comp_src_init(void)
 {
+#if CONFIG_COMP_SRC_RUNTIME
+	src_design_init();
+#endif
+
 	comp_register(platform_shared_get(&comp_src_info,
 					  sizeof(comp_src_info)));
 }
@@ -0,0 +1,588 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <sof/spinlock.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Runtime design of polyphase SRC filters. The conversion ratio is split
+ * to two stages in the same way as in tools/tune/src/src_factor2_lm.m and
+ * each stage is a Kaiser windowed sinc low-pass with the same passband and
+ * stopband criteria as the generated coefficient sets. All arithmetic is
+ * fixed point so the design works also on DSPs without FPU.
+ */
+
+/* Max. interpolation or decimation factor of a stage */
+#define SRC_DESIGN_MAX_FACTOR	128
+
+/* Max. filter length of a stage */
+#define SRC_DESIGN_MAX_LENGTH	4096
+
+/* Subfilter length multiple required by the SRC kernels */
+#define SRC_DESIGN_LENGTH_MULT	4
+
+/* Stopband starts from half of the lower sample rate, in 1/10000 units */
+#define SRC_DESIGN_C_SB		5000
+
+/* Max. coefficient after normalize is 32767/32768 in Q1.31 */
+#define SRC_DESIGN_COEF_MAX	(INT32_MAX - 65535)
+
+/* 2/pi in Q1.31 */
+#define SRC_DESIGN_2_DIV_PI_Q31	1367130551
+
+/* Gain at 0 Hz -1 dB for one stage and -0.5 dB for two stages, Q1.31 */
+#define SRC_DESIGN_GAIN_1S	1913946816
+#define SRC_DESIGN_GAIN_2S	2027355295
+
+#define SRC_DESIGN_ONE_Q24	(1 << 24)
+
+/* Filter design criteria of a quality */
+struct src_design_quality {
+	int c_pb;		/* passband end per lower rate, 1/10000 */
+	int att;		/* stopband attenuation in dB */
+	int32_t beta2;		/* (Kaiser beta / 2)^2, Q8.24 */
+};
+
+static const struct src_design_quality src_design_qualities[] = {
+	[SRC_QUALITY_LOW] = { 3628, 60, 134047224 },
+	[SRC_QUALITY_HIGH] = { 4535, 70, 191400930 },
+};
+
+/* Parameters of a stage to design */
+struct src_design_stage {
+	int fs_in;
+	int fs_out;
+	int l;
+	int m;
+	int c_pb;
+	int32_t gain;
+	int subfilter_length;
+	int shift;
+	int idm;
+	int odm;
+};
+
+/* Cache of designs */
+struct src_design_cache {
+	spinlock_t lock;	/* protects list and reference counts */
+	struct list_item list;	/* designs, most recently used first */
+	int count;		/* number of designs in list */
+};
+
+static SHARED_DATA struct src_design_cache design_cache;
+
+#if SRC_SHORT
+typedef int16_t src_design_coef_t;
+static const int16_t src_design_one = 16384;
+#else
+typedef int32_t src_design_coef_t;
+static const int32_t src_design_one = 1073741824;
+#endif
+
+/* Stage for 1:1 rate or a single stage conversion */
+static struct src_stage src_design_pass = {
+	0, 0, 1, 1, 1, 1, 1, 0, -1, &src_design_one
+};
+
+/* Finds factors a * b = c with a nearest to sqrt(c) */
+static void src_design_factor2(int c, int *a, int *b)
+{
+	int x = 1;
+	int i;
+
+	while ((x + 1) * (x + 1) <= c)
+		x++;
+
+	if (c - x * x > x)
+		x++;
+
+	/* Search first from x to 2x and then from x to x/2 */
+	for (i = 0; i <= x; i++) {
+		if (c % (x + i) == 0) {
+			*a = x + i;
+			break;
+		}
+
+		if (i <= x / 2 && c % (x - i) == 0) {
+			*a = x - i;
+			break;
+		}
+	}
+
+	/* A prime is not split */
+	if (i > x)
+		*a = c;
+
+	*b = c / *a;
+}
+
+/* Splits conversion l / m to l1 / m1 * l2 / m2 */
+static void src_design_factor(struct src_design_stage *s1,
+			      struct src_design_stage *s2, int fs_in, int fs_out)
+{
+	int k = gcd(fs_in, fs_out);
+	int l = fs_out / k;
+	int m = fs_in / k;
+	int l0[2];
+	int m0[2];
+	int fs3;
+	int d;
+	int best = 0;
+	int best_d = INT32_MAX;
+	int i;
+
+	/* Like the coefficient sets 4:3 and 3:4 are done with one stage */
+	if ((l == 4 && m == 3) || (l == 3 && m == 4)) {
+		l0[0] = l;
+		l0[1] = 1;
+		m0[0] = m;
+		m0[1] = 1;
+	} else {
+		src_design_factor2(l, &l0[0], &l0[1]);
+		src_design_factor2(m, &m0[0], &m0[1]);
+	}
+
+	/* Select the intermediate rate nearest to but not less than the
+	 * lower of input and output rates.
+	 */
+	for (i = 0; i < 4; i++) {
+		fs3 = (int)((int64_t)fs_in * l0[i >> 1] / m0[i & 1]);
+		d = fs3 - MIN(fs_in, fs_out);
+		if (d >= 0 && d < best_d) {
+			best_d = d;
+			best = i;
+		}
+	}
+
+	s1->l = l0[best >> 1];
+	s1->m = m0[best & 1];
+	s2->l = l0[!(best >> 1)];
+	s2->m = m0[!(best & 1)];
+
+	/* If the first stage is 1:1 the second is moved to first */
+	if (s1->l == 1 && s1->m == 1) {
+		s1->l = s2->l;
+		s1->m = s2->m;
+		s2->l = 1;
+		s2->m = 1;
+	}
+
+	s1->fs_in = fs_in;
+	s1->fs_out = fs_in / s1->m * s1->l;
+	s2->fs_in = s1->fs_out;
+	s2->fs_out = fs_out;
+}
+
+static int src_design_c_pb(const struct src_design_quality *q, int fs_in,
+			   int fs_out)
+{
+	int min_fs = MIN(fs_in, fs_out);
+
+	/* 24 kHz bandwidth for high rates */
+	if (min_fs > 80000)
+		return 240000000 / min_fs;
+
+	return q->c_pb;
+}
+
+/* Finds idm and odm for the stage as -idm * l + odm * m = 1 */
+static void src_design_l0m0(int l, int m, int *idm, int *odm)
+{
+	int lt;
+
+	*idm = 0;
+	*odm = 1;
+	if (m == 1)
+		return;
+
+	*idm = 1;
+	*odm = 0;
+	if (l == 1)
+		return;
+
+	/* Solution exists with lt < m as l and m are coprime */
+	for (lt = 1; lt < m; lt++) {
+		if ((1 + lt * l) % m == 0) {
+			*idm = lt;
+			*odm = (1 + lt * l) / m;
+			return;
+		}
+	}
+}
+
+/* Modified Bessel function I0 for (x / 2)^2 in Q8.24, result Q8.24 */
+static int64_t src_design_i0(int64_t y)
+{
+	int64_t term = SRC_DESIGN_ONE_Q24;
+	int64_t sum = SRC_DESIGN_ONE_Q24;
+	int k;
+
+	for (k = 1; term > 0; k++) {
+		term = ((term * y) >> 24) / (k * k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+/* Returns windowed sinc tap n of the prototype filter in Q1.31 */
+static int32_t src_design_tap(int n, int length, uint32_t fc,
+			      int32_t beta2, int64_t i0_beta)
+{
+	int64_t half = length - 1;
+	int64_t y;
+	int32_t t2 = 2 * n - (length - 1);
+	int32_t sine;
+	int32_t h;
+	int32_t w;
+	uint32_t phase;
+
+	if (t2 < 0)
+		t2 = -t2;
+
+	/* sin(2 * pi * fc * t) / (pi * t) with t = t2 / 2 that is
+	 * always odd for even length so the sinc center is not sampled.
+	 * The phase is in turns in Q0.32 so it wraps by overflow.
+	 */
+	phase = (uint32_t)(((uint64_t)fc * t2) >> 1);
+	sine = sin_fixed((int32_t)(((uint64_t)phase * PI_MUL2_Q4_28) >> 32));
+	h = (int32_t)((((int64_t)sine * SRC_DESIGN_2_DIV_PI_Q31) >> 31) / t2);
+
+	/* Kaiser window I0(beta * sqrt(1 - r^2)) / I0(beta) */
+	y = beta2 * (half * half - (int64_t)t2 * t2) / (half * half);
+	w = sat_int32((src_design_i0(y) << 31) / i0_beta);
+
+	return (int32_t)(((int64_t)h * w) >> 31);
+}
+
+/* Computes the subfilter length and the polyphase parameters for a stage */
+static int src_design_length(const struct src_design_quality *q,
+			     struct src_design_stage *s)
+{
+	int64_t fs3 = (int64_t)s->fs_in * s->l;
+	int64_t df = (int64_t)MIN(s->fs_in, s->fs_out) *
+		(SRC_DESIGN_C_SB - s->c_pb);
+	int64_t order;
+	int mult = SRC_DESIGN_LENGTH_MULT * s->l;
+	int length;
+
+	/* Kaiser order (att - 7.95) / (14.357 * df / fs3) with df as
+	 * transition width in Hz and 1/10000 units. Length is rounded up
+	 * to have equal length subfilters of multiple of four taps.
+	 */
+	order = (q->att * 1000LL - 7950) * fs3 * 10000 / (14357 * df);
+	if (order >= SRC_DESIGN_MAX_LENGTH)
+		return -EINVAL;
+
+	length = ((int)order + mult) / mult * mult;
+	if (length > SRC_DESIGN_MAX_LENGTH)
+		return -EINVAL;
+
+	s->subfilter_length = length / s->l;
+	src_design_l0m0(s->l, s->m, &s->idm, &s->odm);
+	return 0;
+}
+
+/* Computes the polyphase coefficients and the shift for a stage */
+static int src_design_filter(const struct src_design_quality *q,
+			     struct src_design_stage *s,
+			     src_design_coef_t *coefs)
+{
+	int min_fs = MIN(s->fs_in, s->fs_out);
+	int fs3 = s->fs_in * s->l;
+	int length = s->subfilter_length * s->l;
+	int64_t i0_beta = src_design_i0(q->beta2);
+	int64_t scale;
+	int64_t sum = 0;
+	int64_t max = 0;
+	int64_t c;
+	uint32_t fc;
+	int rshift;
+	int i;
+	int j;
+
+	/* Cutoff in the middle of transition band in turns per sample */
+	fc = (((uint64_t)min_fs * (s->c_pb + SRC_DESIGN_C_SB)) << 32) /
+		(20000ULL * fs3);
+
+	/* Gain at 0 Hz is normalized to l times gain so that the zeros
+	 * inserted by interpolation are compensated.
+	 */
+	for (i = 0; i < length; i++) {
+		c = src_design_tap(i, length, fc, q->beta2, i0_beta);
+		sum += c;
+		max = MAX(max, c < 0 ? -c : c);
+	}
+
+	if (sum <= 0)
+		return -EINVAL;
+
+	scale = (((int64_t)s->l * s->gain) << 24) / sum;
+	max = (max * scale) >> 24;
+	if (!max)
+		return -EINVAL;
+
+	/* Shift the coefficients to use the full scale */
+	s->shift = 0;
+	while (max > SRC_DESIGN_COEF_MAX) {
+		max >>= 1;
+		s->shift--;
+	}
+
+	while ((max << 1) <= SRC_DESIGN_COEF_MAX) {
+		max <<= 1;
+		s->shift++;
+	}
+
+	rshift = 8 * (sizeof(int32_t) - sizeof(src_design_coef_t)) - s->shift;
+
+	/* Subfilter j is taps j, j + l, j + 2l, ... of the prototype */
+	for (j = 0; j < s->l; j++) {
+		for (i = 0; i < s->subfilter_length; i++) {
+			c = src_design_tap(j + i * s->l, length, fc,
+					   q->beta2, i0_beta);
+			c = (c * scale) >> 24;
+			if (rshift > 0)
+				c = (c + (1LL << (rshift - 1))) >> rshift;
+			else
+				c <<= -rshift;
+#if SRC_SHORT
+			*coefs++ = sat_int16(sat_int32(c));
+#else
+			*coefs++ = sat_int32(c);
+#endif
+		}
+	}
+
+	return 0;
+}
+
+/* Sets the stage that has const members */
+static void src_design_stage_init(struct src_stage *stage,
+				  struct src_design_stage *s,
+				  const src_design_coef_t *coefs)
+{
+	struct src_stage init = {
+		s->idm, s->odm, s->l, s->subfilter_length,
+		s->subfilter_length * s->l, s->m, s->l, 0, s->shift, coefs
+	};
+
+	memcpy_s(stage, sizeof(*stage), &init, sizeof(init));
+}
+
+static struct src_design *src_design_new(int fs_in, int fs_out,
+					 enum src_quality quality)
+{
+	const struct src_design_quality *q = &src_design_qualities[quality];
+	struct src_design_stage s[2];
+	struct src_design *design;
+	struct src_stage *stage;
+	src_design_coef_t *coefs;
+	size_t size = sizeof(*design);
+	int stages = 0;
+	int i;
+
+	if (fs_in != fs_out) {
+		src_design_factor(&s[0], &s[1], fs_in, fs_out);
+		stages = s[1].l == 1 && s[1].m == 1 ? 1 : 2;
+	}
+
+	/* The passband of the two stages is the same in Hz */
+	if (stages == 2) {
+		s[0].c_pb = src_design_c_pb(q, s[0].fs_in, s[0].fs_out);
+		s[1].c_pb = src_design_c_pb(q, s[1].fs_in, s[1].fs_out);
+		if (fs_out < fs_in)
+			s[0].c_pb = fs_out * s[1].c_pb /
+				MIN(fs_in, s[0].fs_out);
+		else
+			s[1].c_pb = fs_in * s[0].c_pb /
+				MIN(fs_out, s[0].fs_out);
+
+		s[0].gain = SRC_DESIGN_GAIN_2S;
+		s[1].gain = SRC_DESIGN_GAIN_2S;
+	} else if (stages == 1) {
+		s[0].c_pb = src_design_c_pb(q, fs_in, fs_out);
+		s[0].gain = SRC_DESIGN_GAIN_1S;
+	}
+
+	for (i = 0; i < stages; i++) {
+		if (s[i].l > SRC_DESIGN_MAX_FACTOR ||
+		    s[i].m > SRC_DESIGN_MAX_FACTOR ||
+		    s[i].c_pb < 1000 || s[i].c_pb > 4900)
+			return NULL;
+
+		if (src_design_length(q, &s[i]) < 0)
+			return NULL;
+
+		size += sizeof(*stage) + sizeof(*coefs) *
+			s[i].subfilter_length * s[i].l;
+	}
+
+	design = rballoc(0, SOF_MEM_CAPS_RAM, size);
+	if (!design)
+		return NULL;
+
+	design->fs_in = fs_in;
+	design->fs_out = fs_out;
+	design->quality = quality;
+	design->refs = 1;
+	design->stage1 = &src_design_pass;
+	design->stage2 = &src_design_pass;
+
+	stage = (struct src_stage *)(design + 1);
+	coefs = (src_design_coef_t *)(stage + stages);
+	for (i = 0; i < stages; i++) {
+		if (src_design_filter(q, &s[i], coefs) < 0) {
+			rfree(design);
+			return NULL;
+		}
+
+		src_design_stage_init(&stage[i], &s[i], coefs);
+		coefs += s[i].subfilter_length * s[i].l;
+	}
+
+	if (stages > 0)
+		design->stage1 = &stage[0];
+
+	if (stages > 1)
+		design->stage2 = &stage[1];
+
+	dcache_writeback_region(design, size);
+	return design;
+}
+
+static struct src_design_cache *src_design_cache_get(void)
+{
+	return platform_shared_get(&design_cache, sizeof(design_cache));
+}
+
+void src_design_init(void)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+
+	spinlock_init(&cache->lock);
+	list_init(&cache->list);
+	cache->count = 0;
+
+	platform_shared_commit(cache, sizeof(*cache));
+}
+
+static struct src_design *src_design_find(struct src_design_cache *cache,
+					  int fs_in, int fs_out,
+					  enum src_quality quality)
+{
+	struct list_item *item;
+	struct src_design *design;
+
+	list_for_item(item, &cache->list) {
+		design = container_of(item, struct src_design, list);
+		if (design->fs_in == fs_in && design->fs_out == fs_out &&
+		    design->quality == quality)
+			return design;
+	}
+
+	return NULL;
+}
+
+/* Frees least recently used unused designs above the cache size */
+static void src_design_evict(struct src_design_cache *cache)
+{
+	struct list_item *item = cache->list.prev;
+	struct src_design *design;
+
+	while (item != &cache->list &&
+	       cache->count > CONFIG_COMP_SRC_RUNTIME_CACHE) {
+		design = container_of(item, struct src_design, list);
+		item = item->prev;
+		if (!design->refs) {
+			list_item_del(&design->list);
+			cache->count--;
+			rfree(design);
+		}
+	}
+}
+
+struct src_design *src_design_get(int fs_in, int fs_out,
+				  enum src_quality quality)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+	struct src_design *design;
+	struct src_design *new;
+	uint32_t flags;
+
+	if (fs_in <= 0 || fs_out <= 0)
+		return NULL;
+
+	spin_lock_irq(&cache->lock, flags);
+
+	design = src_design_find(cache, fs_in, fs_out, quality);
+	if (design) {
+		design->refs++;
+		list_item_del(&design->list);
+		list_item_prepend(&design->list, &cache->list);
+	}
+
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock_irq(&cache->lock, flags);
+
+	if (design)
+		return design;
+
+	/* Design is computed without the lock held */
+	new = src_design_new(fs_in, fs_out, quality);
+	if (!new)
+		return NULL;
+
+	spin_lock_irq(&cache->lock, flags);
+
+	/* Another instance may have designed the same conversion */
+	design = src_design_find(cache, fs_in, fs_out, quality);
+	if (design) {
+		design->refs++;
+	} else {
+		list_item_prepend(&new->list, &cache->list);
+		cache->count++;
+		src_design_evict(cache);
+	}
+
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock_irq(&cache->lock, flags);
+
+	if (!design)
+		return new;
+
+	rfree(new);
+	return design;
+}
+
+void src_design_put(struct src_design *design)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+	uint32_t flags;
+
+	if (!design)
+		return;
+
+	spin_lock_irq(&cache->lock, flags);
+
+	/* Unused design stays cached until evicted */
+	design->refs--;
+	src_design_evict(cache);
+
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock_irq(&cache->lock, flags);
+}
@@ -17,8 +17,70 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/* Max. channels count for the frame-wise FIR */
+#define SRC_FRAME_MAX_CH	8
+
 #if SRC_SHORT /* 16 bit coefficients version */
 
+/* FIR for all channels of a frame at once so that a coefficient is loaded
+ * once per tap. The nch is constant in the calls so that the compiler can
+ * unroll the channel loops and keep the accumulators in registers.
+ */
+static inline void fir_filter_frame(int32_t *rp, const void *cp, int32_t *wp,
+				    int32_t *fir_start, int32_t *fir_end,
+				    const int taps_x_nch, const int shift,
+				    const int nch)
+{
+	int64_t y[SRC_FRAME_MAX_CH];
+	int32_t *data;
+	const int16_t *coef = (const int16_t *)cp;
+	int16_t c;
+	int i;
+	int j;
+	int n1;
+	int n2;
+	int frames;
+	const int qshift = 15 + shift; /* Q2.46 -> Q2.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+
+	/* The channels are in reverse order in the delay line. Note that
+	 * initialization code ensures that circular wrap does not happen
+	 * mid-frame.
+	 */
+	data = rp - (nch - 1);
+	frames = fir_end - data; /* Words until wrap */
+	n1 = ((taps_x_nch < frames) ? taps_x_nch : frames) / nch;
+	n2 = taps_x_nch / nch - n1;
+
+	/* Initialize to half LSB for rounding */
+	for (j = 0; j < nch; j++)
+		y[j] = rnd;
+
+	/* The FIR is calculated as Q1.15 x Q1.31 -> Q2.46. The output
+	 * shift includes the shift by 15 for Qx.46 to Qx.31.
+	 */
+	for (i = 0; i < n1; i++) {
+		c = *coef++;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+
+		data += nch;
+	}
+	if (data == fir_end)
+		data = fir_start;
+
+	for (i = 0; i < n2; i++) {
+		c = *coef++;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+
+		data += nch;
+	}
+
+	for (j = 0; j < nch; j++)
+		wp[j] = sat_int32(y[nch - 1 - j] >> qshift);
+}
+
 static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 				      int32_t *fir_start, int32_t *fir_end,
 				      const int fir_delay_length,
@@ -39,6 +101,22 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 	int32_t *d = rp;
 	int32_t *wp = wp0;
 
+	/* Frame-wise FIR for common multi-channel cases */
+	switch (nch) {
+	case 4:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 4);
+		return;
+	case 6:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 6);
+		return;
+	case 8:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 8);
+		return;
+	}
+
 	/* Check for 2ch FIR case */
 	if (nch == 2) {
 		/* Decrement data pointer to next channel start. Note that
@@ -121,6 +199,65 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 
 #else /* 32bit coefficients version */
 
+/* FIR for all channels of a frame at once so that a coefficient is loaded
+ * once per tap. The nch is constant in the calls so that the compiler can
+ * unroll the channel loops and keep the accumulators in registers.
+ */
+static inline void fir_filter_frame(int32_t *rp, const void *cp, int32_t *wp,
+				    int32_t *fir_start, int32_t *fir_end,
+				    const int taps_x_nch, const int shift,
+				    const int nch)
+{
+	int64_t y[SRC_FRAME_MAX_CH];
+	int32_t *data;
+	const int32_t *coef = (const int32_t *)cp;
+	int32_t c;
+	int i;
+	int j;
+	int n1;
+	int n2;
+	int frames;
+	const int qshift = 23 + shift; /* Qx.54 -> Qx.31 */
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+
+	/* The channels are in reverse order in the delay line. Note that
+	 * initialization code ensures that circular wrap does not happen
+	 * mid-frame.
+	 */
+	data = rp - (nch - 1);
+	frames = fir_end - data; /* Words until wrap */
+	n1 = ((taps_x_nch < frames) ? taps_x_nch : frames) / nch;
+	n2 = taps_x_nch / nch - n1;
+
+	/* Initialize to half LSB for rounding */
+	for (j = 0; j < nch; j++)
+		y[j] = rnd;
+
+	/* The FIR is calculated as Q1.23 x Q1.31 -> Q2.54. The output
+	 * shift includes the shift by 23 for Qx.54 to Qx.31.
+	 */
+	for (i = 0; i < n1; i++) {
+		c = *coef++ >> 8;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+
+		data += nch;
+	}
+	if (data == fir_end)
+		data = fir_start;
+
+	for (i = 0; i < n2; i++) {
+		c = *coef++ >> 8;
+		for (j = 0; j < nch; j++)
+			y[j] += (int64_t)c * data[j];
+
+		data += nch;
+	}
+
+	for (j = 0; j < nch; j++)
+		wp[j] = sat_int32(y[nch - 1 - j] >> qshift);
+}
+
 static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 				      int32_t *fir_start, int32_t *fir_end,
 				      int fir_delay_length,
@@ -142,6 +279,22 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 	int32_t *d = rp;
 	int32_t *wp = wp0;
 
+	/* Frame-wise FIR for common multi-channel cases */
+	switch (nch) {
+	case 4:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 4);
+		return;
+	case 6:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 6);
+		return;
+	case 8:
+		fir_filter_frame(rp, cp, wp0, fir_start, fir_end, taps_x_nch,
+				 shift, 8);
+		return;
+	}
+
 	/* Check for 2ch FIR case */
 	if (nch == 2) {
 		/* Decrement data pointer to next channel start. Note that
@@ -282,9 +282,9 @@ static struct comp_dev *tdfb_new(const struct comp_driver *drv,
 	cd->fir_delay_size = 0;
 
 	/* Handler for configuration data */
-	cd->model_handler = comp_data_blob_handler_new(dev);
+	cd->model_handler = comp_data_blob_handler_new_shared(dev);
 	if (!cd->model_handler) {
-		comp_cl_err(&comp_tdfb, "tdfb_new(): comp_data_blob_handler_new() failed.");
+		comp_cl_err(&comp_tdfb, "tdfb_new(): comp_data_blob_handler_new_shared() failed.");
 		rfree(dev);
 		rfree(cd);
 		return NULL;
@@ -479,7 +479,7 @@ static int tdfb_prepare(struct comp_dev *dev)
 
 		/* Clear in/out buffers */
 		memset(cd->in, 0, TDFB_IN_BUF_LENGTH * sizeof(int32_t));
-		memset(cd->out, 0, TDFB_IN_BUF_LENGTH * sizeof(int32_t));
+		memset(cd->out, 0, TDFB_OUT_BUF_LENGTH * sizeof(int32_t));
 
 		ret = set_func(dev);
 		return ret;
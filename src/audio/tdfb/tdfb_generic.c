@@ -13,66 +13,79 @@
 #if TDFB_GENERIC
 
 #include <sof/math/fir_generic.h>
-
-#if CONFIG_FORMAT_S16LE
-void tdfb_fir_s16(struct tdfb_comp_data *cd,
-		  const struct audio_stream *source,
-		  struct audio_stream *sink, int frames)
+#include <sof/math/numbers.h>
+
+/* Run and mix all filters to their output channel for a block of frames.
+ * The input in cd->in[] is stored for each channel as a block of
+ * TDFB_BLOCK_FRAMES samples. The output in cd->out[] is interleaved and
+ * stored as Q5.27 to fit max. 16 filters sum to a channel.
+ */
+static void tdfb_filter_block(struct tdfb_comp_data *cd, int frames,
+			      int out_nch)
 {
 	struct sof_tdfb_config *cfg = cd->config;
-	struct fir_state_32x16 *filter;
-	int32_t y0;
-	int32_t y1;
-	int16_t *x;
-	int16_t *y;
-	int is2;
-	int is;
+	int32_t y[TDFB_BLOCK_FRAMES];
+	int32_t *x;
 	int om;
 	int i;
 	int j;
 	int k;
-	int in_nch = source->channels;
-	int out_nch = sink->channels;
-	int idx_in = 0;
-	int idx_out = 0;
 
-	for (j = 0; j < (frames >> 1); j++) {
-		/* Clear output mix*/
-		memset(cd->out, 0,  2 * out_nch * sizeof(int32_t));
+	/* Clear output mix */
+	memset(cd->out, 0, frames * out_nch * sizeof(int32_t));
 
-		/* Read two frames from all input channels */
-		for (i = 0; i < 2 * in_nch; i++) {
-			x = audio_stream_read_frag_s16(source, idx_in++);
-			cd->in[i] = *x << 16;
-		}
+	for (i = 0; i < cfg->num_filters; i++) {
+		x = &cd->in[cd->input_channel_select[i] * TDFB_BLOCK_FRAMES];
+		fir_32x16_block(&cd->fir[i], x, y, frames, 1);
 
-		/* Run and mix all filters to their output channel */
-		for (i = 0; i < cfg->num_filters; i++) {
-			is = cd->input_channel_select[i];
-			is2 = is + in_nch;
-			om = cd->output_channel_mix[i];
-			filter = &cd->fir[i];
-			/* Process sample and successive sample. This follows
-			 * optimized FIR version implementation that processes
-			 * two samples per call. The output is stored as Q5.27
-			 * to fit max. 16 filters sum to a channel.
-			 */
-			y0 = fir_32x16(filter, cd->in[is]) >> 4;
-			y1 = fir_32x16(filter, cd->in[is2]) >> 4;
-			for (k = 0; k < out_nch; k++) {
-				if (om & 1) {
-					cd->out[k] += y0;
-					cd->out[k + out_nch] += y1;
-				}
-				om = om >> 1;
+		om = cd->output_channel_mix[i];
+		for (k = 0; k < out_nch; k++) {
+			if (om & 1) {
+				for (j = 0; j < frames; j++)
+					cd->out[j * out_nch + k] += y[j] >> 4;
 			}
+
+			om = om >> 1;
 		}
+	}
+}
 
-		/* Write two frames of output */
-		for (i = 0; i < 2 * out_nch; i++) {
-			y = audio_stream_write_frag_s16(sink, idx_out++);
-			*y = sat_int16(Q_SHIFT_RND(cd->out[i], 27, 15));
+#if CONFIG_FORMAT_S16LE
+void tdfb_fir_s16(struct tdfb_comp_data *cd,
+		  const struct audio_stream *source,
+		  struct audio_stream *sink, int frames)
+{
+	int16_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
+	int in_nch = source->channels;
+	int out_nch = sink->channels;
+	int remaining_frames = frames;
+	int n;
+	int i;
+	int j;
+
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, TDFB_BLOCK_FRAMES);
+
+		/* Read a block of frames from all input channels */
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < in_nch; i++)
+				cd->in[i * TDFB_BLOCK_FRAMES + j] = x[i] << 16;
+
+			x += in_nch;
 		}
+
+		tdfb_filter_block(cd, n, out_nch);
+
+		/* Write a block of output */
+		for (i = 0; i < n * out_nch; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(cd->out[i], 27, 15));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y + n * out_nch);
 	}
 }
 #endif
@@ -82,60 +95,37 @@ void tdfb_fir_s24(struct tdfb_comp_data *cd,
 		  const struct audio_stream *source,
 		  struct audio_stream *sink, int frames)
 {
-	struct sof_tdfb_config *cfg = cd->config;
-	struct fir_state_32x16 *filter;
-	int32_t y0;
-	int32_t y1;
-	int32_t *x;
-	int32_t *y;
-	int is2;
-	int is;
-	int om;
-	int i;
-	int j;
-	int k;
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
 	int in_nch = source->channels;
 	int out_nch = sink->channels;
-	int idx_in = 0;
-	int idx_out = 0;
+	int remaining_frames = frames;
+	int n;
+	int i;
+	int j;
 
-	for (j = 0; j < (frames >> 1); j++) {
-		/* Clear output mix*/
-		memset(cd->out, 0,  2 * out_nch * sizeof(int32_t));
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, TDFB_BLOCK_FRAMES);
 
-		/* Read two frames from all input channels */
-		for (i = 0; i < 2 * in_nch; i++) {
-			x = audio_stream_read_frag_s32(source, idx_in++);
-			cd->in[i] = *x << 8;
-		}
+		/* Read a block of frames from all input channels */
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < in_nch; i++)
+				cd->in[i * TDFB_BLOCK_FRAMES + j] = x[i] << 8;
 
-		/* Run and mix all filters to their output channel */
-		for (i = 0; i < cfg->num_filters; i++) {
-			is = cd->input_channel_select[i];
-			is2 = is + in_nch;
-			om = cd->output_channel_mix[i];
-			filter = &cd->fir[i];
-			/* Process sample and successive sample. This follows
-			 * optimized FIR version implementation that processes
-			 * two samples per call. The output is stored as Q5.27
-			 * to fit max. 16 filters sum to a channel.
-			 */
-			y0 = fir_32x16(filter, cd->in[is]) >> 4;
-			y1 = fir_32x16(filter, cd->in[is2]) >> 4;
-			for (k = 0; k < out_nch; k++) {
-				if (om & 1) {
-					cd->out[k] += y0;
-					cd->out[k + out_nch] += y1;
-				}
-				om = om >> 1;
-			}
+			x += in_nch;
 		}
 
-		/* Write two frames of output */
-		for (i = 0; i < 2 * out_nch; i++) {
-			y = audio_stream_write_frag_s32(sink, idx_out++);
-			*y = sat_int24(Q_SHIFT_RND(cd->out[i], 27, 23));
-		}
+		tdfb_filter_block(cd, n, out_nch);
+
+		/* Write a block of output */
+		for (i = 0; i < n * out_nch; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(cd->out[i], 27, 23));
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y + n * out_nch);
 	}
 }
 #endif
@@ -145,62 +135,40 @@ void tdfb_fir_s32(struct tdfb_comp_data *cd,
 		  const struct audio_stream *source,
 		  struct audio_stream *sink, int frames)
 {
-	struct sof_tdfb_config *cfg = cd->config;
-	struct fir_state_32x16 *filter;
-	int32_t y0;
-	int32_t y1;
-	int32_t *x;
-	int32_t *y;
-	int is2;
-	int is;
-	int om;
-	int i;
-	int j;
-	int k;
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
 	int in_nch = source->channels;
 	int out_nch = sink->channels;
-	int idx_in = 0;
-	int idx_out = 0;
+	int remaining_frames = frames;
+	int n;
+	int i;
+	int j;
 
-	for (j = 0; j < (frames >> 1); j++) {
-		/* Clear output mix*/
-		memset(cd->out, 0,  2 * out_nch * sizeof(int32_t));
+	while (remaining_frames) {
+		n = audio_stream_span_frames(source, x, sink, y,
+					     remaining_frames);
+		n = MIN(n, TDFB_BLOCK_FRAMES);
 
-		/* Read two frames from all input channels */
-		for (i = 0; i < 2 * in_nch; i++) {
-			x = audio_stream_read_frag_s32(source, idx_in++);
-			cd->in[i] = *x;
-		}
+		/* Read a block of frames from all input channels */
+		for (j = 0; j < n; j++) {
+			for (i = 0; i < in_nch; i++)
+				cd->in[i * TDFB_BLOCK_FRAMES + j] = x[i];
 
-		/* Run and mix all filters to their output channel */
-		for (i = 0; i < cfg->num_filters; i++) {
-			is = cd->input_channel_select[i];
-			is2 = is + in_nch;
-			om = cd->output_channel_mix[i];
-			filter = &cd->fir[i];
-			/* Process sample and successive sample. This follows
-			 * optimized FIR version implementation that processes
-			 * two samples per call. The output is stored as Q5.27
-			 * to fit max. 16 filters sum to a channel.
-			 */
-			y0 = fir_32x16(filter, cd->in[is]) >> 4;
-			y1 = fir_32x16(filter, cd->in[is2]) >> 4;
-			for (k = 0; k < out_nch; k++) {
-				if (om & 1) {
-					cd->out[k] += y0;
-					cd->out[k + out_nch] += y1;
-				}
-				om = om >> 1;
-			}
+			x += in_nch;
 		}
 
-		/* Write two frames of output. In Q5.27 to Q1.31 conversion
-		 * rounding is not applicable so just shift left by 4.
+		tdfb_filter_block(cd, n, out_nch);
+
+		/* In Q5.27 to Q1.31 conversion rounding is not applicable
+		 * so just shift left by 4.
 		 */
-		for (i = 0; i < 2 * out_nch; i++) {
-			y = audio_stream_write_frag_s32(sink, idx_out++);
-			*y = sat_int32((int64_t)cd->out[i] << 4);
-		}
+		/* Write a block of output */
+		for (i = 0; i < n * out_nch; i++)
+			y[i] = sat_int32((int64_t)cd->out[i] << 4);
+
+		remaining_frames -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y + n * out_nch);
 	}
 }
 #endif
@@ -620,7 +620,6 @@ static int tone_copy(struct comp_dev *dev)
 	struct comp_buffer *sink;
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t free;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "tone_copy()");
 
@@ -628,9 +627,8 @@ static int tone_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
-	buffer_lock(sink, &flags);
+	buffer_state_invalidate(sink);
 	free = audio_stream_get_free_bytes(&sink->stream);
-	buffer_unlock(sink, flags);
 
 	/* Test that sink has enough free frames. Then run once to maintain
 	 * low latency and steady load for tones.
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/xfade.h>
+#include <sof/common.h>
+#include <sof/debug/panic.h>
+#include <stdint.h>
+
+/* Size of work buffer for the previous output in samples */
+#define XFADE_BLOCK_SAMPLES	64
+
+static void xfade_mix_block(struct xfade *xf, const void *prev,
+			    struct audio_stream *sink, uint32_t frames)
+{
+	const int16_t *prev16 = prev;
+	const int32_t *prev32 = prev;
+	uint32_t sample_bytes = audio_stream_sample_bytes(sink);
+	uint32_t step = audio_stream_channel_stride(sink) * sample_bytes;
+	char *ptr = sink->w_ptr;
+	char *y;
+	int32_t gain;
+	uint32_t i;
+	uint32_t j;
+
+	/* The previous output is interleaved, the sink may be planar */
+	for (i = 0; i < frames; i++) {
+		gain = xfade_gain(xf, i);
+		for (j = 0; j < sink->channels; j++) {
+			y = audio_stream_channel_ptr(sink, ptr, j);
+			if (sample_bytes == sizeof(int16_t))
+				*(int16_t *)y = xfade_mix(*prev16++,
+							  *(int16_t *)y, gain);
+			else
+				*(int32_t *)y = xfade_mix(*prev32++,
+							  *(int32_t *)y, gain);
+		}
+
+		ptr = audio_stream_wrap(sink, ptr + step);
+	}
+}
+
+void xfade_process(struct xfade *xf, xfade_func func, void *ctx,
+		   void *prev, void *next, const struct audio_stream *source,
+		   struct audio_stream *sink, uint32_t frames, uint32_t align)
+{
+	int32_t buf[XFADE_BLOCK_SAMPLES];
+	struct audio_stream x = *source;
+	struct audio_stream y = *sink;
+	struct audio_stream tmp = *sink;
+	uint32_t block = ALIGN_DOWN(XFADE_BLOCK_SAMPLES / sink->channels,
+				    align);
+	uint32_t bytes;
+	uint32_t n;
+
+	assert(block);
+
+	while (frames && xfade_active(xf)) {
+		n = MIN(frames, block);
+
+		/* previous output to work buffer, new output to sink */
+		tmp.buffer_fmt = SOF_IPC_BUFFER_INTERLEAVED;
+		audio_stream_init(&tmp, buf, n * audio_stream_frame_bytes(&y));
+		func(ctx, prev, &x, &tmp, n);
+		func(ctx, next, &x, &y, n);
+		xfade_mix_block(xf, buf, &y, n);
+
+		bytes = audio_stream_ptr_bytes(&x, n *
+					       audio_stream_frame_bytes(&x));
+		x.r_ptr = audio_stream_wrap(&x, (char *)x.r_ptr + bytes);
+		bytes = audio_stream_ptr_bytes(&y, n *
+					       audio_stream_frame_bytes(&y));
+		y.w_ptr = audio_stream_wrap(&y, (char *)y.w_ptr + bytes);
+		xfade_advance(xf, n);
+		frames -= n;
+	}
+
+	if (frames)
+		func(ctx, next, &x, &y, frames);
+}
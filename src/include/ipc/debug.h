@@ -36,4 +36,38 @@ struct sof_ipc_dbg_mem_usage {
 	struct sof_ipc_dbg_mem_usage_elem elems[];	/**< memory usage information */
 } __attribute__((packed));
 
+/** ABI3.21 */
+enum sof_ipc_dbg_mem_owner {
+	SOF_IPC_MEM_OWNER_COMP		= 0,	/**< Component */
+	SOF_IPC_MEM_OWNER_BUFFER	= 1,	/**< Buffer */
+	SOF_IPC_MEM_OWNER_PIPELINE	= 2,	/**< Pipeline with its members */
+};
+
+/** ABI3.21 */
+struct sof_ipc_dbg_comp_mem_usage_elem {
+	uint32_t owner;		/**< see sof_ipc_dbg_mem_owner */
+	uint32_t id;		/**< component, buffer or pipeline id */
+	uint32_t pipeline_id;	/**< pipeline of the owner */
+	uint32_t zone;		/**< see sof_ipc_dbg_mem_zone */
+	uint32_t used;		/**< number of bytes in use in zone */
+	uint32_t peak;		/**< most bytes in use in zone at once */
+} __attribute__((packed));
+
+/** ABI3.21 */
+struct sof_ipc_dbg_comp_mem_usage_req {
+	struct sof_ipc_cmd_hdr hdr;	/**< generic IPC header */
+	uint32_t first_elem;		/**< index of first elem to report */
+	uint32_t reserved[3];		/**< reserved for future use */
+} __attribute__((packed));
+
+/** ABI3.21 */
+struct sof_ipc_dbg_comp_mem_usage {
+	struct sof_ipc_reply rhdr;	/**< generic IPC reply header */
+	uint32_t reserved[4];		/**< reserved for future use */
+	uint32_t total_elems;		/**< elems available in the DSP */
+	uint32_t first_elem;		/**< index of elems[0] */
+	uint32_t num_elems;		/**< elems[] counter */
+	struct sof_ipc_dbg_comp_mem_usage_elem elems[];	/**< owner usage */
+} __attribute__((packed));
+
 #endif /* __IPC_DEBUG_H__ */
@@ -291,6 +291,7 @@
  */
 
 #define SOF_IPC_DEBUG_MEM_USAGE			SOF_CMD_TYPE(0x001)
+#define SOF_IPC_DEBUG_COMP_MEM_USAGE		SOF_CMD_TYPE(0x002)
 
 /** @} */
 
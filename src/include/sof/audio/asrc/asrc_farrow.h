@@ -167,6 +167,10 @@ struct asrc_farrow {
 					  /*!< coefficients */
 	int32_t *impulse_response; /*!< Pointer to the impulse response */
 				   /*!< for generating one output sample */
+	uint32_t ir_time_value;	/*!< Time value the impulse response */
+				/*!< was calculated for (5q27) */
+	bool ir_valid;		/*!< Flag is set to true when */
+				/*!< impulse_response matches ir_time_value */
 
 	/* PROGRAM + general */
 	bool is_initialised;	/*!< Flag is set to true after */
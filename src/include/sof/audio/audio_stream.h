@@ -15,10 +15,13 @@
 #define __SOF_AUDIO_AUDIO_STREAM_H__
 
 #include <sof/audio/format.h>
+#include <sof/barrier.h>
+#include <sof/compiler_attributes.h>
 #include <sof/debug/panic.h>
 #include <sof/math/numbers.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
+#include <sof/lib/memory.h>
 #include <ipc/stream.h>
 
 #include <stdbool.h>
@@ -41,14 +44,23 @@
  * consumption/production and update the buffer state by calling
  * audio_stream_consume()/audio_stream_produce() (just a single call following
  * series of reads/writes).
+ *
+ * The stream is a single producer single consumer ring. The write position
+ * is modified only by the producer and the read position only by the
+ * consumer, each on its own cache line. Available and free bytes are
+ * derived from the total byte counts of both sides, so the two ends can
+ * update the stream without locking.
+ *
+ * Frames are stored either interleaved or planar. A planar stream splits
+ * the buffer into one ring per channel, each of size / channels bytes. The
+ * read and write pointers then address the ring of channel 0 and samples of
+ * the other channels are at the same offset in their rings, see
+ * audio_stream_channel_ptr(). Byte counts passed to the stream API always
+ * cover all channels.
  */
 struct audio_stream {
 	/* runtime data */
 	uint32_t size;	/**< Runtime buffer size in bytes (period multiple) */
-	uint32_t avail;	/**< Available bytes for reading */
-	uint32_t free;	/**< Free bytes for writing */
-	void *w_ptr;	/**< Buffer write pointer */
-	void *r_ptr;	/**< Buffer read position */
 	void *addr;	/**< Buffer base address */
 	void *end_addr;	/**< Buffer end address */
 
@@ -56,9 +68,18 @@ struct audio_stream {
 	enum sof_ipc_frame frame_fmt;	/**< Sample data format */
 	uint32_t rate;		/**< Number of data frames per second [Hz] */
 	uint16_t channels;	/**< Number of samples in each frame */
+	uint32_t buffer_fmt;	/**< enum sof_ipc_buffer_format, data layout */
 
 	bool overrun_permitted; /**< indicates whether overrun is permitted */
 	bool underrun_permitted; /**< indicates whether underrun is permitted */
+
+	/* producer state */
+	void *w_ptr __aligned(PLATFORM_DCACHE_ALIGN); /**< Buffer write pointer */
+	uint32_t produced;	/**< Written bytes count, wraps at 2^32 */
+
+	/* consumer state */
+	void *r_ptr __aligned(PLATFORM_DCACHE_ALIGN); /**< Buffer read position */
+	uint32_t consumed;	/**< Read bytes count, wraps at 2^32 */
 };
 
 /**
@@ -150,7 +171,8 @@ struct audio_stream {
 /**
  * Retrieves address of sample (space for sample) at specified index within
  * the buffer. Index is interpreted as an offset relative to the specified
- * pointer, rollover is ensured.
+ * pointer, rollover is ensured. Applies to interleaved streams, samples of
+ * planar streams are addressed with audio_stream_channel_ptr().
  * @param buffer Circular buffer.
  * @param ptr Pointer to start from, it may be either read or write pointer.
  * @param idx Index of the sample.
@@ -160,11 +182,69 @@ struct audio_stream {
 #define audio_stream_get_frag(buffer, ptr, idx, sample_size) \
 	audio_stream_wrap(buffer, (char *)(ptr) + ((idx) * (sample_size)))
 
+/**
+ * Checks whether channels of the stream are stored in separate rings.
+ * @param buffer Buffer.
+ * @return True for non-interleaved data.
+ */
+static inline bool audio_stream_is_planar(const struct audio_stream *buffer)
+{
+	return buffer->buffer_fmt == SOF_IPC_BUFFER_NONINTERLEAVED;
+}
+
+/**
+ * Calculates size of the ring the read and write pointers move in, it is
+ * the ring of a single channel for planar streams.
+ * @param buffer Buffer.
+ * @return Ring size in bytes.
+ */
+static inline uint32_t
+audio_stream_channel_size(const struct audio_stream *buffer)
+{
+	if (audio_stream_is_planar(buffer))
+		return buffer->size / buffer->channels;
+
+	return buffer->size;
+}
+
+/**
+ * Converts number of bytes of all channels to the distance the read or
+ * write pointer moves for them.
+ * @param buffer Buffer.
+ * @param bytes Number of bytes, whole frames for planar streams.
+ * @return Pointer increment in bytes.
+ */
+static inline uint32_t audio_stream_ptr_bytes(const struct audio_stream *buffer,
+					      uint32_t bytes)
+{
+	if (audio_stream_is_planar(buffer))
+		return bytes / buffer->channels;
+
+	return bytes;
+}
+
+/**
+ * Sets data layout of the buffer. Read and write pointers are not updated,
+ * the buffer is expected to be reset before use.
+ * @param buffer Buffer.
+ * @param buffer_fmt Layout, enum sof_ipc_buffer_format.
+ */
+static inline void audio_stream_set_buffer_fmt(struct audio_stream *buffer,
+					       uint32_t buffer_fmt)
+{
+	buffer->buffer_fmt = buffer_fmt;
+	buffer->end_addr = (char *)buffer->addr +
+		audio_stream_channel_size(buffer);
+}
+
 /**
  * Applies parameters to the buffer.
  * @param buffer Buffer.
  * @param params Parameters (frame format, rate, number of channels).
  * @return 0 if succeeded, error code otherwise.
+ *
+ * The data layout is kept, it is chosen by the buffer owner with
+ * audio_stream_set_buffer_fmt().
  */
 static inline int audio_stream_set_params(struct audio_stream *buffer,
 					  struct sof_ipc_stream_params *params)
@@ -175,6 +255,7 @@ static inline int audio_stream_set_params(struct audio_stream *buffer,
 	buffer->frame_fmt = params->frame_fmt;
 	buffer->rate = params->rate;
 	buffer->channels = params->channels;
+	audio_stream_set_buffer_fmt(buffer, buffer->buffer_fmt);
 
 	return 0;
 }
@@ -228,6 +309,56 @@ static inline void *audio_stream_wrap(const struct audio_stream *buffer,
 	return ptr;
 }
 
+/**
+ * Retrieves address of the sample of a channel in the frame at the given
+ * read or write pointer.
+ * @param buffer Buffer.
+ * @param ptr Read or write pointer, must point to a frame boundary.
+ * @param ch Channel index.
+ * @return Pointer to the sample.
+ */
+static inline void *audio_stream_channel_ptr(const struct audio_stream *buffer,
+					     const void *ptr, uint32_t ch)
+{
+	if (audio_stream_is_planar(buffer))
+		return (char *)ptr + ch * audio_stream_channel_size(buffer);
+
+	return (char *)ptr + ch * audio_stream_sample_bytes(buffer);
+}
+
+/**
+ * Calculates distance between consecutive samples of a channel.
+ * @param buffer Buffer.
+ * @return Distance in samples, 1 for planar streams.
+ *
+ * Per channel processing can use audio_stream_channel_ptr() and this stride
+ * to handle both layouts with the same code, with contiguous access for
+ * planar streams.
+ */
+static inline uint32_t
+audio_stream_channel_stride(const struct audio_stream *buffer)
+{
+	return audio_stream_is_planar(buffer) ? 1 : buffer->channels;
+}
+
+/**
+ * Calculates data in the buffer in bytes from the produced and consumed
+ * byte counts. When the producer has overwritten unread data the buffer
+ * is full.
+ * @param stream Stream pointer
+ * @return amount of written and not yet read data in bytes
+ */
+static inline uint32_t
+audio_stream_get_data_bytes(const struct audio_stream *stream)
+{
+	uint32_t data = stream->produced - stream->consumed;
+
+	/* the data is accessed only after the counters were read */
+	barrier_acquire();
+
+	return MIN(data, stream->size);
+}
+
 /**
  * Calculates available data in bytes, handling underrun_permitted behaviour
  * @param stream Stream pointer
@@ -236,6 +367,8 @@ static inline void *audio_stream_wrap(const struct audio_stream *buffer,
 static inline uint32_t
 audio_stream_get_avail_bytes(const struct audio_stream *stream)
 {
+	uint32_t avail = audio_stream_get_data_bytes(stream);
+
 	/*
 	 * In case of underrun-permitted stream, report buffer full instead of
 	 * empty. This way, any data present in such stream is processed at
@@ -243,9 +376,9 @@ audio_stream_get_avail_bytes(const struct audio_stream *stream)
 	 * clients, and in turn will not cause underrun/XRUN.
 	 */
 	if (stream->underrun_permitted)
-		return stream->avail != 0 ? stream->avail : stream->size;
+		return avail != 0 ? avail : stream->size;
 
-	return stream->avail;
+	return avail;
 }
 
 /**
@@ -280,6 +413,8 @@ audio_stream_get_avail_frames(const struct audio_stream *stream)
 static inline uint32_t
 audio_stream_get_free_bytes(const struct audio_stream *stream)
 {
+	uint32_t free = stream->size - audio_stream_get_data_bytes(stream);
+
 	/*
 	 * In case of overrun-permitted stream, report buffer empty instead of
 	 * full. This way, if there's any actual free space for data it is
@@ -287,9 +422,9 @@ audio_stream_get_free_bytes(const struct audio_stream *stream)
 	 * completely full by clients, and in turn will not cause overrun/XRUN.
 	 */
 	if (stream->overrun_permitted)
-		return stream->free != 0 ? stream->free : stream->size;
+		return free != 0 ? free : stream->size;
 
-	return stream->free;
+	return free;
 }
 
 /**
@@ -382,55 +517,88 @@ audio_stream_avail_frames(const struct audio_stream *source,
 }
 
 /**
- * Updates the buffer state after writing to the buffer.
+ * Updates the write position after writing to the buffer. Only the producer
+ * state is modified, so the consumer may run at the same time on another
+ * core. Data overwritten before it was read is skipped by the consumer in
+ * audio_stream_consume().
+ * @param buffer Buffer to update.
+ * @param bytes Number of written bytes.
+ */
+static inline void audio_stream_produce_shared(struct audio_stream *buffer,
+					       uint32_t bytes)
+{
+	buffer->w_ptr = audio_stream_wrap(buffer, (char *)buffer->w_ptr +
+					  audio_stream_ptr_bytes(buffer, bytes));
+
+	/* the written data must be visible before the consumer sees it */
+	barrier_release();
+	buffer->produced += bytes;
+}
+
+/**
+ * Updates the buffer state after writing to the buffer. On overrun also the
+ * consumer state is modified, so this is only for buffers whose producer
+ * and consumer run on the same core.
  * @param buffer Buffer to update.
  * @param bytes Number of written bytes.
  */
 static inline void audio_stream_produce(struct audio_stream *buffer,
 					uint32_t bytes)
 {
-	buffer->w_ptr = audio_stream_wrap(buffer,
-					  (char *)buffer->w_ptr + bytes);
+	bool overwrite = bytes > audio_stream_get_free_bytes(buffer);
+	uint32_t data = audio_stream_get_data_bytes(buffer) + bytes;
+
+	audio_stream_produce_shared(buffer, bytes);
 
 	/* "overwrite" old data in circular wrap case */
-	if (bytes > audio_stream_get_free_bytes(buffer))
+	if (overwrite) {
 		buffer->r_ptr = buffer->w_ptr;
-
-	/* calculate available bytes */
-	if (buffer->r_ptr < buffer->w_ptr)
-		buffer->avail = (char *)buffer->w_ptr - (char *)buffer->r_ptr;
-	else if (buffer->r_ptr == buffer->w_ptr)
-		buffer->avail = buffer->size; /* full */
-	else
-		buffer->avail = buffer->size -
-			((char *)buffer->r_ptr - (char *)buffer->w_ptr);
-
-	/* calculate free bytes */
-	buffer->free = buffer->size - buffer->avail;
+		buffer->consumed = buffer->produced - buffer->size;
+	} else if (data > buffer->size) {
+		/* overrun permitted, the read position is kept */
+		buffer->consumed = buffer->produced - (data - buffer->size);
+	}
 }
 
 /**
- * Updates the buffer state after reading from the buffer.
+ * Updates the buffer state after reading from the buffer. Only the consumer
+ * state is modified.
  * @param buffer Buffer to update.
  * @param bytes Number of read bytes.
  */
 static inline void audio_stream_consume(struct audio_stream *buffer,
 					uint32_t bytes)
 {
-	buffer->r_ptr = audio_stream_wrap(buffer,
-					  (char *)buffer->r_ptr + bytes);
+	uint32_t produced = buffer->produced;
+	uint32_t data = produced - buffer->consumed;
+	uint32_t skip;
+
+	/* don't read ahead of the producer count */
+	barrier_acquire();
+
+	/* move to the oldest data if the producer has overwritten it */
+	if (data > buffer->size) {
+		skip = data - buffer->size;
+		skip = audio_stream_ptr_bytes(buffer, skip % buffer->size);
+		buffer->r_ptr = audio_stream_wrap(buffer,
+						  (char *)buffer->r_ptr + skip);
+		data = buffer->size;
+	}
 
-	/* calculate available bytes */
-	if (buffer->r_ptr < buffer->w_ptr)
-		buffer->avail = (char *)buffer->w_ptr - (char *)buffer->r_ptr;
-	else if (buffer->r_ptr == buffer->w_ptr)
-		buffer->avail = 0; /* empty */
-	else
-		buffer->avail = buffer->size -
-			((char *)buffer->r_ptr - (char *)buffer->w_ptr);
+	buffer->r_ptr = audio_stream_wrap(buffer, (char *)buffer->r_ptr +
+					  audio_stream_ptr_bytes(buffer, bytes));
+
+	/* reading past the written data continues with the old data */
+	if (bytes > data) {
+		skip = (bytes - data) % buffer->size;
+		data = skip ? buffer->size - skip : 0;
+	} else {
+		data -= bytes;
+	}
 
-	/* calculate free bytes */
-	buffer->free = buffer->size - buffer->avail;
+	/* the read data must not be overwritten before it was read */
+	barrier_release();
+	buffer->consumed = produced - data;
 }
 
 /**
@@ -443,11 +611,9 @@ static inline void audio_stream_reset(struct audio_stream *buffer)
 	buffer->w_ptr = buffer->addr;
 	buffer->r_ptr = buffer->addr;
 
-	/* free space is buffer size */
-	buffer->free = buffer->size;
-
-	/* there are no avail samples at reset */
-	buffer->avail = 0;
+	/* no data is produced or consumed at reset */
+	buffer->produced = 0;
+	buffer->consumed = 0;
 }
 
 /**
@@ -461,7 +627,8 @@ static inline void audio_stream_init(struct audio_stream *buffer,
 {
 	buffer->size = size;
 	buffer->addr = buff_addr;
-	buffer->end_addr = (char *)buffer->addr + size;
+	buffer->end_addr = (char *)buffer->addr +
+		audio_stream_channel_size(buffer);
 	audio_stream_reset(buffer);
 }
 
@@ -474,18 +641,29 @@ static inline void audio_stream_init(struct audio_stream *buffer,
 static inline void audio_stream_invalidate(struct audio_stream *buffer,
 					   uint32_t bytes)
 {
-	uint32_t head_size = bytes;
+	uint32_t planes = audio_stream_is_planar(buffer) ? buffer->channels : 1;
+	uint32_t head_size = audio_stream_ptr_bytes(buffer, bytes);
 	uint32_t tail_size = 0;
+	uint32_t i;
+	void *head;
+	void *tail;
 
 	/* check for potential wrap */
-	if ((char *)buffer->r_ptr + bytes > (char *)buffer->end_addr) {
-		head_size = (char *)buffer->end_addr - (char *)buffer->r_ptr;
-		tail_size = bytes - head_size;
+	if ((char *)buffer->r_ptr + head_size > (char *)buffer->end_addr) {
+		tail_size = head_size -
+			((char *)buffer->end_addr - (char *)buffer->r_ptr);
+		head_size -= tail_size;
 	}
 
-	dcache_invalidate_region(buffer->r_ptr, head_size);
-	if (tail_size)
-		dcache_invalidate_region(buffer->addr, tail_size);
+	/* planar data is in the same range of each channel ring */
+	for (i = 0; i < planes; i++) {
+		head = audio_stream_channel_ptr(buffer, buffer->r_ptr, i);
+		tail = audio_stream_channel_ptr(buffer, buffer->addr, i);
+
+		dcache_invalidate_region(head, head_size);
+		if (tail_size)
+			dcache_invalidate_region(tail, tail_size);
+	}
 }
 
 /**
@@ -497,18 +675,29 @@ static inline void audio_stream_invalidate(struct audio_stream *buffer,
 static inline void audio_stream_writeback(struct audio_stream *buffer,
 					  uint32_t bytes)
 {
-	uint32_t head_size = bytes;
+	uint32_t planes = audio_stream_is_planar(buffer) ? buffer->channels : 1;
+	uint32_t head_size = audio_stream_ptr_bytes(buffer, bytes);
 	uint32_t tail_size = 0;
+	uint32_t i;
+	void *head;
+	void *tail;
 
 	/* check for potential wrap */
-	if ((char *)buffer->w_ptr + bytes > (char *)buffer->end_addr) {
-		head_size = (char *)buffer->end_addr - (char *)buffer->w_ptr;
-		tail_size = bytes - head_size;
+	if ((char *)buffer->w_ptr + head_size > (char *)buffer->end_addr) {
+		tail_size = head_size -
+			((char *)buffer->end_addr - (char *)buffer->w_ptr);
+		head_size -= tail_size;
 	}
 
-	dcache_writeback_region(buffer->w_ptr, head_size);
-	if (tail_size)
-		dcache_writeback_region(buffer->addr, tail_size);
+	/* planar data is in the same range of each channel ring */
+	for (i = 0; i < planes; i++) {
+		head = audio_stream_channel_ptr(buffer, buffer->w_ptr, i);
+		tail = audio_stream_channel_ptr(buffer, buffer->addr, i);
+
+		dcache_writeback_region(head, head_size);
+		if (tail_size)
+			dcache_writeback_region(tail, tail_size);
+	}
 }
 
 /**
@@ -540,11 +729,183 @@ audio_stream_frames_without_wrap(const struct audio_stream *source,
 	uint32_t bytes = audio_stream_bytes_without_wrap(source, ptr);
 	uint32_t frame_bytes = audio_stream_frame_bytes(source);
 
-	return bytes / frame_bytes;
+	return bytes / audio_stream_ptr_bytes(source, frame_bytes);
+}
+
+/**
+ * @brief Calculates numbers of s16 samples to buffer wrap.
+ * @param source Stream to get information from.
+ * @param ptr Read or write pointer from source
+ * @return Number of data s16 samples to buffer wrap.
+ */
+static inline uint32_t
+audio_stream_samples_without_wrap_s16(const struct audio_stream *source,
+				      const void *ptr)
+{
+	return audio_stream_bytes_without_wrap(source, ptr) >> 1;
+}
+
+/**
+ * @brief Calculates numbers of s32 samples to buffer wrap.
+ * @param source Stream to get information from.
+ * @param ptr Read or write pointer from source
+ * @return Number of data s32 samples to buffer wrap.
+ */
+static inline uint32_t
+audio_stream_samples_without_wrap_s32(const struct audio_stream *source,
+				      const void *ptr)
+{
+	return audio_stream_bytes_without_wrap(source, ptr) >> 2;
+}
+
+/**
+ * @brief Calculates the largest contiguous run (span) in bytes that can be
+ *	  read from source and written to sink without wrapping either of
+ *	  the pointers.
+ * @param source Source stream.
+ * @param src Read pointer in source.
+ * @param sink Sink stream.
+ * @param snk Write pointer in sink.
+ * @param bytes Number of bytes still to be processed.
+ * @return Number of bytes in the span, at most bytes.
+ *
+ * Processing functions are expected to loop over spans, handle each one
+ * with plain pointer arithmetic and wrap the pointers with
+ * audio_stream_wrap() only once per span, instead of wrapping every single
+ * sample with audio_stream_read_frag()/audio_stream_write_frag().
+ */
+static inline uint32_t audio_stream_span_bytes(const struct audio_stream *source,
+					       const void *src,
+					       const struct audio_stream *sink,
+					       const void *snk, uint32_t bytes)
+{
+	uint32_t bytes_src = audio_stream_bytes_without_wrap(source, src);
+	uint32_t bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
+
+	return MIN(bytes, MIN(bytes_src, bytes_snk));
 }
 
 /**
- * Copies data from source buffer to sink buffer.
+ * @brief Calculates the span in s16 samples for source and sink of the same
+ *	  sample format.
+ * @param source Source stream.
+ * @param src Read pointer in source.
+ * @param sink Sink stream.
+ * @param snk Write pointer in sink.
+ * @param samples Number of samples still to be processed.
+ * @return Number of samples in the span, at most samples.
+ *
+ * @see audio_stream_span_bytes().
+ */
+static inline uint32_t
+audio_stream_span_samples_s16(const struct audio_stream *source,
+			      const void *src,
+			      const struct audio_stream *sink,
+			      const void *snk, uint32_t samples)
+{
+	uint32_t n_src = audio_stream_samples_without_wrap_s16(source, src);
+	uint32_t n_snk = audio_stream_samples_without_wrap_s16(sink, snk);
+
+	return MIN(samples, MIN(n_src, n_snk));
+}
+
+/**
+ * @brief Calculates the span in s32 samples for source and sink of the same
+ *	  sample format.
+ * @param source Source stream.
+ * @param src Read pointer in source.
+ * @param sink Sink stream.
+ * @param snk Write pointer in sink.
+ * @param samples Number of samples still to be processed.
+ * @return Number of samples in the span, at most samples.
+ *
+ * @see audio_stream_span_bytes().
+ */
+static inline uint32_t
+audio_stream_span_samples_s32(const struct audio_stream *source,
+			      const void *src,
+			      const struct audio_stream *sink,
+			      const void *snk, uint32_t samples)
+{
+	uint32_t n_src = audio_stream_samples_without_wrap_s32(source, src);
+	uint32_t n_snk = audio_stream_samples_without_wrap_s32(sink, snk);
+
+	return MIN(samples, MIN(n_src, n_snk));
+}
+
+/**
+ * @brief Calculates the span in frames that can be read from source and
+ *	  written to sink without wrapping either of the pointers. Source and
+ *	  sink may have different frame formats and channel counts.
+ * @param source Source stream.
+ * @param src Read pointer in source, must point to a frame boundary.
+ * @param sink Sink stream.
+ * @param snk Write pointer in sink, must point to a frame boundary.
+ * @param frames Number of frames still to be processed.
+ * @return Number of frames in the span, at most frames.
+ *
+ * @see audio_stream_span_bytes().
+ */
+static inline uint32_t
+audio_stream_span_frames(const struct audio_stream *source, const void *src,
+			 const struct audio_stream *sink, const void *snk,
+			 uint32_t frames)
+{
+	uint32_t n_src = audio_stream_frames_without_wrap(source, src);
+	uint32_t n_snk = audio_stream_frames_without_wrap(sink, snk);
+
+	return MIN(frames, MIN(n_src, n_snk));
+}
+
+/**
+ * Copies whole frames between buffers of different layout channel by
+ * channel, used by audio_stream_copy().
+ * @param source Source buffer.
+ * @param src Read pointer in source.
+ * @param sink Sink buffer.
+ * @param snk Write pointer in sink.
+ * @param frames Number of frames to copy.
+ */
+static inline void audio_stream_copy_frames(const struct audio_stream *source,
+					    char *src,
+					    const struct audio_stream *sink,
+					    char *snk, uint32_t frames)
+{
+	int ssize = audio_stream_sample_bytes(source);
+	int src_step = audio_stream_channel_stride(source) * ssize;
+	int snk_step = audio_stream_channel_stride(sink) * ssize;
+	uint32_t n;
+	uint32_t ch;
+	uint32_t i;
+	char *x;
+	char *y;
+
+	while (frames) {
+		n = audio_stream_span_frames(source, src, sink, snk, frames);
+		for (ch = 0; ch < source->channels; ch++) {
+			x = audio_stream_channel_ptr(source, src, ch);
+			y = audio_stream_channel_ptr(sink, snk, ch);
+			for (i = 0; i < n; i++) {
+				if (ssize == sizeof(int16_t))
+					*(int16_t *)y = *(int16_t *)x;
+				else
+					*(int32_t *)y = *(int32_t *)x;
+
+				x += src_step;
+				y += snk_step;
+			}
+		}
+
+		frames -= n;
+		src = audio_stream_wrap(source, src + n * src_step);
+		snk = audio_stream_wrap(sink, snk + n * snk_step);
+	}
+}
+
+/**
+ * Copies data from source buffer to sink buffer. Buffers of different
+ * layout are copied in whole frames, see pcm_convert_planar() for copy
+ * between formats.
  * @param source Source buffer.
  * @param ioffset Offset (in samples) in source buffer to start reading from.
  * @param sink Sink buffer.
@@ -558,23 +919,36 @@ static inline int audio_stream_copy(const struct audio_stream *source,
 				     uint32_t ooffset, uint32_t samples)
 {
 	int ssize = audio_stream_sample_bytes(source); /* src fmt == sink fmt */
-	void *src = audio_stream_wrap(source,
-				      (char *)source->r_ptr + ioffset * ssize);
-	void *snk = audio_stream_wrap(sink,
-				      (char *)sink->w_ptr + ooffset * ssize);
-	uint32_t bytes = samples * ssize;
-	uint32_t bytes_src;
-	uint32_t bytes_snk;
+	uint32_t planes = audio_stream_is_planar(sink) ? sink->channels : 1;
+	void *src = audio_stream_wrap(source, (char *)source->r_ptr +
+				      audio_stream_ptr_bytes(source,
+							     ioffset * ssize));
+	void *snk = audio_stream_wrap(sink, (char *)sink->w_ptr +
+				      audio_stream_ptr_bytes(sink,
+							     ooffset * ssize));
+	uint32_t bytes = audio_stream_ptr_bytes(sink, samples * ssize);
 	uint32_t bytes_copied;
+	uint32_t i;
 	int ret;
 
-	while (bytes) {
-		bytes_src = audio_stream_bytes_without_wrap(source, src);
-		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
-		bytes_copied = MIN(bytes, MIN(bytes_src, bytes_snk));
+	if (audio_stream_is_planar(source) != audio_stream_is_planar(sink)) {
+		audio_stream_copy_frames(source, src, sink, snk,
+					 samples / source->channels);
+		return samples;
+	}
 
-		ret = memcpy_s(snk, bytes_snk, src, bytes_copied);
-		assert(!ret);
+	while (bytes) {
+		bytes_copied = audio_stream_span_bytes(source, src, sink, snk,
+						       bytes);
+
+		for (i = 0; i < planes; i++) {
+			ret = memcpy_s(audio_stream_channel_ptr(sink, snk, i),
+				       audio_stream_bytes_without_wrap(sink,
+								       snk),
+				       audio_stream_channel_ptr(source, src, i),
+				       bytes_copied);
+			assert(!ret);
+		}
 
 		bytes -= bytes_copied;
 		src = (char *)src + bytes_copied;
@@ -31,6 +31,7 @@
 #include <stdint.h>
 
 struct comp_dev;
+struct mm_usage;
 
 /** \name Trace macros
  *  @{
@@ -105,9 +106,14 @@ struct comp_buffer {
 	/* lists */
 	struct list_item source_list;	/* list in comp buffers */
 	struct list_item sink_list;	/* list in comp buffers */
+	struct list_item cb_list;	/* notifier subscriptions */
+
+	struct mm_usage *mem_usage;	/* allocations of the buffer */
 
 	/* runtime stream params */
-	uint32_t buffer_fmt;	/**< enum sof_ipc_buffer_format */
+	uint32_t buffer_fmt;	/**< requested enum sof_ipc_buffer_format,
+				  *  used layout is in stream
+				  */
 	uint16_t chmap[SOF_IPC_MAX_CHANNELS];	/**< channel map - SOF_CHMAP_ */
 
 	bool hw_params_configured; /**< indicates whether hw params were set */
@@ -188,6 +194,32 @@ static inline void buffer_writeback(struct comp_buffer *buffer, uint32_t bytes)
 	audio_stream_writeback(&buffer->stream, bytes);
 }
 
+/**
+ * Refreshes the stream state written by the other end of an inter core
+ * buffer. The read and write positions have a single writer each, so
+ * available and free bytes can be read after this without locking.
+ */
+static inline void buffer_state_invalidate(struct comp_buffer *buffer)
+{
+	if (!buffer->inter_core)
+		return;
+
+	dcache_invalidate_region(buffer, sizeof(*buffer));
+}
+
+/**
+ * Publishes the stream state modified by this end of an inter core buffer.
+ * Only the cache lines written by this core are dirty, so the state owned
+ * by the other end is not overwritten.
+ */
+static inline void buffer_state_writeback(struct comp_buffer *buffer)
+{
+	if (!buffer->inter_core)
+		return;
+
+	dcache_writeback_region(buffer, sizeof(*buffer));
+}
+
 /**
  * Locks buffer instance for buffers connecting components
  * running on different cores. Buffer parameters will be invalidated
@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_COEF_STORE_H__
+#define __SOF_AUDIO_COEF_STORE_H__
+
+#include <sof/list.h>
+#include <sof/spinlock.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct sof;
+
+/** \brief Types of tables derived from stored coefficient blobs. */
+enum coef_store_type {
+	COEF_STORE_BLOB = 0,		/**< coefficient blob, keyed by content */
+	COEF_STORE_FFT_PLAN,		/**< struct fft_plan and its tables */
+	COEF_STORE_FIR_FFT,		/**< struct fir_fft_coef and spectra */
+	COEF_STORE_LR4,			/**< LR4 biquad pair */
+};
+
+/** \brief Store of read-only coefficient data shared by components. */
+struct coef_store {
+	spinlock_t lock;		/**< protects list and reference counts */
+	struct list_item list;		/**< list of stored entries */
+};
+
+/**
+ * Initializes the coefficient store.
+ *
+ * @param sof Firmware context
+ */
+void coef_store_init(struct sof *sof);
+
+/**
+ * Adds a fully written coefficient blob to the store. If an identical blob is
+ * already stored, the given blob is freed and the stored one is returned with
+ * its reference count increased. The returned data must not be modified and
+ * is released with coef_store_put().
+ *
+ * @param data Blob allocated with rballoc() or rzalloc()
+ * @param size Blob size in bytes
+ */
+void *coef_store_adopt(void *data, size_t size);
+
+/**
+ * Returns a table derived from coefficients. Tables are shared when the
+ * source is within a stored blob and type and param match, otherwise the
+ * table is allocated and initialized with init(data, ctx). Tables with NULL
+ * source depend only on the param and are always shared.
+ *
+ * @param src Source coefficients within a blob from coef_store_adopt()
+ * @param type Type of the derived table
+ * @param param Parameter the table depends on in addition to the source
+ * @param size Table size in bytes
+ * @param init Function to compute the table
+ * @param ctx Context for init
+ */
+void *coef_store_derive(const void *src, enum coef_store_type type,
+			uint32_t param, size_t size,
+			void (*init)(void *data, void *ctx), void *ctx);
+
+/**
+ * Takes another reference to a stored blob or table, released with
+ * coef_store_put().
+ *
+ * @param data Data from coef_store_adopt() or coef_store_derive()
+ * @return data or NULL if the data is not in the store
+ */
+void *coef_store_get(void *data);
+
+/**
+ * Releases blob or table. Data unknown to the store is freed directly.
+ *
+ * @param data Data from coef_store_adopt() or coef_store_derive()
+ */
+void coef_store_put(void *data);
+
+#endif /* __SOF_AUDIO_COEF_STORE_H__ */
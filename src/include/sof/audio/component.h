@@ -19,6 +19,7 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/bit.h>
 #include <sof/debug/panic.h>
 #include <sof/drivers/idc.h>
 #include <sof/list.h>
@@ -43,6 +44,7 @@
 #include <stdint.h>
 
 struct comp_dev;
+struct mm_usage;
 struct sof_ipc_dai_config;
 struct sof_ipc_stream_posn;
 struct dai_hw_params;
@@ -116,6 +118,12 @@ struct dai_hw_params;
 #define COMP_ATTR_HOST_BUFFER	1	/**< Comp host buffer attribute */
 /** @}*/
 
+/** \name Component driver capabilities
+ *  @{
+ */
+#define COMP_CAPS_PLANAR	BIT(0)	/**< Handles non-interleaved buffers */
+/** @}*/
+
 /** \name Trace macros
  *  @{
  */
@@ -388,6 +396,7 @@ struct comp_driver {
 	uint32_t type;			/**< SOF_COMP_ for driver */
 	const struct sof_uuid *uid;	/**< Address to UUID value */
 	struct tr_ctx *tctx;		/**< Pointer to trace context */
+	uint32_t caps;			/**< COMP_CAPS_ flags */
 	struct comp_ops ops;		/**< component operations */
 };
 
@@ -442,6 +451,8 @@ struct comp_dev {
 	/* private data - core does not touch this */
 	void *priv_data;	/**< private data */
 
+	struct mm_usage *mem_usage;	/**< allocations of the component */
+
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
 #endif
@@ -702,8 +713,9 @@ void comp_get_copy_limits(struct comp_buffer *source, struct comp_buffer *sink,
 			  struct comp_copy_limits *cl);
 
 /**
- * Version of comp_get_copy_limits that locks both buffers to guarantee
- * consistent state readings.
+ * Version of comp_get_copy_limits that refreshes the state of both buffers
+ * to guarantee current state readings. No lock is needed since the read and
+ * write positions of a buffer have a single writer each.
  *
  * @param[in] source Source buffer.
  * @param[in] sink Sink buffer
@@ -714,16 +726,10 @@ void comp_get_copy_limits_with_lock(struct comp_buffer *source,
 				    struct comp_buffer *sink,
 				    struct comp_copy_limits *cl)
 {
-	uint32_t source_flags = 0;
-	uint32_t sink_flags = 0;
-
-	buffer_lock(source, &source_flags);
-	buffer_lock(sink, &sink_flags);
+	buffer_state_invalidate(source);
+	buffer_state_invalidate(sink);
 
 	comp_get_copy_limits(source, sink, cl);
-
-	buffer_unlock(sink, sink_flags);
-	buffer_unlock(source, source_flags);
 }
 
 /**
@@ -822,6 +828,16 @@ int comp_data_blob_get_cmd(struct comp_data_blob_handler *blob_handler,
  */
 struct comp_data_blob_handler *comp_data_blob_handler_new(struct comp_dev *dev);
 
+/**
+ * Returns new data blob handler for read-only coefficients. Complete blobs
+ * are kept in the coefficient store so identical blobs of several components
+ * are stored once. The component must not modify the blob.
+ *
+ * @param dev Component device
+ */
+struct comp_data_blob_handler *
+comp_data_blob_handler_new_shared(struct comp_dev *dev);
+
 /**
  * Free data blob handler.
  *
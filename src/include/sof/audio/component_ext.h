@@ -43,6 +43,8 @@ struct comp_dev *comp_new(struct sof_ipc_comp *comp);
 /** See comp_ops::free */
 static inline void comp_free(struct comp_dev *dev)
 {
+	struct mm_usage *usage = dev->mem_usage;
+
 	assert(dev->drv->ops.free);
 
 	/* free task if shared component */
@@ -52,6 +54,8 @@ static inline void comp_free(struct comp_dev *dev)
 	}
 
 	dev->drv->ops.free(dev);
+
+	mm_usage_free(usage);
 }
 
 /**
@@ -83,6 +87,7 @@ static inline int comp_params_remote(struct comp_dev *dev,
 static inline int comp_params(struct comp_dev *dev,
 			      struct sof_ipc_stream_params *params)
 {
+	struct mm_usage *prev = mm_usage_use(dev->mem_usage);
 	int ret = 0;
 
 	if (dev->is_shared && !cpu_is_me(dev->comp.core)) {
@@ -99,6 +104,7 @@ static inline int comp_params(struct comp_dev *dev,
 	}
 
 	comp_shared_commit(dev);
+	mm_usage_use(prev);
 
 	return ret;
 }
@@ -123,6 +129,7 @@ static inline int comp_cmd(struct comp_dev *dev, int cmd, void *data,
 			   int max_data_size)
 {
 	struct sof_ipc_ctrl_data *cdata = data;
+	struct mm_usage *prev;
 	int ret = -EINVAL;
 
 	if (cmd == COMP_CMD_SET_DATA &&
@@ -133,8 +140,10 @@ static inline int comp_cmd(struct comp_dev *dev, int cmd, void *data,
 		goto out;
 	}
 
+	prev = mm_usage_use(dev->mem_usage);
 	if (dev->drv->ops.cmd)
 		ret = dev->drv->ops.cmd(dev, cmd, data, max_data_size);
+	mm_usage_use(prev);
 
 out:
 	comp_shared_commit(dev);
@@ -181,6 +190,7 @@ static inline int comp_prepare_remote(struct comp_dev *dev)
 /** See comp_ops::prepare */
 static inline int comp_prepare(struct comp_dev *dev)
 {
+	struct mm_usage *prev = mm_usage_use(dev->mem_usage);
 	int ret = 0;
 
 	if (dev->drv->ops.prepare)
@@ -188,6 +198,7 @@ static inline int comp_prepare(struct comp_dev *dev)
 			comp_prepare_remote(dev) : dev->drv->ops.prepare(dev);
 
 	comp_shared_commit(dev);
+	mm_usage_use(prev);
 
 	return ret;
 }
@@ -240,6 +251,7 @@ static inline int comp_reset_remote(struct comp_dev *dev)
  */
 static inline int comp_reset(struct comp_dev *dev)
 {
+	struct mm_usage *prev = mm_usage_use(dev->mem_usage);
 	int ret = 0;
 
 	if (dev->drv->ops.reset)
@@ -247,6 +259,7 @@ static inline int comp_reset(struct comp_dev *dev)
 			comp_reset_remote(dev) : dev->drv->ops.reset(dev);
 
 	comp_shared_commit(dev);
+	mm_usage_use(prev);
 
 	return ret;
 }
@@ -255,12 +268,14 @@ static inline int comp_reset(struct comp_dev *dev)
 static inline int comp_dai_config(struct comp_dev *dev,
 				  struct sof_ipc_dai_config *config)
 {
+	struct mm_usage *prev = mm_usage_use(dev->mem_usage);
 	int ret = 0;
 
 	if (dev->drv->ops.dai_config)
 		ret = dev->drv->ops.dai_config(dev, config);
 
 	comp_shared_commit(dev);
+	mm_usage_use(prev);
 
 	return ret;
 }
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <sof/platform.h>
+#include <sof/audio/xfade.h>
 #include <sof/math/iir_df2t.h>
 #include <user/crossover.h>
 
@@ -27,6 +28,9 @@ struct comp_dev;
 /* Number of sinks for a 4 way crossover filter */
 #define CROSSOVER_4WAY_NUM_SINKS 4
 
+/* Number of frames of one channel to split in one block */
+#define CROSSOVER_BLOCK_FRAMES 32
+
 /**
  * The Crossover filter will have from 2 to 4 outputs.
  * Diagram of a 4-way Crossover filter (6 LR4 Filters).
@@ -72,18 +76,33 @@ typedef void (*crossover_process)(const struct comp_dev *dev,
 				  int32_t num_sinks,
 				  uint32_t frames);
 
-typedef void (*crossover_split)(int32_t in, int32_t out[],
-				struct crossover_state *state);
+typedef void (*crossover_split)(const int32_t *in,
+				int32_t out[][CROSSOVER_BLOCK_FRAMES],
+				struct crossover_state *state, int samples);
 
-/* Crossover component private data */
-struct comp_data {
+/**
+ * Filters prepared from one configuration blob. The sets are allocated and
+ * freed in IPC context, copy() only switches to a prepared set.
+ */
+struct crossover_set {
 	/**< filter state */
 	struct crossover_state state[PLATFORM_MAX_CHANNELS];
+	struct sof_crossover_config *config;      /**< referenced setup blob */
+	crossover_split split;                    /**< split function */
+};
+
+/* Crossover component private data */
+struct comp_data {
+	struct crossover_set *set;                /**< filters in use */
+	struct crossover_set *set_new;            /**< filters for copy() */
+	struct crossover_set *set_old;            /**< filters faded out */
+	struct crossover_set *set_done;           /**< faded out, to free */
+	struct xfade xfade;                       /**< fade from set_old */
+	uint32_t xfade_frames;                    /**< fade length */
 	struct sof_crossover_config *config;      /**< pointer to setup blob */
-	struct sof_crossover_config *config_new;  /**< pointer to new setup */
 	enum sof_ipc_frame source_format;         /**< source frame format */
 	crossover_process crossover_process;      /**< processing function */
-	crossover_split crossover_split;          /**< split function */
+	crossover_process crossover_pass;         /**< passthrough function */
 };
 
 struct crossover_proc_fnmap {
@@ -143,13 +162,46 @@ static inline crossover_split crossover_find_split_func(int32_t num_sinks)
 }
 
 /*
- * \brief Runs input in through the LR4 filter and returns it's output.
+ * \brief Runs a block of samples through the LR4 filter. The input and
+ *        output may point to the same memory.
  */
-static inline int32_t crossover_generic_process_lr4(int32_t in,
-						    struct iir_state_df2t *lr4)
+static inline void crossover_generic_process_lr4(const int32_t *in,
+						 int32_t *out, int samples,
+						 struct iir_state_df2t *lr4)
 {
 	/* Cascade two biquads with same coefficients in series. */
-	return iir_df2t(lr4, in);
+	iir_df2t_block(lr4, in, out, samples);
+}
+
+/*
+ * \brief Splits a block of one channel with the filters in use. While a
+ *        coefficient update is faded in the outputs of the previous
+ *        filters are mixed in.
+ *
+ * \param start offset of the block in frames from the start of copy()
+ */
+static inline void crossover_split_block(struct comp_data *cd, int ch,
+					 const int32_t *in,
+					 int32_t out[][CROSSOVER_BLOCK_FRAMES],
+					 int start, int samples)
+{
+	struct crossover_set *set = cd->set;
+	struct crossover_set *old = cd->set_old;
+	int32_t prev[CROSSOVER_4WAY_NUM_SINKS][CROSSOVER_BLOCK_FRAMES];
+	int32_t gain;
+	int i;
+	int j;
+
+	set->split(in, out, &set->state[ch], samples);
+	if (!xfade_active(&cd->xfade))
+		return;
+
+	old->split(in, prev, &old->state[ch], samples);
+	for (i = 0; i < samples; i++) {
+		gain = xfade_gain(&cd->xfade, start + i);
+		for (j = 0; j < set->config->num_sinks; j++)
+			out[j][i] = xfade_mix(prev[j][i], out[j][i], gain);
+	}
 }
 
 #endif //  __SOF_AUDIO_CROSSOVER_CROSSOVER_H__
@@ -43,25 +43,30 @@ static inline float linear_to_decibels(float linear)
 	return 8.6858896380650366f * logf(linear);
 }
 
-static inline float warp_sinf(float x)
+/* sin(pi / 2 * x) for Q2.30 x in range -1.0 .. 1.0, output is Q2.30 */
+static inline int32_t drc_sin_fixed(int32_t x)
 {
-#ifdef DRC_FIXED_SINF
 #define q_v 30
 #define q_multv(a, b) ((int32_t)Q_MULTSR_32X32((int64_t)a, b, q_v, q_v, q_v))
 	const int32_t A7 = Q_CONVERT_FLOAT(-4.3330336920917034149169921875e-3f, q_v);
 	const int32_t A5 = Q_CONVERT_FLOAT(7.9434238374233245849609375e-2f, q_v);
 	const int32_t A3 = Q_CONVERT_FLOAT(-0.645892798900604248046875f, q_v);
 	const int32_t A1 = Q_CONVERT_FLOAT(1.5707910060882568359375f, q_v);
-	int32_t x_fixed = Q_CONVERT_FLOAT(x, q_v);
-	int32_t x2 = q_multv(x_fixed, x_fixed);
+	int32_t x2 = q_multv(x, x);
 	int32_t x4 = q_multv(x2, x2);
 
 	int32_t A3Xx2 = q_multv(A3, x2);
 	int32_t A7Xx2 = q_multv(A7, x2);
 
-	return Q_CONVERT_QTOF(q_multv(x_fixed, (q_multv(x4, (A7Xx2 + A5)) + A3Xx2 + A1)), q_v);
+	return q_multv(x, (q_multv(x4, (A7Xx2 + A5)) + A3Xx2 + A1));
 #undef q_multv
 #undef q_v
+}
+
+static inline float warp_sinf(float x)
+{
+#ifdef DRC_FIXED_SINF
+	return Q_CONVERT_QTOF(drc_sin_fixed(Q_CONVERT_FLOAT(x, 30)), 30);
 #else
 	return sinf(DRC_PI_OVER_TWO_FLOAT * x);
 #endif
@@ -11,6 +11,7 @@
 #include <sof/audio/audio_stream.h>
 #include <sof/audio/format.h>
 #include <sof/math/fir_config.h>
+#include <sof/math/fir_fft.h>
 #if FIR_GENERIC
 #include <sof/math/fir_generic.h>
 #endif
@@ -47,4 +48,22 @@ void eq_fir_2x_s32(struct fir_state_32x16 *fir, const struct audio_stream *sourc
 		   struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S32LE */
 
+/* Partitioned FFT convolution for the channels with response in frequency
+ * domain. The other channels are skipped.
+ */
+#if CONFIG_FORMAT_S16LE
+void eq_fir_fft_s16(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_fft_s24(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_fft_s32(struct fir_fft_state fir[], const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S32LE */
+
 #endif /* __SOF_AUDIO_EQ_FIR_EQ_FIR_H__ */
@@ -13,10 +13,10 @@
 #include <stdint.h>
 
 struct audio_stream;
-struct comp_dev;
+struct iir_state_df2t;
 
 /** \brief Type definition for processing function select return value. */
-typedef void (*eq_iir_func)(const struct comp_dev *dev,
+typedef void (*eq_iir_func)(struct iir_state_df2t *iir,
 			    const struct audio_stream *source,
 			    struct audio_stream *sink,
 			    uint32_t frames);
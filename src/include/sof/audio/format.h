@@ -161,9 +161,34 @@ static inline int32_t sign_extend_s24(int32_t x)
 	return (x << 8) >> 8;
 }
 
+/* packed 24 bit sample, sign extended on load */
+static inline int32_t load_s24_3le(const void *ptr)
+{
+	const uint8_t *p = ptr;
+
+	return sign_extend_s24(p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16));
+}
+
+/* packed 24 bit sample, upper byte of x is dropped on store */
+static inline void store_s24_3le(void *ptr, int32_t x)
+{
+	uint8_t *p = ptr;
+
+	p[0] = x;
+	p[1] = x >> 8;
+	p[2] = x >> 16;
+}
+
 static inline uint32_t get_sample_bytes(enum sof_ipc_frame fmt)
 {
-	return fmt == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return 2;
+	case SOF_IPC_FRAME_S24_3LE:
+		return 3;
+	default:
+		return 4;
+	}
 }
 
 static inline uint32_t get_frame_bytes(enum sof_ipc_frame fmt,
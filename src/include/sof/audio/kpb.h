@@ -31,7 +31,9 @@ struct comp_buffer;
 #define	KPB_SAMPLES_PER_MS (KPB_SAMPLNG_FREQUENCY / 1000)
 #define	KPB_SAMPLNG_FREQUENCY 16000 /**< supported sampling frequency in Hz */
 #define KPB_NUM_OF_CHANNELS 2
-#define KPB_SAMPLE_CONTAINER_SIZE(sw) ((sw == 16) ? 16 : 32)
+/* packed 24 bit samples are the only ones with 24 bit container */
+#define KPB_SAMPLE_CONTAINER_SIZE(sw) \
+	((sw == 16) ? 16 : (sw == 24) ? 24 : 32)
 #define KPB_MAX_BUFFER_SIZE(sw) ((KPB_SAMPLNG_FREQUENCY / 1000) * \
 	(KPB_SAMPLE_CONTAINER_SIZE(sw) / 8) * KPB_MAX_BUFF_TIME * \
 	KPB_NUM_OF_CHANNELS)
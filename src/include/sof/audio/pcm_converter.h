@@ -107,4 +107,40 @@ int pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 			  struct audio_stream *sink, uint32_t ooffset,
 			  uint32_t samples, pcm_converter_lin_func converter);
 
+/**
+ * \brief Convert fixed point data between streams of any layout, used at
+ *	  pipeline boundaries to interleave or deinterleave planar buffers
+ * \param source buffer with samples to process, read pointer is not modified
+ * \param ioffset offset to first sample in source stream, whole frames
+ * \param sink output buffer, write pointer is not modified
+ * \param ooffset offset to first sample in sink stream, whole frames
+ * \param samples number of samples to convert, whole frames
+ * \return error code or number of processed samples
+ */
+int pcm_convert_planar(const struct audio_stream *source, uint32_t ioffset,
+		       struct audio_stream *sink, uint32_t ooffset,
+		       uint32_t samples);
+
+/** \brief Conversions to and from packed 24 bit samples, shared by all
+ *	   converter implementations.
+ */
+int pcm_convert_s16_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+int pcm_convert_s24_3le_to_s16(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+int pcm_convert_s24_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+int pcm_convert_s24_3le_to_s24(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+int pcm_convert_s32_to_s24_3le(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+int pcm_convert_s24_3le_to_s32(const struct audio_stream *source,
+			       uint32_t ioffset, struct audio_stream *sink,
+			       uint32_t ooffset, uint32_t samples);
+
 #endif /* __SOF_AUDIO_PCM_CONVERTER_H__ */
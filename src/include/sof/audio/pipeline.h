@@ -26,6 +26,8 @@ struct comp_buffer;
 struct comp_dev;
 struct ipc;
 struct ipc_msg;
+struct mm_arena;
+struct mm_usage;
 struct sof_ipc_buffer;
 struct sof_ipc_pcm_params;
 struct task;
@@ -89,6 +91,17 @@ extern struct tr_ctx pipe_tr;
 #define PPL_POSN_OFFSETS \
 	(MAILBOX_STREAM_SIZE / sizeof(struct sof_ipc_stream_posn))
 
+/*
+ * Step of the flattened copy schedule. Steps are stored in the order the
+ * components are copied in and parent is the index of the step the graph
+ * walk reached this component from (-1 for the walk start).
+ */
+struct pipeline_step {
+	struct comp_dev *comp;
+	int parent;
+	bool run;	/* set when comp is copied in the current period */
+};
+
 /*
  * Audio pipeline.
  */
@@ -115,6 +128,18 @@ struct pipeline {
 	/* position update */
 	uint32_t posn_offset;		/* position update array offset*/
 	struct ipc_msg *msg;
+
+	/* flattened copy schedule, built when the pipeline is started */
+	struct pipeline_step *steps;
+	uint32_t num_steps;
+	struct comp_dev *steps_start;	/* component the steps start from,
+					 * NULL when the steps are stale
+					 */
+
+	/* memory of component params and prepare, see arena_use() */
+	struct mm_arena *arena;
+	/* allocations of the pipeline and its members */
+	struct mm_usage *mem_usage;
 };
 
 /* static pipeline */
@@ -219,6 +244,17 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 		      struct comp_dev *sink);
 
+/* drop flattened copy schedule after change in pipeline topology */
+void pipeline_steps_free(struct pipeline *p);
+
+/* mark flattened copy schedule stale, the copy walks the graph until the
+ * schedule is rebuilt on the next start
+ */
+static inline void pipeline_steps_invalidate(struct pipeline *p)
+{
+	p->steps_start = NULL;
+}
+
 /* pipeline parameters */
 int pipeline_params(struct pipeline *p, struct comp_dev *cd,
 		    struct sof_ipc_pcm_params *params);
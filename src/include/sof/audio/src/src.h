@@ -8,6 +8,7 @@
 #ifndef __SOF_AUDIO_SRC_SRC_H__
 #define __SOF_AUDIO_SRC_SRC_H__
 
+#include <sof/list.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,6 +27,11 @@ struct src_param {
 	int idx_in;
 	int idx_out;
 	int nch;
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+#if CONFIG_COMP_SRC_RUNTIME
+	struct src_design *design; /* Runtime designed stages if not NULL */
+#endif
 };
 
 struct src_stage {
@@ -122,4 +128,29 @@ int32_t src_input_rates(void);
 
 int32_t src_output_rates(void);
 
+#if CONFIG_COMP_SRC_RUNTIME
+enum src_quality {
+	SRC_QUALITY_LOW = 0,	/* 16 kHz passband at 44.1 kHz, 60 dB stopband */
+	SRC_QUALITY_HIGH,	/* 20 kHz passband at 44.1 kHz, 70 dB stopband */
+};
+
+/* Stages designed at runtime for a conversion */
+struct src_design {
+	struct list_item list;	/* Cache list, most recently used first */
+	int fs_in;
+	int fs_out;
+	enum src_quality quality;
+	int refs;		/* Number of SRC instances using the design */
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+};
+
+void src_design_init(void);
+
+struct src_design *src_design_get(int fs_in, int fs_out,
+				  enum src_quality quality);
+
+void src_design_put(struct src_design *design);
+#endif /* CONFIG_COMP_SRC_RUNTIME */
+
 #endif /* __SOF_AUDIO_SRC_SRC_H__ */
@@ -36,8 +36,17 @@
 #define TDFB_HIFI3	0
 #endif
 
-#define TDFB_IN_BUF_LENGTH (2 * PLATFORM_MAX_CHANNELS)
-#define TDFB_OUT_BUF_LENGTH (2 * PLATFORM_MAX_CHANNELS)
+/* The optimized versions process two frames at a time, the generic
+ * version runs the block FIR for a number of frames.
+ */
+#if TDFB_GENERIC
+#define TDFB_BLOCK_FRAMES 16
+#else
+#define TDFB_BLOCK_FRAMES 2
+#endif
+
+#define TDFB_IN_BUF_LENGTH (TDFB_BLOCK_FRAMES * PLATFORM_MAX_CHANNELS)
+#define TDFB_OUT_BUF_LENGTH (TDFB_BLOCK_FRAMES * PLATFORM_MAX_CHANNELS)
 
 /* TDFB component private data */
 
@@ -46,7 +55,7 @@ struct tdfb_comp_data {
 	struct comp_data_blob_handler *model_handler;
 	struct sof_tdfb_config *config;	    /**< pointer to setup blob */
 	int32_t in[TDFB_IN_BUF_LENGTH];	    /**< input samples buffer */
-	int32_t out[TDFB_IN_BUF_LENGTH];    /**< output samples mix buffer */
+	int32_t out[TDFB_OUT_BUF_LENGTH];   /**< output samples mix buffer */
 	int32_t *fir_delay;		    /**< pointer to allocated RAM */
 	int16_t *input_channel_select;	    /**< For each FIR define in ch */
 	int16_t *output_channel_mix;	    /**< For each FIR define out ch */
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_XFADE_H__
+#define __SOF_AUDIO_XFADE_H__
+
+#include <sof/math/numbers.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct audio_stream;
+
+/** \brief Linear crossfade from previous to new processing output. */
+struct xfade {
+	uint32_t frames;	/**< fade length in frames */
+	uint32_t pos;		/**< frames faded so far */
+	uint32_t step;		/**< gain increment per frame in Q1.31 */
+};
+
+/**
+ * Processes frames from source to sink with one set of coefficients.
+ *
+ * @param ctx Component context
+ * @param set Coefficients and filter state
+ * @param source Source stream, read from r_ptr
+ * @param sink Sink stream, written from w_ptr
+ * @param frames Number of frames
+ */
+typedef void (*xfade_func)(void *ctx, void *set,
+			   const struct audio_stream *source,
+			   struct audio_stream *sink, uint32_t frames);
+
+/**
+ * Returns the length of the coefficient update crossfade.
+ *
+ * @param rate Sample rate in Hz
+ */
+static inline uint32_t xfade_frames(uint32_t rate)
+{
+	return rate * CONFIG_COMP_COEF_XFADE_MS / 1000;
+}
+
+static inline void xfade_start(struct xfade *xf, uint32_t frames)
+{
+	xf->frames = frames;
+	xf->pos = 0;
+	xf->step = frames ? INT32_MAX / frames : 0;
+}
+
+static inline bool xfade_active(const struct xfade *xf)
+{
+	return xf->pos < xf->frames;
+}
+
+static inline void xfade_advance(struct xfade *xf, uint32_t frames)
+{
+	xf->pos = MIN(xf->pos + frames, xf->frames);
+}
+
+/**
+ * Returns the Q1.31 gain of the new output.
+ *
+ * @param xf Crossfade
+ * @param offset Offset in frames from the current position
+ */
+static inline int32_t xfade_gain(const struct xfade *xf, uint32_t offset)
+{
+	uint32_t pos = xf->pos + offset;
+
+	return pos < xf->frames ? pos * xf->step : INT32_MAX;
+}
+
+/**
+ * Mixes previous and new output sample with the gain of the new output.
+ * The result is between the two samples so any sample width can be mixed.
+ */
+static inline int32_t xfade_mix(int32_t prev, int32_t next, int32_t gain)
+{
+	return prev + ((((int64_t)next - prev) * gain) >> 31);
+}
+
+/**
+ * Processes frames with the new coefficients and fades from the output of
+ * the previous ones while the fade is active. The previous output is
+ * computed in blocks to an interleaved work buffer on stack, so func must
+ * handle the layout of the source together with an interleaved sink.
+ *
+ * @param xf Crossfade
+ * @param func Processing function
+ * @param ctx Context for func
+ * @param prev Previous coefficients for func
+ * @param next New coefficients for func
+ * @param source Source stream
+ * @param sink Sink stream
+ * @param frames Number of frames
+ * @param align Frames are processed in multiples of align
+ */
+void xfade_process(struct xfade *xf, xfade_func func, void *ctx,
+		   void *prev, void *next, const struct audio_stream *source,
+		   struct audio_stream *sink, uint32_t frames, uint32_t align);
+
+#endif /* __SOF_AUDIO_XFADE_H__ */
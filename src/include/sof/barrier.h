@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_BARRIER_H__
+#define __SOF_BARRIER_H__
+
+#include <arch/barrier.h>
+
+/* Memory accesses before the barrier complete before the stores after it.
+ * Used before publishing a counter that another core reads.
+ */
+static inline void barrier_release(void)
+{
+	arch_barrier_release();
+}
+
+/* Memory accesses after the barrier are not done before the loads before
+ * it. Used after reading a counter that another core publishes.
+ */
+static inline void barrier_acquire(void)
+{
+	arch_barrier_acquire();
+}
+
+#endif /* __SOF_BARRIER_H__ */
@@ -46,6 +46,9 @@ struct ipc_msg;
 #define COMP_TYPE_BUFFER	2
 #define COMP_TYPE_PIPELINE	3
 
+/* Number of buckets in the component lookup hash tables, power of two */
+#define IPC_COMP_HASH_SIZE	32
+
 /** \brief Scheduling period for IPC task in microseconds. */
 #define IPC_PERIOD_USEC	100
 
@@ -76,6 +79,8 @@ struct ipc_comp_dev {
 
 	/* lists */
 	struct list_item list;		/* list in components */
+	struct list_item hash_list;	/* list in id hash bucket */
+	struct list_item ppl_list;	/* list in pipeline id hash bucket */
 };
 
 struct ipc_msg {
@@ -97,6 +102,10 @@ struct ipc {
 
 	struct list_item comp_list;	/* list of component devices */
 
+	/* component devices hashed by id and by pipeline id */
+	struct list_item comp_hash[IPC_COMP_HASH_SIZE];
+	struct list_item ppl_hash[IPC_COMP_HASH_SIZE];
+
 	/* processing task */
 	struct task ipc_task;
 
@@ -301,6 +310,13 @@ int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id);
 int ipc_comp_connect(struct ipc *ipc,
 	struct sof_ipc_pipe_comp_connect *connect);
 
+/*
+ * Add component device to the component list and lookup tables, and
+ * remove it from them.
+ */
+void ipc_comp_dev_add(struct ipc *ipc, struct ipc_comp_dev *icd);
+void ipc_comp_dev_del(struct ipc_comp_dev *icd);
+
 /*
  * Get component by ID.
  */
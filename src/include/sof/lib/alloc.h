@@ -150,6 +150,74 @@ void rfree(void *ptr);
  */
 void *rzalloc_core_sys(int core, size_t bytes);
 
+/** \brief Owners of heap allocations counted per owner. */
+enum mm_usage_owner {
+	MM_USAGE_COMP = 0,	/**< Component */
+	MM_USAGE_BUFFER,	/**< Buffer */
+	MM_USAGE_PIPELINE,	/**< Pipeline, its components and buffers */
+};
+
+/** \brief Zones counted, runtime shared zone counts as runtime zone. */
+#define MM_USAGE_ZONES	(SOF_MEM_ZONE_BUFFER + 1)
+
+/** \brief Memory used by a component, buffer or pipeline. */
+struct mm_usage_info {
+	uint32_t owner;		/**< enum mm_usage_owner */
+	uint32_t id;		/**< component, buffer or pipeline id */
+	uint32_t pipeline_id;	/**< pipeline of the owner */
+	uint32_t used[MM_USAGE_ZONES];	/**< bytes in use per zone */
+	uint32_t peak[MM_USAGE_ZONES];	/**< most bytes in use per zone */
+};
+
+struct mm_usage;
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+/**
+ * Creates accounting for allocations of an owner. Components and buffers
+ * are charged to the usage of their pipeline too.
+ * @param owner Owner type, see enum mm_usage_owner.
+ * @param id Component, buffer or pipeline id.
+ * @param pipeline_id Pipeline of the owner.
+ * @return Usage or NULL if failed.
+ */
+struct mm_usage *mm_usage_new(enum mm_usage_owner owner, uint32_t id,
+			      uint32_t pipeline_id);
+
+/**
+ * Frees the usage. It stays listed until blocks charged to it are freed.
+ * @param usage Usage, may be NULL.
+ */
+void mm_usage_free(struct mm_usage *usage);
+
+/**
+ * Charges heap allocations of the current core to the usage.
+ * @param usage Usage, NULL to stop charging.
+ * @return Usage charged before.
+ */
+struct mm_usage *mm_usage_use(struct mm_usage *usage);
+
+/**
+ * Copies usage of all owners.
+ * @param info Output array, may be NULL if count is 0.
+ * @param count Size of info array.
+ * @return Number of owners, may be more than count.
+ */
+int mm_usage_get(struct mm_usage_info *info, int count);
+#else
+static inline struct mm_usage *mm_usage_new(enum mm_usage_owner owner,
+					    uint32_t id, uint32_t pipeline_id)
+{
+	return NULL;
+}
+
+static inline void mm_usage_free(struct mm_usage *usage) { }
+
+static inline struct mm_usage *mm_usage_use(struct mm_usage *usage)
+{
+	return NULL;
+}
+#endif
+
 /** \brief Zeroes memory block.
  * @param ptr Pointer to the memory block.
  * @param size Size of the block in bytes.
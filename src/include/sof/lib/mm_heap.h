@@ -13,9 +13,12 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
 #include <sof/sof.h>
 #include <sof/spinlock.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -31,6 +34,9 @@ struct block_hdr {
 	uint16_t size;		/* size in blocks for continuous allocation */
 	uint16_t used;		/* usage flags for page */
 	void *unaligned_ptr;	/* align ptr */
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	struct mm_usage *usage;	/* owner the block is charged to */
+#endif
 } __packed;
 
 struct block_map {
@@ -39,6 +45,7 @@ struct block_map {
 	uint16_t free_count;	/* number of free blocks */
 	uint16_t first_free;	/* index of first free block */
 	struct block_hdr *block;	/* base block header */
+	uint32_t *free_bits;	/* bit set for each free block */
 	uint32_t base;		/* base address of space */
 };
 
@@ -55,6 +62,28 @@ struct mm_heap {
 	struct mm_info info;
 };
 
+/* pipeline arena, bump allocated and freed as a whole */
+struct mm_arena {
+	struct list_item list;	/* in arena list of memory map */
+	uint32_t base;		/* arena block, 0 until sized */
+	uint32_t size;		/* size of arena block in bytes */
+	uint32_t caps;		/* caps of heap the block is from */
+	uint32_t top;		/* offset of next allocation */
+	uint32_t live;		/* allocations not freed yet */
+	uint32_t used;		/* bytes requested since arena was fitted */
+	uint32_t peak;		/* most bytes requested between fits */
+	bool orphan;		/* owner is gone, free with last allocation */
+};
+
+/* allocation accounting of an owner */
+struct mm_usage {
+	struct list_item list;	/* in usage list of memory map */
+	struct mm_usage *pipe;	/* usage of pipeline charged too, or NULL */
+	uint32_t live;		/* charged blocks not freed yet */
+	bool orphan;		/* owner is gone, free with last block */
+	struct mm_usage_info info;
+};
+
 /* heap block memory map */
 struct mm {
 	/* system heap - used during init cannot be freed */
@@ -72,6 +101,20 @@ struct mm {
 	/* general component buffer heap */
 	struct mm_heap buffer[PLATFORM_HEAP_BUFFER];
 
+#if CONFIG_PIPELINE_ARENA
+	/* pipeline arenas */
+	struct list_item arena_list;
+	/* arena serving runtime and buffer allocations of each core */
+	struct mm_arena *arena[CONFIG_CORE_COUNT];
+#endif
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	/* usage of components, buffers and pipelines */
+	struct list_item usage_list;
+	/* usage charged for allocations of each core */
+	struct mm_usage *usage[CONFIG_CORE_COUNT];
+#endif
+
 	struct mm_info total;
 	uint32_t heap_trace_updated;	/* updates that can be presented */
 	spinlock_t lock;	/* all allocs and frees are atomic */
@@ -92,6 +135,105 @@ void free_heap(enum mem_zone zone);
 void heap_trace_all(int force);
 void heap_trace(struct mm_heap *heap, int size);
 
+#if CONFIG_PIPELINE_ARENA
+/**
+ * Creates an empty arena. It gets its block on the first arena_fit() after
+ * allocations were requested from it.
+ * @return Arena or NULL if failed.
+ */
+struct mm_arena *arena_new(void);
+
+/**
+ * Frees the arena. The block is released now or with the last allocation
+ * still in use.
+ * @param arena Arena, may be NULL.
+ */
+void arena_free(struct mm_arena *arena);
+
+/**
+ * Serves runtime and buffer zone allocations of the current core from the
+ * arena. Allocations that do not fit fall back to the heap.
+ * @param arena Arena, NULL to allocate from the heap again.
+ */
+void arena_use(struct mm_arena *arena);
+
+/**
+ * Resizes an idle arena to the most bytes requested from it so far.
+ * @param arena Arena, may be NULL.
+ */
+void arena_fit(struct mm_arena *arena);
+#else
+static inline struct mm_arena *arena_new(void) { return NULL; }
+static inline void arena_free(struct mm_arena *arena) { }
+static inline void arena_use(struct mm_arena *arena) { }
+static inline void arena_fit(struct mm_arena *arena) { }
+#endif
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+/* adds bytes to usage and to usage of its pipeline */
+static inline void mm_usage_charge(struct mm_usage *usage, int zone,
+				   int32_t bytes)
+{
+	for (; usage; usage = usage->pipe) {
+		usage->info.used[zone] += bytes;
+		usage->info.peak[zone] = MAX(usage->info.peak[zone],
+					     usage->info.used[zone]);
+	}
+}
+
+/* links new usage with the usage of its pipeline or its members */
+static inline void mm_usage_link(struct list_item *usage_list,
+				 struct mm_usage *usage)
+{
+	struct mm_usage *member;
+	struct list_item *ulist;
+	int i;
+
+	list_for_item(ulist, usage_list) {
+		member = container_of(ulist, struct mm_usage, list);
+
+		if (member == usage || member->orphan ||
+		    member->info.pipeline_id != usage->info.pipeline_id)
+			continue;
+
+		if (usage->info.owner != MM_USAGE_PIPELINE) {
+			if (member->info.owner == MM_USAGE_PIPELINE) {
+				usage->pipe = member;
+				return;
+			}
+			continue;
+		}
+
+		/* pipeline created after its members */
+		if (member->info.owner == MM_USAGE_PIPELINE || member->pipe)
+			continue;
+
+		member->pipe = usage;
+		for (i = 0; i < MM_USAGE_ZONES; i++)
+			mm_usage_charge(usage, i, member->info.used[i]);
+	}
+}
+
+/* stops charging members to the pipeline usage */
+static inline void mm_usage_unlink(struct list_item *usage_list,
+				   struct mm_usage *pipe)
+{
+	struct mm_usage *member;
+	struct list_item *ulist;
+	int i;
+
+	list_for_item(ulist, usage_list) {
+		member = container_of(ulist, struct mm_usage, list);
+		if (member->pipe != pipe)
+			continue;
+
+		member->pipe = NULL;
+		for (i = 0; i < MM_USAGE_ZONES; i++)
+			mm_usage_charge(pipe, i, -(int32_t)member->info.used[i]);
+	}
+}
+#endif
+
 #if CONFIG_DEBUG_MEMORY_USAGE_SCAN
 /** Fetch runtime information about heap, like used and free memory space
  * @param zone to check, see enum mem_zone.
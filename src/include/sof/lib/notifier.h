@@ -11,6 +11,7 @@
 #include <sof/bit.h>
 #include <sof/list.h>
 #include <sof/sof.h>
+#include <sof/spinlock.h>
 #include <stdint.h>
 
 /* notifier target core masks */
@@ -26,6 +27,7 @@ enum notify_id {
 	NOTIFIER_ID_SSP_FREQ,			/* struct clock_notify_data * */
 	NOTIFIER_ID_KPB_CLIENT_EVT,		/* struct kpb_event_data * */
 	NOTIFIER_ID_DMA_DOMAIN_CHANGE,		/* struct dma_chan_data * */
+	/* buffer events are delivered to the buffer's own subscribers */
 	NOTIFIER_ID_BUFFER_PRODUCE,		/* struct buffer_cb_transact* */
 	NOTIFIER_ID_BUFFER_CONSUME,		/* struct buffer_cb_transact* */
 	NOTIFIER_ID_BUFFER_FREE,		/* struct buffer_cb_free* */
@@ -63,6 +65,33 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 void notifier_unregister(void *receiver, void *caller, enum notify_id type);
 void notifier_unregister_all(void *receiver, void *caller);
 
+/*
+ * Subscriptions to events of a single object. The list head is embedded in
+ * the object and guarded by the object's shared lock, since the object may
+ * be processed on another core than the one subscribing. An event is
+ * delivered only to the subscribers of the core raising it and an object
+ * without subscribers costs just the list empty check. The callbacks are
+ * called with the lock held, so they must not change the subscriptions of
+ * the same object.
+ */
+int notifier_obj_register(void *receiver, struct list_item *subscribers,
+			  spinlock_t *lock, enum notify_id type,
+			  void (*cb)(void *arg, enum notify_id type, void *data));
+void notifier_obj_unregister(void *receiver, struct list_item *subscribers,
+			     spinlock_t *lock, enum notify_id type);
+void notifier_obj_unregister_all(void *receiver, struct list_item *subscribers,
+				 spinlock_t *lock);
+void notifier_obj_notify(struct list_item *subscribers, spinlock_t *lock,
+			 enum notify_id type, void *data);
+
+static inline void notifier_obj_event(struct list_item *subscribers,
+				      spinlock_t *lock, enum notify_id type,
+				      void *data)
+{
+	if (!list_is_empty(subscribers))
+		notifier_obj_notify(subscribers, lock, type, data);
+}
+
 void notifier_notify_remote(void);
 void notifier_event(const void *caller, enum notify_id type, uint32_t core_mask,
 		    void *data, uint32_t data_size);
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_FFT_H__
+#define __SOF_MATH_FFT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FFT_SIZE_MIN	2
+#define FFT_SIZE_MAX	4096
+
+/* Complex number with Q1.31 real and imaginary parts */
+struct icomplex32 {
+	int32_t real;
+	int32_t imag;
+};
+
+struct fft_plan {
+	int size;			/* FFT size, power of two */
+	int len;			/* log2 of size */
+	struct icomplex32 *twiddle;	/* size / 2 twiddle factors */
+	uint16_t *bit_reverse_idx;	/* size bit reversed indices */
+};
+
+/* Returns the number of bytes needed for the FFT tables of size points or
+ * -EINVAL if size is not supported.
+ */
+int fft_plan_size(int size);
+
+/* Initializes the plan tables into memory pointed by *data and advances
+ * *data to the end of used memory.
+ */
+int fft_plan_init(struct fft_plan *plan, int size, void **data);
+
+/* Computes in-place the complex FFT of size points. The forward transform
+ * is scaled by 1/size to prevent overflow. The inverse transform is not
+ * scaled so that an inverse of a forward transform returns the original
+ * data. The inverse transform output is saturated.
+ */
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *data,
+		    bool ifft);
+
+#endif /* __SOF_MATH_FFT_H__ */
@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_FIR_FFT_H__
+#define __SOF_MATH_FIR_FFT_H__
+
+#include <sof/math/fft.h>
+#include <user/fir.h>
+#include <stdint.h>
+
+/* Limits for the partition length. The FFT size is two partitions. */
+#define FIR_FFT_BLOCK_MIN	16
+#define FIR_FFT_BLOCK_MAX	(FFT_SIZE_MAX / 2)
+
+/* Max. number of partitions to keep the spectrum accumulation in 64 bits */
+#define FIR_FFT_MAX_PARTITIONS	256
+
+/* Frequency domain response of a FIR filter, uniformly partitioned into
+ * blocks of block taps. The data can be shared by several channels.
+ */
+struct fir_fft_coef {
+	int length;		/* Number of FIR taps */
+	int block;		/* Partition length */
+	int partitions;		/* Number of partitions */
+	int shift;		/* Right shift for accumulated spectrum */
+	struct icomplex32 *h;	/* Partitions spectra, block + 1 bins each */
+};
+
+/* Overlap-save convolution state of one channel */
+struct fir_fft_state {
+	struct fir_fft_coef *coef;	/* Response, NULL if not used */
+	struct fft_plan *plan;		/* FFT of two blocks size */
+	struct icomplex32 *buf;		/* FFT work buffer, can be shared */
+	struct icomplex32 *fdl;		/* Frequency domain delay line */
+	int32_t *in;			/* Input of previous and current block */
+	int32_t *out;			/* Output block */
+	int pos;			/* Sample position in block */
+	int fdl_idx;			/* Index of newest spectrum in fdl */
+};
+
+/* Returns the partition length for processing frames per period */
+int fir_fft_block_length(int frames);
+
+/* Estimated number of multiplications per sample for length taps filter */
+int fir_fft_cost(int length, int block);
+
+void fir_fft_reset(struct fir_fft_state *fir);
+
+int fir_fft_coef_size(struct sof_fir_coef_data *config, int block);
+
+void fir_fft_init_coef(struct fir_fft_coef *coef,
+		       struct sof_fir_coef_data *config, int block,
+		       struct fft_plan *plan, struct icomplex32 *buf,
+		       void **data);
+
+int fir_fft_delay_size(struct sof_fir_coef_data *config, int block);
+
+/* A response without partitions passes the input delayed by the partition
+ * length, to keep unfiltered channels aligned with the filtered ones.
+ */
+void fir_fft_init_bypass(struct fir_fft_coef *coef, int block);
+
+int fir_fft_bypass_delay_size(int block);
+
+void fir_fft_init_delay(struct fir_fft_state *fir, struct fir_fft_coef *coef,
+			struct fft_plan *plan, struct icomplex32 *buf,
+			void **data);
+
+/* Filters samples of Q1.31 data. The output is delayed by the partition
+ * length. The input and output may point to the same memory.
+ */
+void fir_fft_32(struct fir_fft_state *fir, const int32_t *x, int32_t *y,
+		int samples);
+
+#endif /* __SOF_MATH_FIR_FFT_H__ */
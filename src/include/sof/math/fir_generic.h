@@ -42,5 +42,12 @@ void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data);
 
 int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x);
 
+/* Filters a block of frames of interleaved Q1.31 samples with nch
+ * channels. Channel ch is processed with filter fir[ch]. The input and
+ * output may point to the same memory.
+ */
+void fir_32x16_block(struct fir_state_32x16 fir[], const int32_t *x,
+		     int32_t *y, int frames, int nch);
+
 #endif
 #endif /* __SOF_MATH_FIR_GENERIC_H__ */
@@ -60,4 +60,18 @@ struct iir_state_df2t {
 
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+/* Filters a block of samples of Q1.31 data of one channel. The input and
+ * output may point to the same memory.
+ */
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *x, int32_t *y,
+		    int samples);
+
+/* Filters a block of frames of interleaved Q1.31 samples with nch channels.
+ * Channel ch is processed with filter iir[ch]. If all the filters have the
+ * same number of biquads the channels are processed in lock step. The input
+ * and output may point to the same memory.
+ */
+void iir_df2t_block_nch(struct iir_state_df2t iir[], const int32_t *x,
+			int32_t *y, int frames, int nch);
+
 #endif /* __SOF_MATH_IIR_DF2T_H__ */
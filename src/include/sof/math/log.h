@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_LOG_H__
+#define __SOF_MATH_LOG_H__
+
+#include <stdint.h>
+
+#define LOG2_FIXED_OUTPUT_QY 26
+#define EXP2_FIXED_INPUT_QY 26
+#define EXP2_FIXED_OUTPUT_QY 30
+
+/* Base 2 logarithm of unsigned integer x. The output is Q6.26. For
+ * fractional x with q fractional bits subtract q << 26 from the result.
+ * For zero x the function returns INT32_MIN.
+ */
+int32_t log2_fixed(uint32_t x);
+
+/* Base 2 exponent function. Input is Q6.26, output is Q2.30. The results
+ * of 2.0 and above saturate to INT32_MAX.
+ */
+int32_t exp2_fixed(int32_t x);
+
+/* Power function x^y for positive Q2.30 x and Q2.30 y. Output is Q2.30
+ * that saturates like exp2_fixed(). For non-positive x zero is returned.
+ */
+int32_t pow_fixed(int32_t x, int32_t y);
+
+#endif /* __SOF_MATH_LOG_H__ */
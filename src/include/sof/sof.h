@@ -14,6 +14,7 @@
 
 struct cascade_root;
 struct clock_info;
+struct coef_store;
 struct comp_driver_list;
 struct dai_info;
 struct dma_info;
@@ -90,6 +91,9 @@ struct sof {
 	/* list of registered component drivers */
 	struct comp_driver_list *comp_drivers;
 
+	/* shared coefficient blobs and tables */
+	struct coef_store *coef_store;
+
 	/* M/N dividers */
 	struct mn *mn;
 
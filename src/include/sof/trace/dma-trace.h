@@ -8,11 +8,12 @@
 #ifndef __SOF_TRACE_DMA_TRACE_H__
 #define __SOF_TRACE_DMA_TRACE_H__
 
+#include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/schedule/task.h>
 #include <sof/sof.h>
-#include <sof/spinlock.h>
 #include <ipc/trace.h>
+#include <user/trace.h>
 #include <stdint.h>
 
 struct ipc_msg;
@@ -27,6 +28,35 @@ struct dma_trace_buf {
 	uint32_t avail;		/* avail bytes in buffer */
 };
 
+/* Size of the trace ring of each core, power of two */
+#ifndef DMA_TRACE_CORE_SIZE
+#define DMA_TRACE_CORE_SIZE	(DMA_TRACE_LOCAL_SIZE / 2)
+#endif
+
+/* Trace ring of one core. Only the owning core writes the entries and
+ * w_pos, only trace_work() reads them and advances r_pos, so the ring
+ * needs no lock. Each entry is prefixed by its length in bytes.
+ */
+struct dma_trace_core_buf {
+	char *addr;		/* ring base address */
+	uint32_t w_pos;		/* free running write position */
+	uint32_t r_pos;		/* free running read position */
+	uint32_t dropped;	/* amount of entries dropped by the core */
+	uint32_t dropped_logged; /* amount of dropped entries reported */
+};
+
+#if CONFIG_TRACE_COMPACT
+/* State of the compact entry encoder, see user/trace.h */
+struct dma_trace_compact {
+	uint64_t timestamp;	/* timestamp of the previous entry */
+	uint32_t count;		/* entries until the next sync entry */
+	struct {
+		uint32_t uid;
+		uint32_t log_entry_address;
+	} dict[TRACE_COMPACT_DICT_SIZE];
+};
+#endif
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -42,8 +72,10 @@ struct dma_trace_data {
 	uint32_t dma_copy_align; /**< Minimal chunk of data possible to be
 				   *  copied by dma connected to host
 				   */
-	uint32_t dropped_entries; /* amount of dropped entries */
-	spinlock_t lock; /* dma trace lock */
+	struct dma_trace_core_buf cores[CONFIG_CORE_COUNT];
+#if CONFIG_TRACE_COMPACT
+	struct dma_trace_compact compact;
+#endif
 };
 
 int dma_trace_init_early(struct sof *sof);
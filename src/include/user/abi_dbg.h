@@ -19,8 +19,8 @@
 #define __USER_ABI_DBG_H__
 
 #define SOF_ABI_DBG_MAJOR 5
-#define SOF_ABI_DBG_MINOR 2
-#define SOF_ABI_DBG_PATCH 1
+#define SOF_ABI_DBG_MINOR 3
+#define SOF_ABI_DBG_PATCH 0
 
 #define SOF_ABI_DBG_VERSION SOF_ABI_VER(SOF_ABI_DBG_MAJOR, \
 					SOF_ABI_DBG_MINOR, \
@@ -14,7 +14,7 @@
 
 #define SOF_EQ_FIR_IDX_SWITCH	0
 
-#define SOF_EQ_FIR_MAX_SIZE 4096 /* Max size allowed for coef data in bytes */
+#define SOF_EQ_FIR_MAX_SIZE 16384 /* Max size allowed for coef data in bytes */
 
 #define SOF_EQ_FIR_MAX_RESPONSES 8 /* A blob can define max 8 FIR EQs */
 
@@ -35,10 +35,14 @@
  *	       same first defined response and for to channels 4-7 the second.
  *         coef_data[]
  *             Repeated data
- *             { filter_length, output_shift, h[] }
+ *             { filter_length, output_shift, mode, h[] }
  *	       for every EQ response defined where vector h has filter_length
  *             number of coefficients. Coefficients in h[] are in Q1.15 format.
  *             E.g. 16384 (Q1.15) = 0.5. The shifts are number of right shifts.
+ *             The mode selects direct form or partitioned FFT convolution,
+ *             see SOF_FIR_MODE_. The FFT convolution allows filter lengths
+ *             up to SOF_FIR_MAX_LENGTH_FFT but delays the output by the
+ *             partition length, a power of two not less than period.
  *
  * NOTE: The channels_in_config must be even to have coef_data aligned to
  * 32 bit word in RAM. Therefore a mono EQ assign must be duplicated to 2ch
@@ -11,20 +11,27 @@
 #include <stdint.h>
 
 #define SOF_FIR_MAX_LENGTH 256 /* Max length for individual filter */
+#define SOF_FIR_MAX_LENGTH_FFT 4096 /* Max length for FFT based filter */
+
+/* Filter implementation for the response, currently used by EQ FIR only */
+#define SOF_FIR_MODE_AUTO	0 /* Select by length and period */
+#define SOF_FIR_MODE_TIME	1 /* Direct form convolution */
+#define SOF_FIR_MODE_FFT	2 /* Partitioned FFT convolution */
 
 struct sof_fir_coef_data {
 	int16_t length; /* Number of FIR taps */
 	int16_t out_shift; /* Amount of right shifts at output */
+	uint32_t mode; /* SOF_FIR_MODE_ */
 
 	/* reserved */
-	uint32_t reserved[4];
+	uint32_t reserved[3];
 
 	int16_t coef[]; /* FIR coefficients */
 } __attribute__((packed));
 
-/* In the struct above there's two 16 bit words (length, shift) and four
- * reserved 32 bit words before the actual FIR coefficients. This information
- * is used in parsing of the configuration blob.
+/* In the struct above there's two 16 bit words (length, shift), mode and
+ * three reserved 32 bit words before the actual FIR coefficients. This
+ * information is used in parsing of the configuration blob.
  */
 #define SOF_FIR_COEF_NHEADER \
 	(sizeof(struct sof_fir_coef_data) / sizeof(int16_t))
@@ -42,4 +42,38 @@ struct log_entry_header {
 	uint32_t log_entry_address;	 /* Address of log entry in ELF */
 } __attribute__((packed));
 
+/*
+ * Compact log entry, sent instead of the header and arguments when the
+ * firmware is built with CONFIG_TRACE_COMPACT. The entry is a byte stream
+ * padded with zeros to a multiple of uint32_t:
+ *
+ *  u8 tag		TRACE_COMPACT_TAG, arguments count << 1 and
+ *			TRACE_COMPACT_SYNC flag
+ *  u8 core id
+ *  u8 slot		dictionary slot, TRACE_COMPACT_SLOT_HIT if the uid and
+ *			log entry address of the slot are reused
+ *  u32 uid, u32 log entry address	only if not a dictionary hit
+ *  varint timestamp	zigzag delta to the previous entry, absolute in
+ *			sync entries
+ *  varint id_0, varint id_1
+ *  varint arguments	zigzag encoded
+ *
+ * Varints are little endian groups of 7 bits with bit 7 set in all but the
+ * last byte. Sync entries also clear the dictionary, so a decoder can start
+ * from any sync entry. The first byte of struct log_entry_header is the low
+ * byte of an aligned uid pointer, so bit 0 tells the formats apart.
+ */
+#define TRACE_COMPACT_TAG_MASK		0xE1
+#define TRACE_COMPACT_TAG		0xA1
+#define TRACE_COMPACT_SYNC		0x10
+#define TRACE_COMPACT_ARGS(tag)		(((tag) >> 1) & 0x7)
+#define TRACE_COMPACT_SLOT_HIT		0x80
+#define TRACE_COMPACT_DICT_SIZE		64
+#define TRACE_COMPACT_SYNC_PERIOD	32
+
+static inline uint32_t trace_compact_slot(uint32_t log_entry_address)
+{
+	return (log_entry_address >> 2) & (TRACE_COMPACT_DICT_SIZE - 1);
+}
+
 #endif /* __USER_TRACE_H__ */
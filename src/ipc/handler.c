@@ -1336,6 +1336,73 @@ static int ipc_glb_test_mem_usage(uint32_t header)
 }
 #endif
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+static int ipc_glb_test_comp_mem_usage(uint32_t header)
+{
+	struct sof_ipc_dbg_comp_mem_usage_req req;
+	struct sof_ipc_dbg_comp_mem_usage_elem *elem;
+	struct sof_ipc_dbg_comp_mem_usage *mem_usage;
+	struct mm_usage_info *info;
+	uint32_t max_elems = (SOF_IPC_MSG_MAX_SIZE - sizeof(*mem_usage)) /
+			     sizeof(*elem);
+	uint32_t total = 0;
+	int count;
+	int zone;
+	int i;
+
+	IPC_COPY_CMD(req, ipc_get()->comp_data);
+
+	count = mm_usage_get(NULL, 0);
+	info = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		       MAX(count, 1) * sizeof(*info));
+	mem_usage = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			    SOF_IPC_MSG_MAX_SIZE);
+	if (!info || !mem_usage) {
+		rfree(info);
+		rfree(mem_usage);
+		return -ENOMEM;
+	}
+
+	/* owners may have been added since counted */
+	count = MIN(count, mm_usage_get(info, count));
+
+	/* one elem for each zone used by an owner, paged by the host */
+	elem = mem_usage->elems;
+	for (i = 0; i < count; i++) {
+		for (zone = 0; zone < MM_USAGE_ZONES; zone++) {
+			if (!info[i].peak[zone])
+				continue;
+
+			if (total++ < req.first_elem ||
+			    mem_usage->num_elems == max_elems)
+				continue;
+
+			elem->owner = info[i].owner;
+			elem->id = info[i].id;
+			elem->pipeline_id = info[i].pipeline_id;
+			elem->zone = zone;
+			elem->used = info[i].used[zone];
+			elem->peak = info[i].peak[zone];
+			elem++;
+			mem_usage->num_elems++;
+		}
+	}
+
+	mem_usage->rhdr.hdr.cmd = header;
+	mem_usage->rhdr.hdr.size = sizeof(*mem_usage) +
+				   mem_usage->num_elems * sizeof(*elem);
+	mem_usage->total_elems = total;
+	mem_usage->first_elem = req.first_elem;
+
+	/* write component values to the outbox */
+	mailbox_hostbox_write(0, mem_usage, mem_usage->rhdr.hdr.size);
+
+	rfree(info);
+	rfree(mem_usage);
+	return 1;
+}
+#endif
+
 static int ipc_glb_debug_message(uint32_t header)
 {
 	uint32_t cmd = iCS(header);
@@ -1344,6 +1411,10 @@ static int ipc_glb_debug_message(uint32_t header)
 #if CONFIG_DEBUG_MEMORY_USAGE_SCAN
 	case SOF_IPC_DEBUG_MEM_USAGE:
 		return ipc_glb_test_mem_usage(header);
+#endif
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	case SOF_IPC_DEBUG_COMP_MEM_USAGE:
+		return ipc_glb_test_comp_mem_usage(header);
 #endif
 	default:
 		tr_err(&ipc_tr, "ipc: unknown debug header 0x%x", header);
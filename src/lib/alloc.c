@@ -13,6 +13,7 @@
 #include <sof/lib/memory.h>
 #include <sof/lib/mm_heap.h>
 #include <sof/lib/uuid.h>
+#include <sof/list.h>
 #include <sof/math/numbers.h>
 #include <sof/spinlock.h>
 #include <sof/string.h>
@@ -97,6 +98,79 @@ static inline uint32_t heap_get_size(struct mm_heap *heap)
 	return size;
 }
 
+/* blocks tracked per free bitmap word */
+#define FREE_BITS_WORD	32
+
+static inline uint32_t free_bits_words(struct block_map *map)
+{
+	return (map->count + FREE_BITS_WORD - 1) / FREE_BITS_WORD;
+}
+
+/* index of first free block from start on, map->count if there is none */
+static unsigned int block_find_free(struct block_map *map,
+				    unsigned int start)
+{
+	unsigned int word = start / FREE_BITS_WORD;
+	uint32_t bits;
+
+	if (start >= map->count)
+		return map->count;
+
+	bits = map->free_bits[word] & (UINT32_MAX << (start % FREE_BITS_WORD));
+	while (!bits) {
+		if (++word >= free_bits_words(map))
+			return map->count;
+		bits = map->free_bits[word];
+	}
+
+	/* bits past map->count are never set */
+	return word * FREE_BITS_WORD + ffs(bits) - 1;
+}
+
+/* index of first used block from start on, map->count if there is none */
+static unsigned int block_find_used(struct block_map *map,
+				    unsigned int start)
+{
+	unsigned int word = start / FREE_BITS_WORD;
+	uint32_t bits;
+
+	if (start >= map->count)
+		return map->count;
+
+	bits = ~map->free_bits[word] &
+		(UINT32_MAX << (start % FREE_BITS_WORD));
+	while (!bits) {
+		if (++word >= free_bits_words(map))
+			return map->count;
+		bits = ~map->free_bits[word];
+	}
+
+	return MIN(word * FREE_BITS_WORD + ffs(bits) - 1, map->count);
+}
+
+/* marks count blocks from start on as free or used */
+static void block_set_free(struct block_map *map, unsigned int start,
+			   unsigned int count, bool is_free)
+{
+	unsigned int bit;
+	unsigned int len;
+	uint32_t mask;
+
+	while (count) {
+		bit = start % FREE_BITS_WORD;
+		len = MIN(count, FREE_BITS_WORD - bit);
+		mask = (UINT32_MAX >> (FREE_BITS_WORD - len)) << bit;
+
+		if (is_free)
+			map->free_bits[start / FREE_BITS_WORD] |= mask;
+		else
+			map->free_bits[start / FREE_BITS_WORD] &= ~mask;
+
+		start += len;
+		count -= len;
+	}
+}
+
 #if CONFIG_DEBUG_BLOCK_FREE
 static void write_pattern(struct mm_heap *heap_map, int heap_depth,
 			  uint8_t pattern)
@@ -179,6 +253,12 @@ static void *rmalloc_sys(struct mm_heap *heap, uint32_t flags, int caps, size_t
 	heap->info.used += bytes;
 	heap->info.free -= alignment + bytes;
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	/* system heap is never freed, nothing to tag */
+	mm_usage_charge(memmap_get()->usage[cpu_get_id()], SOF_MEM_ZONE_SYS,
+			alignment + bytes);
+#endif
+
 	platform_shared_commit(heap, sizeof(*heap));
 
 	return ptr;
@@ -203,6 +283,68 @@ static void *align_ptr(struct mm_heap *heap, uint32_t alignment,
 	return (char *)ptr + mod_align;
 }
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+static void _rfree_unlocked(void *ptr);
+
+/* zone the blocks of heap are counted in */
+static int usage_zone(struct mm *memmap, struct mm_heap *heap)
+{
+	if (heap >= memmap->system_runtime &&
+	    heap < memmap->system_runtime + PLATFORM_HEAP_SYSTEM_RUNTIME)
+		return SOF_MEM_ZONE_SYS_RUNTIME;
+
+	if (heap >= memmap->buffer &&
+	    heap < memmap->buffer + PLATFORM_HEAP_BUFFER)
+		return SOF_MEM_ZONE_BUFFER;
+
+	return SOF_MEM_ZONE_RUNTIME;
+}
+
+/* charges the block to the usage in use on this core */
+static void usage_charge(struct mm_heap *heap, struct block_hdr *hdr,
+			 uint32_t bytes)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_usage *usage = memmap->usage[cpu_get_id()];
+
+	hdr->usage = usage;
+	if (!usage)
+		return;
+
+	usage->live++;
+	mm_usage_charge(usage, usage_zone(memmap, heap), bytes);
+
+	platform_shared_commit(usage, sizeof(*usage));
+}
+
+static void usage_release(struct mm_usage *usage)
+{
+	list_item_del(&usage->list);
+	_rfree_unlocked(usage);
+}
+
+/* returns bytes of the block to the usage it was charged to */
+static void usage_uncharge(struct mm_heap *heap, struct block_hdr *hdr,
+			   uint32_t bytes)
+{
+	struct mm_usage *usage = hdr->usage;
+
+	if (!usage)
+		return;
+
+	hdr->usage = NULL;
+	mm_usage_charge(usage, usage_zone(memmap_get(), heap),
+			-(int32_t)bytes);
+
+	if (!--usage->live && usage->orphan) {
+		usage_release(usage);
+		return;
+	}
+
+	platform_shared_commit(usage, sizeof(*usage));
+}
+#endif
+
 /* allocate single block */
 static void *alloc_block(struct mm_heap *heap, int level,
 			 uint32_t caps, uint32_t alignment)
@@ -210,7 +352,6 @@ static void *alloc_block(struct mm_heap *heap, int level,
 	struct block_map *map = &heap->map[level];
 	struct block_hdr *hdr;
 	void *ptr;
-	int i;
 
 	hdr = &map->block[map->first_free];
 
@@ -220,19 +361,19 @@ static void *alloc_block(struct mm_heap *heap, int level,
 
 	hdr->size = 1;
 	hdr->used = 1;
+	block_set_free(map, map->first_free, 1, false);
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	usage_charge(heap, hdr, map->block_size);
+#endif
 
 	heap->info.used += map->block_size;
 	heap->info.free -= map->block_size;
 
 	/* find next free */
-	for (i = map->first_free; i < map->count; ++i) {
-		hdr = &map->block[i];
+	map->first_free = block_find_free(map, map->first_free + 1);
 
-		if (hdr->used == 0) {
-			map->first_free = i;
-			break;
-		}
-	}
+	platform_shared_commit(map->free_bits,
+			       sizeof(*map->free_bits) * free_bits_words(map));
 
 	platform_shared_commit(map->block, sizeof(*map->block) * map->count);
 	platform_shared_commit(map, sizeof(*map));
@@ -249,10 +390,10 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	struct block_hdr *hdr;
 	void *ptr = NULL;
 	void *unaligned_ptr;
-	unsigned int start = map->first_free;
+	unsigned int start;
+	unsigned int end;
 	unsigned int current;
 	unsigned int count = bytes / map->block_size;
-	unsigned int remaining = 0;
 
 	if (bytes % map->block_size)
 		count++;
@@ -260,19 +401,17 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	/* check if we have enough consecutive blocks for requested
 	 * allocation size.
 	 */
-	for (current = map->first_free; current < map->count &&
-	     remaining < count; current++) {
-		hdr = &map->block[current];
-
-		if (hdr->used)
-			remaining = 0;/* used, not suitable, reset */
-		else if (!remaining++)
-			start = current;/* new start */
+	for (start = block_find_free(map, map->first_free);
+	     start + count <= map->count;
+	     start = block_find_free(map, end)) {
+		end = block_find_used(map, start);
+		if (end - start >= count)
+			break;
 	}
 
-	if (count > map->count || remaining < count) {
-		tr_err(&mem_tr, "%d blocks needed for allocation but only %d blocks are remaining",
-		       count, remaining);
+	if (start + count > map->count) {
+		tr_err(&mem_tr, "%d blocks needed for allocation but only %d blocks are free",
+		       count, map->free_count);
 		goto out;
 	}
 
@@ -283,21 +422,14 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 
 	hdr = &map->block[start];
 	hdr->size = count;
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	usage_charge(heap, hdr, count * map->block_size);
+#endif
 
 	ptr = align_ptr(heap, alignment, ptr, hdr);
 
 	heap->info.used += count * map->block_size;
 	heap->info.free -= count * map->block_size;
-	/* update first_free if needed */
-	if (map->first_free == start)
-		/* find first available free block */
-		for (map->first_free += count; map->first_free < map->count;
-			map->first_free++) {
-			hdr = &map->block[map->first_free];
-
-			if (!hdr->used)
-				break;
-		}
 
 	/* update each block */
 	for (current = start; current < start + count; current++) {
@@ -305,8 +437,15 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 		hdr->used = 1;
 		hdr->unaligned_ptr = unaligned_ptr;
 	}
+	block_set_free(map, start, count, false);
+
+	/* update first_free if needed */
+	if (map->first_free == start)
+		map->first_free = block_find_free(map, start + count);
 
 out:
+	platform_shared_commit(map->free_bits,
+			       sizeof(*map->free_bits) * free_bits_words(map));
 	platform_shared_commit(map->block, sizeof(*map->block) * map->count);
 	platform_shared_commit(map, sizeof(*map));
 	platform_shared_commit(heap, sizeof(*heap));
@@ -438,7 +577,6 @@ static void free_block(void *ptr)
 	int i;
 	int block;
 	int used_blocks;
-	bool heap_is_full;
 
 	heap = get_heap_from_ptr(ptr);
 	if (!heap) {
@@ -489,8 +627,6 @@ static void free_block(void *ptr)
 	if (block_map->base + block_map->block_size * block != (uint32_t)ptr)
 		panic(SOF_IPC_PANIC_MEM);
 
-	heap_is_full = !block_map->free_count;
-
 	/* free block header and continuous blocks */
 	used_blocks = block + hdr->size;
 
@@ -503,9 +639,10 @@ static void free_block(void *ptr)
 		heap->info.used -= block_map->block_size;
 		heap->info.free += block_map->block_size;
 	}
+	block_set_free(block_map, block, used_blocks - block, true);
 
 	/* set first free block */
-	if (block < block_map->first_free || heap_is_full)
+	if (block < block_map->first_free)
 		block_map->first_free = block;
 
 #if CONFIG_DEBUG_BLOCK_FREE
@@ -519,6 +656,14 @@ static void free_block(void *ptr)
 		(i - block));
 #endif
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	usage_uncharge(heap, &block_map->block[block],
+		       block_map->block_size * (used_blocks - block));
+#endif
+
+	platform_shared_commit(block_map->free_bits,
+			       sizeof(*block_map->free_bits) *
+			       free_bits_words(block_map));
 	platform_shared_commit(block_map->block, sizeof(*block_map->block) *
 			       block_map->count);
 	platform_shared_commit(block_map, sizeof(*block_map));
@@ -679,6 +824,87 @@ static void *rmalloc_runtime_shared(uint32_t flags, uint32_t caps, size_t bytes)
 }
 #endif
 
+#if CONFIG_PIPELINE_ARENA
+static void _rfree_unlocked(void *ptr);
+
+/* allocate from the arena in use on this core */
+static void *arena_alloc(struct mm *memmap, uint32_t caps, size_t bytes,
+			 uint32_t alignment)
+{
+	struct mm_arena *arena = memmap->arena[cpu_get_id()];
+	uint32_t ptr;
+	uint32_t top;
+
+	if (!arena)
+		return NULL;
+
+	/* keep allocations on their own cache lines like heap blocks */
+	alignment = MAX(alignment, PLATFORM_DCACHE_ALIGN);
+	ptr = ALIGN_UP(arena->base + arena->top, alignment);
+	top = ptr + ALIGN_UP(bytes, PLATFORM_DCACHE_ALIGN) - arena->base;
+
+	if (!arena->base || (arena->caps & caps) != caps ||
+	    top > arena->size) {
+		/* falls back to heap, arena_fit() makes room for next time */
+		arena->used += ALIGN_UP(bytes, alignment);
+		ptr = 0;
+	} else {
+		arena->used += top - arena->top;
+		arena->top = top;
+		arena->live++;
+	}
+
+	arena->peak = MAX(arena->peak, arena->used);
+
+	platform_shared_commit(arena, sizeof(*arena));
+
+	return (void *)ptr;
+}
+
+static void arena_release(struct mm_arena *arena)
+{
+	list_item_del(&arena->list);
+
+	if (arena->base)
+		free_block((void *)arena->base);
+
+	_rfree_unlocked(arena);
+}
+
+/* returns true if ptr was allocated from an arena */
+static bool arena_put(struct mm *memmap, void *ptr)
+{
+	struct mm_arena *arena;
+	struct list_item *alist;
+
+	list_for_item(alist, &memmap->arena_list) {
+		arena = container_of(alist, struct mm_arena, list);
+
+		if ((uint32_t)ptr < arena->base ||
+		    (uint32_t)ptr >= arena->base + arena->size) {
+			platform_shared_commit(arena, sizeof(*arena));
+			continue;
+		}
+
+		/* space is reused once all allocations are freed */
+		if (--arena->live) {
+			platform_shared_commit(arena, sizeof(*arena));
+			return true;
+		}
+
+		arena->top = 0;
+		platform_shared_commit(arena, sizeof(*arena));
+
+		if (arena->orphan)
+			arena_release(arena);
+
+		return true;
+	}
+
+	return false;
+}
+#endif
+
 static void *_malloc_unlocked(enum mem_zone zone, uint32_t flags, uint32_t caps,
 			      size_t bytes)
 {
@@ -693,6 +919,11 @@ static void *_malloc_unlocked(enum mem_zone zone, uint32_t flags, uint32_t caps,
 		ptr = rmalloc_sys_runtime(flags, caps, cpu_get_id(), bytes);
 		break;
 	case SOF_MEM_ZONE_RUNTIME:
+#if CONFIG_PIPELINE_ARENA
+		ptr = arena_alloc(memmap, caps, bytes, PLATFORM_DCACHE_ALIGN);
+		if (ptr)
+			break;
+#endif
 		ptr = rmalloc_runtime(flags, caps, bytes);
 		break;
 #if CONFIG_CORE_COUNT > 1
@@ -859,6 +1090,14 @@ static void *_balloc_unlocked(uint32_t flags, uint32_t caps, size_t bytes,
 	unsigned int i, n;
 	void *ptr = NULL;
 
+#if CONFIG_PIPELINE_ARENA
+	ptr = arena_alloc(memmap, caps, bytes, alignment);
+	if (ptr) {
+		platform_shared_commit(memmap, sizeof(*memmap));
+		return ptr;
+	}
+#endif
+
 	for (i = 0, n = PLATFORM_HEAP_BUFFER, heap = memmap->buffer;
 	     i < PLATFORM_HEAP_BUFFER;
 	     i = heap - memmap->buffer + 1, n = PLATFORM_HEAP_BUFFER - i,
@@ -909,6 +1148,13 @@ static void _rfree_unlocked(void *ptr)
 	/* prepare pointer if it's platform requirement */
 	ptr = platform_rfree_prepare(ptr);
 
+#if CONFIG_PIPELINE_ARENA
+	if (arena_put(memmap, ptr)) {
+		platform_shared_commit(memmap, sizeof(*memmap));
+		return;
+	}
+#endif
+
 	/* use the heap dedicated for the core or shared memory */
 #if CONFIG_CORE_COUNT > 1
 	if (is_uncached(ptr))
@@ -972,6 +1218,223 @@ void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 	return new_ptr;
 }
 
+#if CONFIG_PIPELINE_ARENA
+struct mm_arena *arena_new(void)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_arena *arena;
+	uint32_t flags;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	/* shared, any core may free into the arena */
+	arena = _malloc_unlocked(SOF_MEM_ZONE_RUNTIME_SHARED, 0,
+				 SOF_MEM_CAPS_RAM, sizeof(*arena));
+	if (arena) {
+		bzero(arena, sizeof(*arena));
+		list_item_append(&arena->list, &memmap->arena_list);
+		platform_shared_commit(arena, sizeof(*arena));
+	}
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	return arena;
+}
+
+void arena_free(struct mm_arena *arena)
+{
+	struct mm *memmap = memmap_get();
+	uint32_t flags;
+	int i;
+
+	if (!arena)
+		return;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++)
+		if (memmap->arena[i] == arena)
+			memmap->arena[i] = NULL;
+
+	if (arena->live) {
+		arena->orphan = true;
+		platform_shared_commit(arena, sizeof(*arena));
+	} else {
+		arena_release(arena);
+	}
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+}
+
+void arena_use(struct mm_arena *arena)
+{
+	struct mm *memmap = memmap_get();
+	uint32_t flags;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	memmap->arena[cpu_get_id()] = arena;
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+}
+
+void arena_fit(struct mm_arena *arena)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_arena *active;
+	void *base;
+	uint32_t flags;
+
+	if (!arena)
+		return;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	/* allocations in use would move */
+	if (arena->live)
+		goto out;
+
+	if (arena->peak > arena->size) {
+		if (arena->base)
+			free_block((void *)arena->base);
+
+		/* the block itself must come from the heap */
+		active = memmap->arena[cpu_get_id()];
+		memmap->arena[cpu_get_id()] = NULL;
+		base = _balloc_unlocked(0, SOF_MEM_CAPS_RAM, arena->peak,
+					PLATFORM_DCACHE_ALIGN);
+		memmap->arena[cpu_get_id()] = active;
+
+		arena->base = (uint32_t)base;
+		arena->size = base ? arena->peak : 0;
+		arena->caps = base ? get_heap_from_ptr(base)->caps : 0;
+		arena->top = 0;
+		memmap->heap_trace_updated = 1;
+
+		tr_info(&mem_tr, "arena_fit(): %d bytes at %p", arena->size,
+			base);
+	}
+
+	arena->used = 0;
+
+out:
+	platform_shared_commit(arena, sizeof(*arena));
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+}
+#endif
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+struct mm_usage *mm_usage_new(enum mm_usage_owner owner, uint32_t id,
+			      uint32_t pipeline_id)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_usage *active;
+	struct mm_usage *usage;
+	uint32_t flags;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	/* not charged to anyone, shared as any core may free into it */
+	active = memmap->usage[cpu_get_id()];
+	memmap->usage[cpu_get_id()] = NULL;
+	usage = _malloc_unlocked(SOF_MEM_ZONE_RUNTIME_SHARED, 0,
+				 SOF_MEM_CAPS_RAM, sizeof(*usage));
+	memmap->usage[cpu_get_id()] = active;
+
+	if (usage) {
+		bzero(usage, sizeof(*usage));
+		usage->info.owner = owner;
+		usage->info.id = id;
+		usage->info.pipeline_id = pipeline_id;
+		list_item_append(&usage->list, &memmap->usage_list);
+		mm_usage_link(&memmap->usage_list, usage);
+		platform_shared_commit(usage, sizeof(*usage));
+	}
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	return usage;
+}
+
+void mm_usage_free(struct mm_usage *usage)
+{
+	struct mm *memmap = memmap_get();
+	uint32_t flags;
+	int i;
+
+	if (!usage)
+		return;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++)
+		if (memmap->usage[i] == usage)
+			memmap->usage[i] = NULL;
+
+	if (usage->info.owner == MM_USAGE_PIPELINE)
+		mm_usage_unlink(&memmap->usage_list, usage);
+
+	if (usage->live) {
+		usage->orphan = true;
+		platform_shared_commit(usage, sizeof(*usage));
+	} else {
+		usage_release(usage);
+	}
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+}
+
+struct mm_usage *mm_usage_use(struct mm_usage *usage)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_usage *prev;
+	uint32_t flags;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	prev = memmap->usage[cpu_get_id()];
+	memmap->usage[cpu_get_id()] = usage;
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	return prev;
+}
+
+int mm_usage_get(struct mm_usage_info *info, int count)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_usage *usage;
+	struct list_item *ulist;
+	uint32_t flags;
+	int n = 0;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	list_for_item(ulist, &memmap->usage_list) {
+		usage = container_of(ulist, struct mm_usage, list);
+		if (n < count)
+			info[n] = usage->info;
+		n++;
+	}
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	return n;
+}
+#endif
+
 /* TODO: all mm_pm_...() routines to be implemented for IMR storage */
 uint32_t mm_pm_context_size(void)
 {
@@ -1079,6 +1542,46 @@ void heap_trace_all(int force) { }
 void heap_trace(struct mm_heap *heap, int size) { }
 #endif
 
+/* allocates free bitmaps of heap maps with all blocks free */
+static void init_heap_free_bits(struct mm_heap *heap, int count)
+{
+	struct block_map *map;
+	uint32_t *bits;
+	uint32_t words = 0;
+	int i;
+	int j;
+
+	for (i = 0; i < count; i++)
+		for (j = 0; j < heap[i].blocks; j++)
+			words += free_bits_words(&heap[i].map[j]);
+
+	if (!words)
+		return;
+
+	/* any core may allocate from the maps */
+	bits = _malloc_unlocked(SOF_MEM_ZONE_SYS_SHARED, 0, 0,
+				words * sizeof(*bits));
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < heap[i].blocks; j++) {
+			map = &heap[i].map[j];
+			map->free_bits = bits;
+			bits += free_bits_words(map);
+
+			bzero(map->free_bits,
+			      free_bits_words(map) * sizeof(*bits));
+			block_set_free(map, 0, map->count, true);
+
+			platform_shared_commit(map->free_bits,
+					       sizeof(*bits) *
+					       free_bits_words(map));
+			platform_shared_commit(map, sizeof(*map));
+		}
+
+		platform_shared_commit(&heap[i], sizeof(heap[i]));
+	}
+}
+
 /* initialise map */
 void init_heap(struct sof *sof)
 {
@@ -1090,14 +1593,28 @@ void init_heap(struct sof *sof)
 		panic(SOF_IPC_PANIC_MEM);
 
 	init_heap_map(memmap->system_runtime, PLATFORM_HEAP_SYSTEM_RUNTIME);
+	init_heap_free_bits(memmap->system_runtime,
+			    PLATFORM_HEAP_SYSTEM_RUNTIME);
 
 	init_heap_map(memmap->runtime, PLATFORM_HEAP_RUNTIME);
+	init_heap_free_bits(memmap->runtime, PLATFORM_HEAP_RUNTIME);
 
 #if CONFIG_CORE_COUNT > 1
 	init_heap_map(memmap->runtime_shared, PLATFORM_HEAP_RUNTIME_SHARED);
+	init_heap_free_bits(memmap->runtime_shared,
+			    PLATFORM_HEAP_RUNTIME_SHARED);
 #endif
 
 	init_heap_map(memmap->buffer, PLATFORM_HEAP_BUFFER);
+	init_heap_free_bits(memmap->buffer, PLATFORM_HEAP_BUFFER);
+
+#if CONFIG_PIPELINE_ARENA
+	list_init(&memmap->arena_list);
+#endif
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	list_init(&memmap->usage_list);
+#endif
 
 #if CONFIG_DEBUG_BLOCK_FREE
 	write_pattern((struct mm_heap *)&memmap->buffer, PLATFORM_HEAP_BUFFER,
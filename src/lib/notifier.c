@@ -17,6 +17,7 @@
 #include <sof/list.h>
 #include <sof/sof.h>
 #include <ipc/topology.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* 1fb15a7a-83cd-4c2e-8b32-4da1b2adeeaf */
@@ -33,6 +34,8 @@ struct callback_handle {
 	void (*cb)(void *arg, enum notify_id, void *data);
 	struct list_item list;
 	uint32_t num_registrations;
+	enum notify_id type;	/* event type for object subscriptions */
+	uint32_t core;		/* subscribing core for object subscriptions */
 };
 
 int notifier_register(void *receiver, void *caller, enum notify_id type,
@@ -141,6 +144,99 @@ static void notifier_notify(const void *caller, enum notify_id type, void *data)
 	}
 }
 
+int notifier_obj_register(void *receiver, struct list_item *subscribers,
+			  spinlock_t *lock, enum notify_id type,
+			  void (*cb)(void *arg, enum notify_id type, void *data))
+{
+	struct callback_handle *handle;
+	uint32_t flags;
+
+	assert(type >= NOTIFIER_ID_CPU_FREQ && type < NOTIFIER_ID_COUNT);
+
+	/* other cores walk and unlink the handles too */
+	handle = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
+			 sizeof(*handle));
+	if (!handle) {
+		tr_err(&nt_tr, "notifier_obj_register(): callback handle allocation failed.");
+		return -ENOMEM;
+	}
+
+	handle->receiver = receiver;
+	handle->cb = cb;
+	handle->num_registrations = 1;
+	handle->type = type;
+	handle->core = cpu_get_id();
+
+	spin_lock_irq(lock, flags);
+	dcache_invalidate_region(subscribers, sizeof(*subscribers));
+	list_item_append(&handle->list, subscribers);
+	dcache_writeback_region(subscribers, sizeof(*subscribers));
+	spin_unlock_irq(lock, flags);
+
+	return 0;
+}
+
+static void notifier_obj_remove(void *receiver, struct list_item *subscribers,
+				spinlock_t *lock, enum notify_id type,
+				bool all_types)
+{
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct callback_handle *handle;
+	uint32_t flags;
+
+	spin_lock_irq(lock, flags);
+	dcache_invalidate_region(subscribers, sizeof(*subscribers));
+
+	/* If receiver is NULL, unregister all callbacks of the object */
+	list_for_item_safe(wlist, tlist, subscribers) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if ((!receiver || handle->receiver == receiver) &&
+		    (all_types || handle->type == type)) {
+			list_item_del(&handle->list);
+			rfree(handle);
+		}
+	}
+
+	dcache_writeback_region(subscribers, sizeof(*subscribers));
+	spin_unlock_irq(lock, flags);
+}
+
+void notifier_obj_unregister(void *receiver, struct list_item *subscribers,
+			     spinlock_t *lock, enum notify_id type)
+{
+	assert(type >= NOTIFIER_ID_CPU_FREQ && type < NOTIFIER_ID_COUNT);
+
+	notifier_obj_remove(receiver, subscribers, lock, type, false);
+}
+
+void notifier_obj_unregister_all(void *receiver, struct list_item *subscribers,
+				 spinlock_t *lock)
+{
+	notifier_obj_remove(receiver, subscribers, lock, NOTIFIER_ID_COUNT,
+			    true);
+}
+
+void notifier_obj_notify(struct list_item *subscribers, spinlock_t *lock,
+			 enum notify_id type, void *data)
+{
+	struct list_item *wlist;
+	struct callback_handle *handle;
+	uint32_t core = cpu_get_id();
+	uint32_t flags;
+
+	spin_lock_irq(lock, flags);
+	dcache_invalidate_region(subscribers, sizeof(*subscribers));
+
+	list_for_item(wlist, subscribers) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if (handle->type == type && handle->core == core)
+			handle->cb(handle->receiver, type, data);
+	}
+
+	spin_unlock_irq(lock, flags);
+}
+
 void notifier_notify_remote(void)
 {
 	struct notify *notify = *arch_notify_get();
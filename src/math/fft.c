@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/trig.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Radix-2 decimation in time complex FFT with Q1.31 data
+ */
+
+int fft_plan_size(int size)
+{
+	/* The size must be a power of two */
+	if (size < FFT_SIZE_MIN || size > FFT_SIZE_MAX || (size & (size - 1)))
+		return -EINVAL;
+
+	return size / 2 * sizeof(struct icomplex32) +
+		size * sizeof(uint16_t);
+}
+
+int fft_plan_init(struct fft_plan *plan, int size, void **data)
+{
+	uint8_t *p = *data;
+	int32_t w;
+	int len;
+	int i;
+	int j;
+	int k;
+
+	if (fft_plan_size(size) < 0)
+		return -EINVAL;
+
+	len = 0;
+	while ((1 << len) < size)
+		len++;
+
+	plan->size = size;
+	plan->len = len;
+	plan->twiddle = (struct icomplex32 *)p;
+	p += size / 2 * sizeof(struct icomplex32);
+	plan->bit_reverse_idx = (uint16_t *)p;
+	p += size * sizeof(uint16_t);
+
+	/* Twiddle factors exp(-j * 2 * pi * i / size) for the first half of
+	 * the unit circle. The angle is Q4.28 and cosine is computed as sine
+	 * with pi/2 phase shift.
+	 */
+	for (i = 0; i < size / 2; i++) {
+		w = (int32_t)((int64_t)PI_MUL2_Q4_28 * i / size);
+		plan->twiddle[i].real = sin_fixed(w + PI_DIV2_Q4_28);
+		plan->twiddle[i].imag = -sin_fixed(w);
+	}
+
+	for (i = 0; i < size; i++) {
+		k = 0;
+		for (j = 0; j < len; j++)
+			k |= ((i >> j) & 1) << (len - 1 - j);
+
+		plan->bit_reverse_idx[i] = k;
+	}
+
+	*data = p;
+	return 0;
+}
+
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *data,
+		    bool ifft)
+{
+	struct icomplex32 *top;
+	struct icomplex32 *bottom;
+	struct icomplex32 tmp;
+	int32_t tw_real;
+	int32_t tw_imag;
+	int64_t t_real;
+	int64_t t_imag;
+	int size = plan->size;
+	int half;
+	int step;
+	int i;
+	int j;
+	int k;
+
+	/* Reorder input to bit reversed order */
+	for (i = 0; i < size; i++) {
+		j = plan->bit_reverse_idx[i];
+		if (j > i) {
+			tmp = data[i];
+			data[i] = data[j];
+			data[j] = tmp;
+		}
+	}
+
+	for (half = 1; half < size; half <<= 1) {
+		step = size / (2 * half);
+		for (k = 0; k < size; k += 2 * half) {
+			for (j = 0; j < half; j++) {
+				tw_real = plan->twiddle[j * step].real;
+				tw_imag = plan->twiddle[j * step].imag;
+				if (ifft)
+					tw_imag = -tw_imag;
+
+				top = &data[k + j];
+				bottom = &data[k + j + half];
+
+				/* Q1.31 x Q1.31 -> Q2.62, round to Q1.31 */
+				t_real = ((int64_t)bottom->real * tw_real -
+					  (int64_t)bottom->imag * tw_imag +
+					  (1LL << 30)) >> 31;
+				t_imag = ((int64_t)bottom->real * tw_imag +
+					  (int64_t)bottom->imag * tw_real +
+					  (1LL << 30)) >> 31;
+
+				if (ifft) {
+					bottom->real = sat_int32(top->real - t_real);
+					bottom->imag = sat_int32(top->imag - t_imag);
+					top->real = sat_int32(top->real + t_real);
+					top->imag = sat_int32(top->imag + t_imag);
+				} else {
+					/* Scale by 1/2 in every stage */
+					bottom->real = (top->real - t_real) >> 1;
+					bottom->imag = (top->imag - t_imag) >> 1;
+					top->real = (top->real + t_real) >> 1;
+					top->imag = (top->imag + t_imag) >> 1;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/string.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Uniformly partitioned overlap-save FIR filter. The impulse response is
+ * split into partitions of block taps. For every block of input the FFT of
+ * the latest two blocks is stored to a frequency domain delay line. The
+ * spectra in the delay line are multiplied with the partitions spectra and
+ * summed. The last half of the inverse FFT is the output block.
+ *
+ * The forward FFT is scaled by 1/N, so with X and H as the spectra of input
+ * and response the products are X * H / N^2. The inverse FFT is not scaled
+ * so the spectrum sum is scaled to X * H / N before it.
+ */
+
+/* Product Q2.62 is shifted to Q2.54 for accumulation to leave headroom
+ * for FIR_FFT_MAX_PARTITIONS partitions.
+ */
+#define FIR_FFT_PRODUCT_SHIFT	8
+
+int fir_fft_block_length(int frames)
+{
+	int block = FIR_FFT_BLOCK_MIN;
+
+	/* Use power of two length that is not less than period so that
+	 * there is max. one block to process per period.
+	 */
+	while (block < frames && block < FIR_FFT_BLOCK_MAX)
+		block <<= 1;
+
+	return block;
+}
+
+int fir_fft_cost(int length, int block)
+{
+	int partitions = (length + block - 1) / block;
+	int len = 0;
+
+	while ((1 << len) < 2 * block)
+		len++;
+
+	/* Two complex FFTs of 2 * block points with four multiplications
+	 * per butterfly, and four multiplications per bin for the spectrum
+	 * products.
+	 */
+	return (8 * block * len + 4 * partitions * (block + 1)) / block;
+}
+
+void fir_fft_reset(struct fir_fft_state *fir)
+{
+	fir->coef = NULL;
+	fir->plan = NULL;
+	fir->buf = NULL;
+	fir->fdl = NULL;
+	fir->in = NULL;
+	fir->out = NULL;
+	fir->pos = 0;
+	fir->fdl_idx = 0;
+}
+
+int fir_fft_coef_size(struct sof_fir_coef_data *config, int block)
+{
+	int partitions;
+
+	if (config->length > SOF_FIR_MAX_LENGTH_FFT || config->length < 1)
+		return -EINVAL;
+
+	partitions = (config->length + block - 1) / block;
+	if (partitions > FIR_FFT_MAX_PARTITIONS)
+		return -EINVAL;
+
+	return partitions * (block + 1) * sizeof(struct icomplex32);
+}
+
+void fir_fft_init_coef(struct fir_fft_coef *coef,
+		       struct sof_fir_coef_data *config, int block,
+		       struct fft_plan *plan, struct icomplex32 *buf,
+		       void **data)
+{
+	struct icomplex32 *h = *data;
+	int n;
+	int p;
+	int i;
+
+	coef->length = config->length;
+	coef->block = block;
+	coef->partitions = (coef->length + block - 1) / block;
+	coef->shift = 31 - FIR_FFT_PRODUCT_SHIFT - plan->len +
+		config->out_shift;
+	coef->h = h;
+
+	for (p = 0; p < coef->partitions; p++) {
+		/* Zero padded partition, Q1.15 coefficients to Q1.31 */
+		memset(buf, 0, plan->size * sizeof(struct icomplex32));
+		for (i = 0; i < block; i++) {
+			n = p * block + i;
+			if (n >= coef->length)
+				break;
+
+			buf[i].real = (int32_t)config->coef[n] << 16;
+		}
+
+		/* Only the bins up to Nyquist are stored since the spectrum
+		 * of real data is conjugate symmetric.
+		 */
+		fft_execute_32(plan, buf, false);
+		memcpy_s(h, (block + 1) * sizeof(struct icomplex32), buf,
+			 (block + 1) * sizeof(struct icomplex32));
+		h += block + 1;
+	}
+
+	*data = h;
+}
+
+int fir_fft_delay_size(struct sof_fir_coef_data *config, int block)
+{
+	int s = fir_fft_coef_size(config, block);
+
+	/* Delay line of spectra is the same size as response spectra. In
+	 * addition two blocks of input and one block of output.
+	 */
+	if (s < 0)
+		return s;
+
+	return s + 3 * block * sizeof(int32_t);
+}
+
+void fir_fft_init_bypass(struct fir_fft_coef *coef, int block)
+{
+	coef->length = 0;
+	coef->block = block;
+	coef->partitions = 0;
+	coef->shift = 0;
+	coef->h = NULL;
+}
+
+int fir_fft_bypass_delay_size(int block)
+{
+	return 3 * block * sizeof(int32_t);
+}
+
+void fir_fft_init_delay(struct fir_fft_state *fir, struct fir_fft_coef *coef,
+			struct fft_plan *plan, struct icomplex32 *buf,
+			void **data)
+{
+	struct icomplex32 *fdl = *data;
+
+	fir->coef = coef;
+	fir->plan = plan;
+	fir->buf = buf;
+	fir->fdl = fdl;
+	fir->in = (int32_t *)(fdl + coef->partitions * (coef->block + 1));
+	fir->out = fir->in + 2 * coef->block;
+	fir->pos = 0;
+	fir->fdl_idx = 0;
+	*data = fir->out + coef->block;
+}
+
+static void fir_fft_block(struct fir_fft_state *fir)
+{
+	struct fir_fft_coef *coef = fir->coef;
+	struct icomplex32 *buf = fir->buf;
+	struct icomplex32 *x;
+	struct icomplex32 *h;
+	int64_t acc_real;
+	int64_t acc_imag;
+	int block = coef->block;
+	int bins = block + 1;
+	int size = 2 * block;
+	int rnd;
+	int i;
+	int j;
+	int p;
+
+	/* Bypass outputs the current input block during the next one */
+	if (!coef->partitions) {
+		memcpy_s(fir->out, block * sizeof(int32_t), &fir->in[block],
+			 block * sizeof(int32_t));
+		return;
+	}
+
+	rnd = 1 << (coef->shift - 1);
+
+	/* Transform the previous and current input blocks */
+	for (i = 0; i < size; i++) {
+		buf[i].real = fir->in[i];
+		buf[i].imag = 0;
+	}
+
+	fft_execute_32(fir->plan, buf, false);
+
+	/* Insert the spectrum as newest to delay line */
+	fir->fdl_idx = fir->fdl_idx ? fir->fdl_idx - 1 : coef->partitions - 1;
+	memcpy_s(&fir->fdl[fir->fdl_idx * bins],
+		 bins * sizeof(struct icomplex32), buf,
+		 bins * sizeof(struct icomplex32));
+
+	/* Sum of the delayed input spectra multiplied by partitions */
+	for (i = 0; i < bins; i++) {
+		acc_real = 0;
+		acc_imag = 0;
+		j = fir->fdl_idx;
+		h = &coef->h[i];
+		for (p = 0; p < coef->partitions; p++) {
+			x = &fir->fdl[j * bins + i];
+			acc_real += ((int64_t)x->real * h->real -
+				     (int64_t)x->imag * h->imag) >>
+				FIR_FFT_PRODUCT_SHIFT;
+			acc_imag += ((int64_t)x->real * h->imag +
+				     (int64_t)x->imag * h->real) >>
+				FIR_FFT_PRODUCT_SHIFT;
+			h += bins;
+			if (++j == coef->partitions)
+				j = 0;
+		}
+
+		buf[i].real = sat_int32((acc_real + rnd) >> coef->shift);
+		buf[i].imag = sat_int32((acc_imag + rnd) >> coef->shift);
+	}
+
+	/* Conjugate symmetric upper half for real valued output */
+	for (i = 1; i < block; i++) {
+		buf[size - i].real = buf[i].real;
+		buf[size - i].imag = sat_int32(-(int64_t)buf[i].imag);
+	}
+
+	fft_execute_32(fir->plan, buf, true);
+
+	/* The first half is circular convolution alias, keep the second */
+	for (i = 0; i < block; i++)
+		fir->out[i] = buf[block + i].real;
+
+	/* Current block becomes the previous block */
+	memcpy_s(fir->in, block * sizeof(int32_t), &fir->in[block],
+		 block * sizeof(int32_t));
+}
+
+void fir_fft_32(struct fir_fft_state *fir, const int32_t *x, int32_t *y,
+		int samples)
+{
+	int block = fir->coef->block;
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		fir->in[block + fir->pos] = x[i];
+		y[i] = fir->out[fir->pos];
+		if (++fir->pos == block) {
+			fir_fft_block(fir);
+			fir->pos = 0;
+		}
+	}
+}
@@ -42,7 +42,10 @@ int fir_delay_size(struct sof_fir_coef_data *config)
 	if (config->length > SOF_FIR_MAX_LENGTH || config->length < 1)
 		return -EINVAL;
 
-	return config->length * sizeof(int32_t);
+	/* The delay line is duplicated to keep the filter taps in
+	 * one contiguous block of samples without circular wrap.
+	 */
+	return 2 * config->length * sizeof(int32_t);
 }
 
 int fir_init_coef(struct fir_state_32x16 *fir,
@@ -59,63 +62,70 @@ int fir_init_coef(struct fir_state_32x16 *fir,
 void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data)
 {
 	fir->delay = *data;
-	*data += fir->length; /* Point to next delay line start */
+	*data += 2 * fir->length; /* Point to next delay line start */
 }
 
-int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
+/* The delay line has two copies of the latest length samples. A new
+ * sample is written to both copies and the write index is decremented,
+ * so the newest sample is always at delay[rwi] and the oldest one at
+ * delay[rwi + length - 1]. The convolution can then be computed with
+ * a single loop without any circular wrap checks.
+ */
+static inline int32_t fir_32x16_sample(struct fir_state_32x16 *fir,
+				       const int16_t *coef, int32_t x)
 {
 	int64_t y = 0;
 	int32_t *data = &fir->delay[fir->rwi];
-	int16_t *coef = &fir->coef[0];
-	int n1;
-	int n2;
+	int length = fir->length;
 	int n;
 
+	/* Write sample to both halves of delay line */
+	data[0] = x;
+	data[length] = x;
+
+	/* Data is Q1.31, coef is Q1.15, product is Q2.46 */
+	for (n = 0; n < length; n++)
+		y += (int64_t)coef[n] * data[n];
+
+	/* Move write index backwards for next sample */
+	fir->rwi = fir->rwi ? fir->rwi - 1 : length - 1;
+
+	/* Q2.46 -> Q2.31, saturate to Q1.31 */
+	return sat_int32(y >> (15 + fir->out_shift));
+}
+
+int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
+{
 	/* Bypass is set with length set to zero. */
 	if (!fir->length)
 		return x;
 
-	/* Write sample to delay */
-	*data = x;
+	return fir_32x16_sample(fir, fir->coef, x);
+}
 
-	/* Advance write pointer and calculate into n1 max. number of taps
-	 * to process before circular wrap.
-	 */
-	n1 = ++fir->rwi;
-	if (fir->rwi == fir->length)
-		fir->rwi = 0;
-
-	/* Check if no need to un-wrap FIR data. */
-	if (n1 > fir->length) {
-		/* Data is Q1.31, coef is Q1.15, product is Q2.46 */
-		for (n = 0; n < fir->length; n++) {
-			y += (int64_t)(*coef) * (*data);
-			coef++;
-			data--;
-		}
+void fir_32x16_block(struct fir_state_32x16 fir[], const int32_t *x,
+		     int32_t *y, int frames, int nch)
+{
+	struct fir_state_32x16 *filter;
+	const int16_t *coef;
+	int ch;
+	int i;
 
-		/* Q2.46 -> Q2.31, saturate to Q1.31 */
-		return sat_int32(y >> (15 + fir->out_shift));
-	}
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fir[ch];
+		coef = filter->coef;
 
-	/* Part 1, loop n1 times */
-	for (n = 0; n < n1; n++) {
-		y += (int64_t)(*coef) * (*data);
-		coef++;
-		data--;
-	}
+		/* Bypass is set with length set to zero. */
+		if (!filter->length) {
+			for (i = ch; i < frames * nch; i += nch)
+				y[i] = x[i];
 
-	/* Part 2, un-wrap data, continue n2 times */
-	n2 = fir->length - n1;
-	data = &fir->delay[fir->length - 1];
-	for (n = 0; n < n2; n++) {
-		y += (int64_t)(*coef) * (*data);
-		coef++;
-		data--;
-	}
+			continue;
+		}
 
-	/* Q2.46 -> Q2.31, saturate to Q1.31 */
-	return sat_int32(y >> (15 + fir->out_shift));
+		for (i = ch; i < frames * nch; i += nch)
+			y[i] = fir_32x16_sample(filter, coef, x[i]);
+	}
 }
 
 #endif
@@ -8,6 +8,8 @@
 
 #include <sof/audio/format.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
 #include <user/eq.h>
 #include <errno.h>
 #include <stddef.h>
@@ -104,4 +106,219 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Size of work buffers for the parallel sections of block processing */
+#define IIR_DF2T_BLOCK_SAMPLES	64
+
+/* Computes one biquad in-place for a block of samples. The coefficients
+ * and delays are kept in local variables for the whole block.
+ */
+static void iir_df2t_biquad_block(const int32_t *coef, int64_t *delay,
+				  int32_t *data, int samples)
+{
+	int64_t acc;
+	int64_t d0 = delay[0];
+	int64_t d1 = delay[1];
+	int32_t a2 = coef[0];
+	int32_t a1 = coef[1];
+	int32_t b2 = coef[2];
+	int32_t b1 = coef[3];
+	int32_t b0 = coef[4];
+	int32_t gain = coef[6];
+	int shift = 45 + coef[5];
+	int32_t in;
+	int32_t tmp;
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		in = data[i];
+		acc = (int64_t)b0 * in + d0;
+		tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+		d0 = d1 + (int64_t)b1 * in + (int64_t)a1 * tmp;
+		d1 = (int64_t)b2 * in + (int64_t)a2 * tmp;
+		acc = (int64_t)gain * tmp;
+		data[i] = sat_int32(Q_SHIFT_RND(acc, shift, 31));
+	}
+
+	delay[0] = d0;
+	delay[1] = d1;
+}
+
+/* Computes one biquad in-place for a block of interleaved frames. The same
+ * biquad of every channel is computed in the inner loop.
+ */
+static void iir_df2t_biquad_block_nch(struct iir_state_df2t iir[], int c,
+				      int d, int32_t *data, int frames,
+				      int nch)
+{
+	int64_t d0[PLATFORM_MAX_CHANNELS];
+	int64_t d1[PLATFORM_MAX_CHANNELS];
+	int32_t a2[PLATFORM_MAX_CHANNELS];
+	int32_t a1[PLATFORM_MAX_CHANNELS];
+	int32_t b2[PLATFORM_MAX_CHANNELS];
+	int32_t b1[PLATFORM_MAX_CHANNELS];
+	int32_t b0[PLATFORM_MAX_CHANNELS];
+	int32_t gain[PLATFORM_MAX_CHANNELS];
+	int shift[PLATFORM_MAX_CHANNELS];
+	int64_t acc;
+	int32_t in;
+	int32_t tmp;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++) {
+		d0[ch] = iir[ch].delay[d];
+		d1[ch] = iir[ch].delay[d + 1];
+		a2[ch] = iir[ch].coef[c];
+		a1[ch] = iir[ch].coef[c + 1];
+		b2[ch] = iir[ch].coef[c + 2];
+		b1[ch] = iir[ch].coef[c + 3];
+		b0[ch] = iir[ch].coef[c + 4];
+		shift[ch] = 45 + iir[ch].coef[c + 5];
+		gain[ch] = iir[ch].coef[c + 6];
+	}
+
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < nch; ch++) {
+			in = data[ch];
+			acc = (int64_t)b0[ch] * in + d0[ch];
+			tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+			d0[ch] = d1[ch] + (int64_t)b1[ch] * in +
+				(int64_t)a1[ch] * tmp;
+			d1[ch] = (int64_t)b2[ch] * in + (int64_t)a2[ch] * tmp;
+			acc = (int64_t)gain[ch] * tmp;
+			data[ch] = sat_int32(Q_SHIFT_RND(acc, shift[ch], 31));
+		}
+		data += nch;
+	}
+
+	for (ch = 0; ch < nch; ch++) {
+		iir[ch].delay[d] = d0[ch];
+		iir[ch].delay[d + 1] = d1[ch];
+	}
+}
+
+/* Computes in-place the biquads in series of a section that starts from
+ * coefficients index c and delays index d. All filters in iir[] have the
+ * same structure.
+ */
+static void iir_df2t_section_block(struct iir_state_df2t iir[], int c, int d,
+				   int32_t *data, int frames, int nch)
+{
+	int i;
+
+	for (i = 0; i < iir->biquads_in_series; i++) {
+		if (nch == 1)
+			iir_df2t_biquad_block(&iir->coef[c], &iir->delay[d],
+					      data, frames);
+		else
+			iir_df2t_biquad_block_nch(iir, c, d, data, frames,
+						  nch);
+
+		c += SOF_EQ_IIR_NBIQUAD_DF2T;
+		d += IIR_DF2T_NUM_DELAYS;
+	}
+}
+
+/* Filters interleaved frames with filters that have the same structure */
+static void iir_df2t_sections_block(struct iir_state_df2t iir[],
+				    const int32_t *x, int32_t *y, int frames,
+				    int nch)
+{
+	int32_t sec[IIR_DF2T_BLOCK_SAMPLES];
+	int32_t out[IIR_DF2T_BLOCK_SAMPLES];
+	int max_frames = IIR_DF2T_BLOCK_SAMPLES / nch;
+	int c;
+	int d;
+	int i;
+	int j;
+	int n;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads) {
+		if (x != y)
+			for (i = 0; i < frames * nch; i++)
+				y[i] = x[i];
+		return;
+	}
+
+	/* A single section is filtered in-place in the output */
+	if (iir->biquads == iir->biquads_in_series) {
+		if (x != y)
+			for (i = 0; i < frames * nch; i++)
+				y[i] = x[i];
+
+		iir_df2t_section_block(iir, 0, 0, y, frames, nch);
+		return;
+	}
+
+	/* The sections are computed in series and the output of every
+	 * section is summed to output in a work buffer.
+	 */
+	while (frames) {
+		n = MIN(frames, max_frames);
+		for (i = 0; i < n * nch; i++) {
+			sec[i] = x[i];
+			out[i] = 0;
+		}
+
+		c = 0;
+		d = 0;
+		for (j = 0; j < iir->biquads; j += iir->biquads_in_series) {
+			iir_df2t_section_block(iir, c, d, sec, n, nch);
+			for (i = 0; i < n * nch; i++)
+				out[i] = sat_int32((int64_t)out[i] + sec[i]);
+
+			c += iir->biquads_in_series * SOF_EQ_IIR_NBIQUAD_DF2T;
+			d += iir->biquads_in_series * IIR_DF2T_NUM_DELAYS;
+		}
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = out[i];
+
+		frames -= n;
+		x += n * nch;
+		y += n * nch;
+	}
+}
+
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *x, int32_t *y,
+		    int samples)
+{
+	iir_df2t_sections_block(iir, x, y, samples, 1);
+}
+
+void iir_df2t_block_nch(struct iir_state_df2t iir[], const int32_t *x,
+			int32_t *y, int frames, int nch)
+{
+	int32_t buf[IIR_DF2T_BLOCK_SAMPLES];
+	int ch;
+	int i;
+	int k;
+	int n;
+
+	for (ch = 1; ch < nch; ch++) {
+		if (iir[ch].biquads != iir[0].biquads ||
+		    iir[ch].biquads_in_series != iir[0].biquads_in_series)
+			break;
+	}
+
+	if (ch == nch) {
+		iir_df2t_sections_block(iir, x, y, frames, nch);
+		return;
+	}
+
+	/* Filters of different structure are run one channel at a time */
+	for (ch = 0; ch < nch; ch++) {
+		for (k = 0; k < frames; k += n) {
+			n = MIN(frames - k, IIR_DF2T_BLOCK_SAMPLES);
+			for (i = 0; i < n; i++)
+				buf[i] = x[(k + i) * nch + ch];
+
+			iir_df2t_block(&iir[ch], buf, buf, n);
+			for (i = 0; i < n; i++)
+				y[(k + i) * nch + ch] = buf[i];
+		}
+	}
+}
+
 #endif
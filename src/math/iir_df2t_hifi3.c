@@ -131,4 +131,29 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Block processing with the HiFi3 single sample version of the filter */
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *x, int32_t *y,
+		    int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		y[i] = iir_df2t(iir, x[i]);
+}
+
+void iir_df2t_block_nch(struct iir_state_df2t iir[], const int32_t *x,
+			int32_t *y, int frames, int nch)
+{
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < nch; ch++)
+			y[ch] = iir_df2t(&iir[ch], x[ch]);
+
+		x += nch;
+		y += nch;
+	}
+}
+
 #endif
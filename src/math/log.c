@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/log.h>
+#include <stdint.h>
+
+/* The mantissa is split to LOG_TABLE_SIZE segments. Inside a segment the
+ * functions are approximated with 4th order polynomials.
+ */
+#define LOG_TABLE_BITS	5
+#define LOG_TABLE_SIZE	(1 << LOG_TABLE_BITS)
+
+/* log2(1 + i / LOG_TABLE_SIZE) as Q2.30 */
+static const int32_t log2_table[LOG_TABLE_SIZE] = {
+	0, 47667823, 93912511, 138816582,
+	182455581, 224898839, 266210141, 306448299,
+	345667660, 383918542, 421247625, 457698295,
+	493310944, 528123241, 562170370, 595485245,
+	628098702, 660039669, 691335320, 722011213,
+	752091421, 781598637, 810554283, 838978604,
+	866890747, 894308843, 921250079, 947730758,
+	973766362, 999371606, 1024560487, 1049346328,
+};
+
+/* 1 / (1 + i / LOG_TABLE_SIZE) as Q2.30 */
+static const int32_t log2_inv_table[LOG_TABLE_SIZE] = {
+	1073741824, 1041204193, 1010580540, 981706811,
+	954437177, 928641578, 904203641, 881018933,
+	858993459, 838042399, 818089009, 799063683,
+	780903145, 763549742, 746950834, 731058263,
+	715827883, 701219150, 687194767, 673720360,
+	660764199, 648296950, 636291451, 624722516,
+	613566757, 602802428, 592409282, 582368447,
+	572662306, 563274399, 554189329, 545392673,
+};
+
+/* 2^(i / LOG_TABLE_SIZE) as Q2.30 */
+static const int32_t exp2_table[LOG_TABLE_SIZE] = {
+	1073741824, 1097253708, 1121280436, 1145833280,
+	1170923762, 1196563654, 1222764986, 1249540052,
+	1276901417, 1304861917, 1333434672, 1362633090,
+	1392470869, 1422962010, 1454120821, 1485961921,
+	1518500250, 1551751076, 1585730000, 1620452965,
+	1655936265, 1692196547, 1729250827, 1767116489,
+	1805811301, 1845353420, 1885761398, 1927054196,
+	1969251188, 2012372174, 2056437387, 2101467502,
+};
+
+/* Taylor series coefficients of log2(1 + u) as Q2.30 */
+#define LOG2_C1	1549082005 /* 1 / ln(2) */
+#define LOG2_C2	-774541002 /* -1 / (2 * ln(2)) */
+#define LOG2_C3	516360668 /* 1 / (3 * ln(2)) */
+#define LOG2_C4	-387270501 /* -1 / (4 * ln(2)) */
+
+/* Taylor series coefficients of 2^r as Q2.30 */
+#define EXP2_C1	744261118 /* ln(2) */
+#define EXP2_C2	257941248 /* ln(2)^2 / 2 */
+#define EXP2_C3	59597083 /* ln(2)^3 / 6 */
+#define EXP2_C4	10327387 /* ln(2)^4 / 24 */
+
+#define ONE_Q30	(1 << 30)
+
+/* Q2.30 x Q2.30 -> Q2.30 */
+static inline int32_t log_mult_q30(int32_t a, int32_t b)
+{
+	return (int32_t)Q_MULTSR_32X32((int64_t)a, b, 30, 30, 30);
+}
+
+/* The argument is normalized to m * 2^e with mantissa m in 1.0 .. 2.0.
+ * The mantissa segment i starts from s = 1 + i / LOG_TABLE_SIZE and
+ * log2(m) = log2(s) + log2(1 + u) where u = (m - s) / s is less than
+ * 1 / LOG_TABLE_SIZE. The max. error is about 1e-8.
+ */
+int32_t log2_fixed(uint32_t x)
+{
+	int64_t y;
+	uint32_t m = x;
+	int32_t u;
+	int32_t p;
+	int e = 31;
+	int i;
+
+	if (!x)
+		return INT32_MIN;
+
+	/* Normalize to Q1.31 mantissa */
+	if (!(m & 0xffff0000)) {
+		m <<= 16;
+		e -= 16;
+	}
+	if (!(m & 0xff000000)) {
+		m <<= 8;
+		e -= 8;
+	}
+	if (!(m & 0xf0000000)) {
+		m <<= 4;
+		e -= 4;
+	}
+	if (!(m & 0xc0000000)) {
+		m <<= 2;
+		e -= 2;
+	}
+	if (!(m & 0x80000000)) {
+		m <<= 1;
+		e -= 1;
+	}
+
+	/* Q1.31 remainder in segment multiplied by Q2.30 inverse */
+	i = (m >> (31 - LOG_TABLE_BITS)) & (LOG_TABLE_SIZE - 1);
+	u = (int32_t)(((uint64_t)(m & ((1U << (31 - LOG_TABLE_BITS)) - 1)) *
+		       log2_inv_table[i]) >> 31);
+
+	p = log_mult_q30(u, LOG2_C4) + LOG2_C3;
+	p = log_mult_q30(u, p) + LOG2_C2;
+	p = log_mult_q30(u, p) + LOG2_C1;
+	p = log_mult_q30(u, p);
+
+	/* Integer part and Q2.30 fraction to Q6.26 */
+	y = ((int64_t)e << 26) + Q_SHIFT_RND(log2_table[i] + p, 30, 26);
+	return sat_int32(y);
+}
+
+/* The argument is split to integer k, table index i and remainder r so
+ * that 2^x = 2^k * 2^(i / LOG_TABLE_SIZE) * 2^r.
+ */
+int32_t exp2_fixed(int32_t x)
+{
+	int64_t y;
+	int32_t r;
+	int32_t p;
+	int k;
+	int i;
+
+	/* 2^1 does not fit to Q2.30 and less than 2^-31 rounds to zero */
+	if (x >= (1 << 26))
+		return INT32_MAX;
+
+	if (x < -(31 << 26))
+		return 0;
+
+	k = x >> 26;
+	i = (x >> (26 - LOG_TABLE_BITS)) & (LOG_TABLE_SIZE - 1);
+	r = (x & ((1 << (26 - LOG_TABLE_BITS)) - 1)) << 4; /* Q2.30 */
+
+	p = log_mult_q30(r, EXP2_C4) + EXP2_C3;
+	p = log_mult_q30(r, p) + EXP2_C2;
+	p = log_mult_q30(r, p) + EXP2_C1;
+	p = log_mult_q30(r, p) + ONE_Q30;
+
+	/* Q2.30 x Q2.30 -> Q2.30 and scale with 2^k, k is zero or negative */
+	y = (int64_t)exp2_table[i] * p;
+	y = Q_SHIFT_RND(y, 60 - k, 30);
+	return sat_int32(y);
+}
+
+int32_t pow_fixed(int32_t x, int32_t y)
+{
+	int64_t t;
+
+	if (x <= 0)
+		return 0;
+
+	/* log2(x) of Q2.30 x as Q6.26, product with Q2.30 y as Q6.26 */
+	t = (int64_t)log2_fixed(x) - (30 << 26);
+	t = Q_MULTSR_32X32(t, y, 26, 30, 26);
+	if (t >= (1 << 26))
+		return INT32_MAX;
+
+	if (t < -(31LL << 26))
+		return 0;
+
+	return exp2_fixed((int32_t)t);
+}
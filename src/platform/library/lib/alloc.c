@@ -11,36 +11,192 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <malloc.h>
+#include <sof/common.h>
+#include <sof/list.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/mm_heap.h>
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+/* allocation charged to a usage */
+struct usage_tag {
+	struct list_item list;
+	void *ptr;
+	struct mm_usage *usage;
+	int zone;
+	size_t bytes;
+};
+
+static struct list_item usage_list = { &usage_list, &usage_list };
+static struct list_item tag_list = { &tag_list, &tag_list };
+static struct mm_usage *usage_active;
+
+static void usage_untag(void *ptr)
+{
+	struct usage_tag *tag;
+	struct list_item *tlist;
+	struct mm_usage *usage;
+
+	if (!ptr)
+		return;
+
+	list_for_item(tlist, &tag_list) {
+		tag = container_of(tlist, struct usage_tag, list);
+		if (tag->ptr != ptr)
+			continue;
+
+		usage = tag->usage;
+		mm_usage_charge(usage, tag->zone, -(int32_t)tag->bytes);
+		list_item_del(&tag->list);
+		free(tag);
+
+		if (!--usage->live && usage->orphan) {
+			list_item_del(&usage->list);
+			free(usage);
+		}
+		return;
+	}
+}
+
+static void *usage_tag(void *ptr, enum mem_zone zone, size_t bytes)
+{
+	struct usage_tag *tag;
+
+	/* memory released with free() may come back at the same address */
+	usage_untag(ptr);
+
+	if (!ptr || !usage_active)
+		return ptr;
+
+	tag = malloc(sizeof(*tag));
+	if (!tag)
+		return ptr;
+
+	/* same zones as firmware heaps */
+	if (zone == SOF_MEM_ZONE_RUNTIME_SHARED)
+		zone = SOF_MEM_ZONE_RUNTIME;
+	else if (zone == SOF_MEM_ZONE_SYS_SHARED)
+		zone = SOF_MEM_ZONE_SYS;
+
+	tag->ptr = ptr;
+	tag->usage = usage_active;
+	tag->zone = zone;
+	tag->bytes = bytes;
+	list_item_append(&tag->list, &tag_list);
+
+	usage_active->live++;
+	mm_usage_charge(usage_active, zone, bytes);
+
+	return ptr;
+}
+
+struct mm_usage *mm_usage_new(enum mm_usage_owner owner, uint32_t id,
+			      uint32_t pipeline_id)
+{
+	struct mm_usage *usage = calloc(1, sizeof(*usage));
+
+	if (!usage)
+		return NULL;
+
+	usage->info.owner = owner;
+	usage->info.id = id;
+	usage->info.pipeline_id = pipeline_id;
+	list_item_append(&usage->list, &usage_list);
+	mm_usage_link(&usage_list, usage);
+
+	return usage;
+}
+
+void mm_usage_free(struct mm_usage *usage)
+{
+	if (!usage)
+		return;
+
+	if (usage_active == usage)
+		usage_active = NULL;
+
+	if (usage->info.owner == MM_USAGE_PIPELINE)
+		mm_usage_unlink(&usage_list, usage);
+
+	if (usage->live) {
+		usage->orphan = true;
+		return;
+	}
+
+	list_item_del(&usage->list);
+	free(usage);
+}
+
+struct mm_usage *mm_usage_use(struct mm_usage *usage)
+{
+	struct mm_usage *prev = usage_active;
+
+	usage_active = usage;
+
+	return prev;
+}
+
+int mm_usage_get(struct mm_usage_info *info, int count)
+{
+	struct mm_usage *usage;
+	struct list_item *ulist;
+	int n = 0;
+
+	list_for_item(ulist, &usage_list) {
+		usage = container_of(ulist, struct mm_usage, list);
+		if (n < count)
+			info[n] = usage->info;
+		n++;
+	}
+
+	return n;
+}
+#else
+static inline void usage_untag(void *ptr) { }
+
+static inline void *usage_tag(void *ptr, enum mem_zone zone, size_t bytes)
+{
+	return ptr;
+}
+#endif
+
 /* testbench mem alloc definition */
 
 void *rmalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	return usage_tag(malloc(bytes), zone, bytes);
 }
 
 void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return calloc(bytes, 1);
+	return usage_tag(calloc(bytes, 1), zone, bytes);
 }
 
 void rfree(void *ptr)
 {
+	usage_untag(ptr);
 	free(ptr);
 }
 
 void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
 		    uint32_t alignment)
 {
-	return malloc(bytes);
+	return usage_tag(malloc(bytes), SOF_MEM_ZONE_BUFFER, bytes);
 }
 
 void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 		      size_t old_bytes, uint32_t alignment)
 {
-	return realloc(ptr, bytes);
+	void *new_ptr;
+
+	usage_untag(ptr);
+	new_ptr = realloc(ptr, bytes);
+	if (!new_ptr) {
+		/* old block is still in use */
+		usage_tag(ptr, SOF_MEM_ZONE_BUFFER, old_bytes);
+		return NULL;
+	}
+
+	return usage_tag(new_ptr, SOF_MEM_ZONE_BUFFER, bytes);
 }
 
 void heap_trace(struct mm_heap *heap, int size)
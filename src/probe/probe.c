@@ -659,6 +659,10 @@ static uint32_t probe_gen_format(uint32_t frame_fmt, uint32_t rate,
 		valid_bytes = 3;
 		container_bytes = 4;
 		break;
+	case SOF_IPC_FRAME_S24_3LE:
+		valid_bytes = 3;
+		container_bytes = 3;
+		break;
 	case SOF_IPC_FRAME_S32_LE:
 		valid_bytes = 4;
 		container_bytes = 4;
@@ -887,6 +891,59 @@ err:
 	tr_err(&pr_tr, "probe_cb_produce(): failed to generate probe data");
 }
 
+/**
+ * \brief Removes probe points and cancels the probe task if no extraction
+ *	  probe is left.
+ * \param[in] count number of buffers.
+ * \param[in] buffer_id ids of the buffers.
+ * \param[in] unsubscribe drop the buffer subscriptions, the buffer free
+ *	      callback can't do it and the buffer drops them itself.
+ */
+static int probe_point_release(uint32_t count, uint32_t *buffer_id,
+			       bool unsubscribe)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct ipc_comp_dev *dev;
+	uint32_t i;
+	uint32_t j;
+
+	tr_dbg(&pr_tr, "probe_point_remove() count = %u", count);
+
+	if (!_probe) {
+		tr_err(&pr_tr, "probe_point_remove(): Not initialized.");
+		return -EINVAL;
+	}
+	/* remove each requested probe point */
+	for (i = 0; i < count; i++) {
+		tr_dbg(&pr_tr, "\tbuffer_id[%u] = %u", i, buffer_id[i]);
+
+		for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
+			if (_probe->probe_points[j].stream_tag != PROBE_POINT_INVALID &&
+			    _probe->probe_points[j].buffer_id == buffer_id[i]) {
+				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
+				if (dev && unsubscribe)
+					notifier_obj_unregister_all(_probe,
+								    &dev->cb->cb_list,
+								    dev->cb->lock);
+
+				_probe->probe_points[j].stream_tag =
+					PROBE_POINT_INVALID;
+			}
+		}
+	}
+	for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
+		if (_probe->probe_points[j].stream_tag != PROBE_DMA_INVALID &&
+		    _probe->probe_points[j].purpose == PROBE_PURPOSE_EXTRACTION)
+			break;
+	}
+	if (j == CONFIG_PROBE_POINTS_MAX) {
+		tr_dbg(&pr_tr, "probe_point_remove(): cancel probe task");
+		schedule_task_cancel(&_probe->dmap_work);
+	}
+
+	return 0;
+}
+
 /**
  * \brief Callback for buffer free, it will remove probe point.
  * \param[in] arg pointer (not used).
@@ -901,9 +958,9 @@ static void probe_cb_free(void *arg, enum notify_id type, void *data)
 
 	tr_dbg(&pr_tr, "probe_cb_free() buffer_id = %u", buffer_id);
 
-	ret = probe_point_remove(1, &buffer_id);
+	ret = probe_point_release(1, &buffer_id, false);
 	if (ret < 0)
-		tr_err(&pr_tr, "probe_cb_free(): probe_point_remove() failed");
+		tr_err(&pr_tr, "probe_cb_free(): probe_point_release() failed");
 }
 
 int probe_point_add(uint32_t count, struct probe_point *probe)
@@ -1038,10 +1095,11 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 		_probe->probe_points[first_free].stream_tag =
 			probe[i].stream_tag;
 
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
-				  &probe_cb_produce, 0);
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE,
-				  &probe_cb_free, 0);
+		notifier_obj_register(_probe, &dev->cb->cb_list, dev->cb->lock,
+				      NOTIFIER_ID_BUFFER_PRODUCE,
+				      &probe_cb_produce);
+		notifier_obj_register(_probe, &dev->cb->cb_list, dev->cb->lock,
+				      NOTIFIER_ID_BUFFER_FREE, &probe_cb_free);
 	}
 
 	return 0;
@@ -1086,46 +1144,5 @@ int probe_point_info(struct sof_ipc_probe_info_params *data, uint32_t max_size)
 
 int probe_point_remove(uint32_t count, uint32_t *buffer_id)
 {
-	struct probe_pdata *_probe = probe_get();
-	struct ipc_comp_dev *dev;
-	uint32_t i;
-	uint32_t j;
-
-	tr_dbg(&pr_tr, "probe_point_remove() count = %u", count);
-
-	if (!_probe) {
-		tr_err(&pr_tr, "probe_point_remove(): Not initialized.");
-		return -EINVAL;
-	}
-	/* remove each requested probe point */
-	for (i = 0; i < count; i++) {
-		tr_dbg(&pr_tr, "\tbuffer_id[%u] = %u", i, buffer_id[i]);
-
-		for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
-			if (_probe->probe_points[j].stream_tag != PROBE_POINT_INVALID &&
-			    _probe->probe_points[j].buffer_id == buffer_id[i]) {
-				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
-				if (dev) {
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_PRODUCE);
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_FREE);
-				}
-
-				_probe->probe_points[j].stream_tag =
-					PROBE_POINT_INVALID;
-			}
-		}
-	}
-	for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
-		if (_probe->probe_points[j].stream_tag != PROBE_DMA_INVALID &&
-		    _probe->probe_points[j].purpose == PROBE_PURPOSE_EXTRACTION)
-			break;
-	}
-	if (j == CONFIG_PROBE_POINTS_MAX) {
-		tr_dbg(&pr_tr, "probe_point_remove(): cancel probe task");
-		schedule_task_cancel(&_probe->dmap_work);
-	}
-
-	return 0;
+	return probe_point_release(count, buffer_id, true);
 }
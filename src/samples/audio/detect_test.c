@@ -592,7 +592,6 @@ static int test_keyword_copy(struct comp_dev *dev)
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *source;
 	uint32_t frames;
-	uint32_t flags = 0;
 
 	comp_dbg(dev, "test_keyword_copy()");
 
@@ -600,12 +599,12 @@ static int test_keyword_copy(struct comp_dev *dev)
 	source = list_first_item(&dev->bsource_list,
 				 struct comp_buffer, sink_list);
 
-	if (!source->stream.avail)
+	buffer_state_invalidate(source);
+
+	if (!audio_stream_get_data_bytes(&source->stream))
 		return PPL_STATUS_PATH_STOP;
 
-	buffer_lock(source, &flags);
 	frames = audio_stream_get_avail_frames(&source->stream);
-	buffer_unlock(source, flags);
 
 	/* copy and perform detection */
 	buffer_invalidate(source, audio_stream_get_avail_bytes(&source->stream));
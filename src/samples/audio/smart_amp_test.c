@@ -417,27 +417,21 @@ static int smart_amp_copy(struct comp_dev *dev)
 	uint32_t source_bytes;
 	uint32_t sink_bytes;
 	uint32_t feedback_bytes;
-	uint32_t source_flags = 0;
-	uint32_t sink_flags = 0;
-	uint32_t feedback_flags = 0;
 	int ret = 0;
 
 	comp_dbg(dev, "smart_amp_copy()");
 
-	buffer_lock(sad->source_buf, &source_flags);
-	buffer_lock(sad->sink_buf, &sink_flags);
+	buffer_state_invalidate(sad->source_buf);
+	buffer_state_invalidate(sad->sink_buf);
 
 	/* available bytes and samples calculation */
 	avail_passthrough_frames =
 		audio_stream_avail_frames(&sad->source_buf->stream,
 					  &sad->sink_buf->stream);
 
-	buffer_unlock(sad->source_buf, source_flags);
-	buffer_unlock(sad->sink_buf, sink_flags);
-
 	avail_frames = avail_passthrough_frames;
 
-	buffer_lock(sad->feedback_buf, &feedback_flags);
+	buffer_state_invalidate(sad->feedback_buf);
 	if (comp_get_state(dev, sad->feedback_buf->source) == dev->state) {
 		/* feedback */
 		avail_feedback_frames = audio_stream_get_avail_frames(&sad->feedback_buf->stream);
@@ -448,8 +442,6 @@ static int smart_amp_copy(struct comp_dev *dev)
 		feedback_bytes = avail_frames *
 			audio_stream_frame_bytes(&sad->feedback_buf->stream);
 
-		buffer_unlock(sad->feedback_buf, feedback_flags);
-
 		comp_dbg(dev, "smart_amp_copy(): processing %d feedback frames (avail_passthrough_frames: %d)",
 			 avail_frames, avail_passthrough_frames);
 
@@ -460,20 +452,14 @@ static int smart_amp_copy(struct comp_dev *dev)
 			     sad->config.feedback_ch_map);
 
 		comp_update_buffer_consume(sad->feedback_buf, feedback_bytes);
-	} else {
-		buffer_unlock(sad->feedback_buf, feedback_flags);
 	}
 
 	/* bytes calculation */
-	buffer_lock(sad->source_buf, &source_flags);
 	source_bytes = avail_frames *
 		audio_stream_frame_bytes(&sad->source_buf->stream);
-	buffer_unlock(sad->source_buf, source_flags);
 
-	buffer_lock(sad->sink_buf, &sink_flags);
 	sink_bytes = avail_frames *
 		audio_stream_frame_bytes(&sad->sink_buf->stream);
-	buffer_unlock(sad->sink_buf, sink_flags);
 
 	/* process data */
 	buffer_invalidate(sad->source_buf, source_bytes);
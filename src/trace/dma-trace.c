@@ -5,27 +5,30 @@
 // Author: Yan Wang <yan.wang@linux.intel.com>
 
 #include <sof/audio/buffer.h>
+#include <sof/barrier.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
 #include <sof/lib/uuid.h>
 #include <sof/platform.h>
 #include <sof/schedule/ll_schedule.h>
 #include <sof/schedule/schedule.h>
 #include <sof/schedule/task.h>
 #include <sof/sof.h>
-#include <sof/spinlock.h>
 #include <sof/string.h>
 #include <sof/trace/dma-trace.h>
 #include <ipc/topology.h>
 #include <ipc/trace.h>
 #include <kernel/abi.h>
 #include <user/abi_dbg.h>
+#include <user/trace.h>
 #include <version.h>
 
 #include <errno.h>
@@ -45,21 +48,29 @@ DECLARE_SOF_UUID("dma-trace-task", dma_trace_task_uuid, 0x2b972272, 0xc5b1,
 static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
+static void dma_trace_merge(struct dma_trace_data *d);
 
 static enum task_state trace_work(void *data)
 {
 	struct dma_trace_data *d = data;
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
-	unsigned long flags;
-	uint32_t avail = buffer->avail;
+	uint32_t avail;
 	int32_t size;
 	uint32_t overflow;
 
+	/* move the entries of all cores in timestamp order to local buffer */
+	dma_trace_merge(d);
+	avail = buffer->avail;
+
 	/* make sure we don't write more than buffer */
 	if (avail > DMA_TRACE_LOCAL_SIZE) {
 		overflow = avail - DMA_TRACE_LOCAL_SIZE;
 		avail = DMA_TRACE_LOCAL_SIZE;
+#if CONFIG_TRACE_COMPACT
+		/* the host misses entries, resync the decoder */
+		d->compact.count = 0;
+#endif
 	} else {
 		overflow = 0;
 	}
@@ -99,8 +110,6 @@ static enum task_state trace_work(void *data)
 		buffer->r_ptr = (char *)buffer->r_ptr - DMA_TRACE_LOCAL_SIZE;
 
 out:
-	spin_lock_irq(&d->lock, flags);
-
 	/* disregard any old messages and don't resend them if we overflow */
 	if (size > 0) {
 		if (d->posn.overflow)
@@ -114,8 +123,6 @@ out:
 
 	platform_shared_commit(d, sizeof(*d));
 
-	spin_unlock_irq(&d->lock, flags);
-
 	/* reschedule the trace copying work */
 	return SOF_TASK_STATE_RESCHEDULE;
 }
@@ -124,7 +131,6 @@ int dma_trace_init_early(struct sof *sof)
 {
 	sof->dmat = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*sof->dmat));
 	dma_sg_init(&sof->dmat->config.elem_array);
-	spinlock_init(&sof->dmat->lock);
 
 	ipc_build_trace_posn(&sof->dmat->posn);
 	sof->dmat->msg = ipc_msg_init(sof->dmat->posn.rhdr.hdr.cmd,
@@ -186,8 +192,9 @@ int dma_trace_host_buffer(struct dma_trace_data *d,
 static int dma_trace_buffer_init(struct dma_trace_data *d)
 {
 	struct dma_trace_buf *buffer = &d->dmatb;
+	char *rings = d->cores[0].addr;
 	void *buf;
-	unsigned int flags;
+	int i;
 
 	/* allocate new buffer */
 	buf = rballoc(0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_DMA,
@@ -197,11 +204,25 @@ static int dma_trace_buffer_init(struct dma_trace_data *d)
 		return -ENOMEM;
 	}
 
+	/* core rings are kept over trace restarts */
+	if (!rings) {
+		rings = rballoc(0, SOF_MEM_CAPS_RAM,
+				DMA_TRACE_CORE_SIZE * CONFIG_CORE_COUNT);
+		if (!rings) {
+			tr_err(&dt_tr, "dma_trace_buffer_init(): rings alloc failed");
+			rfree(buf);
+			return -ENOMEM;
+		}
+	}
+
 	bzero(buf, DMA_TRACE_LOCAL_SIZE);
 	dcache_writeback_region(buf, DMA_TRACE_LOCAL_SIZE);
 
-	/* initialise the DMA buffer, whole sequence in section */
-	spin_lock_irq(&d->lock, flags);
+	/* initialise the rings before the buffer enables the tracing */
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		d->cores[i].addr = rings + i * DMA_TRACE_CORE_SIZE;
+		d->cores[i].r_pos = d->cores[i].w_pos;
+	}
 
 	buffer->addr  = buf;
 	buffer->size = DMA_TRACE_LOCAL_SIZE;
@@ -210,7 +231,10 @@ static int dma_trace_buffer_init(struct dma_trace_data *d)
 	buffer->end_addr = (char *)buffer->addr + buffer->size;
 	buffer->avail = 0;
 
-	spin_unlock_irq(&d->lock, flags);
+#if CONFIG_TRACE_COMPACT
+	/* start with a sync entry */
+	d->compact.count = 0;
+#endif
 
 	return 0;
 }
@@ -368,6 +392,9 @@ void dma_trace_flush(void *t)
 		return;
 	}
 
+	/* pick up what the cores have written since the last trace_work() */
+	dma_trace_merge(trace_data);
+
 	buffer = &trace_data->dmatb;
 	avail = buffer->avail;
 
@@ -463,82 +490,338 @@ static int dtrace_calc_buf_overflow(struct dma_trace_buf *buffer,
 	return overflow;
 }
 
-static void dtrace_add_event(const char *e, uint32_t length)
+/* copies length bytes to local buffer, the space must have been checked */
+static void dtrace_buf_write(struct dma_trace_buf *buffer, const char *e,
+			     uint32_t length)
 {
-	struct dma_trace_data *trace_data = dma_trace_data_get();
-	struct dma_trace_buf *buffer = &trace_data->dmatb;
-	uint32_t margin;
-	uint32_t overflow;
+	uint32_t margin = dtrace_calc_buf_margin(buffer);
 	int ret;
 
-	margin = dtrace_calc_buf_margin(buffer);
-	overflow = dtrace_calc_buf_overflow(buffer, length);
-
-	/* tracing dropped entries */
-	if (trace_data->dropped_entries) {
-		if (!overflow) {
-			/*
-			 * if any dropped entries have appeared and there
-			 * is not any overflow, their amount will be logged
-			 */
-			uint32_t tmp_dropped_entries =
-				trace_data->dropped_entries;
-			trace_data->dropped_entries = 0;
-			/*
-			 * this trace_error invocation causes recursion,
-			 * so after it we have to recalculate margin and
-			 * overflow
-			 */
-			tr_err(&dt_tr, "dtrace_add_event(): number of dropped logs = %u",
-			       tmp_dropped_entries);
-			margin = dtrace_calc_buf_margin(buffer);
-			overflow = dtrace_calc_buf_overflow(buffer, length);
+	/* check for buffer wrap */
+	if (margin > length) {
+		/* no wrap */
+		dcache_invalidate_region(buffer->w_ptr, length);
+		ret = memcpy_s(buffer->w_ptr, length, e, length);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, length);
+		buffer->w_ptr = (char *)buffer->w_ptr + length;
+	} else {
+		/* data is bigger than remaining margin so we wrap */
+		dcache_invalidate_region(buffer->w_ptr, margin);
+		ret = memcpy_s(buffer->w_ptr, margin, e, margin);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, margin);
+		buffer->w_ptr = buffer->addr;
+
+		dcache_invalidate_region(buffer->w_ptr, length - margin);
+		ret = memcpy_s(buffer->w_ptr, length - margin,
+			       e + margin, length - margin);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, length - margin);
+		buffer->w_ptr = (char *)buffer->w_ptr + length - margin;
+	}
+
+	buffer->avail += length;
+}
+
+/* pointer to pos in core ring and number of bytes until ring end */
+static char *dtrace_ring_ptr(struct dma_trace_core_buf *ring, uint32_t pos,
+			     uint32_t *contiguous)
+{
+	uint32_t offset = pos & (DMA_TRACE_CORE_SIZE - 1);
+
+	*contiguous = DMA_TRACE_CORE_SIZE - offset;
+	return ring->addr + offset;
+}
+
+static void dtrace_ring_write(struct dma_trace_core_buf *ring, uint32_t pos,
+			      const void *src, uint32_t bytes)
+{
+	uint32_t contiguous;
+	char *dst = dtrace_ring_ptr(ring, pos, &contiguous);
+	uint32_t n = MIN(bytes, contiguous);
+	int ret;
+
+	ret = memcpy_s(dst, contiguous, src, n);
+	assert(!ret);
+	dcache_writeback_region(dst, n);
+
+	if (n < bytes) {
+		ret = memcpy_s(ring->addr, DMA_TRACE_CORE_SIZE,
+			       (const char *)src + n, bytes - n);
+		assert(!ret);
+		dcache_writeback_region(ring->addr, bytes - n);
+	}
+}
+
+static void dtrace_ring_read(struct dma_trace_core_buf *ring, uint32_t pos,
+			     void *dst, uint32_t bytes)
+{
+	uint32_t contiguous;
+	char *src = dtrace_ring_ptr(ring, pos, &contiguous);
+	uint32_t n = MIN(bytes, contiguous);
+	int ret;
+
+	dcache_invalidate_region(src, n);
+	ret = memcpy_s(dst, bytes, src, n);
+	assert(!ret);
+
+	if (n < bytes) {
+		dcache_invalidate_region(ring->addr, bytes - n);
+		ret = memcpy_s((char *)dst + n, bytes - n, ring->addr,
+			       bytes - n);
+		assert(!ret);
+	}
+}
+
+/* Copies the entry from core ring to local buffer as is */
+static int dtrace_copy_entry(struct dma_trace_data *d,
+			     struct dma_trace_core_buf *ring, uint32_t pos,
+			     uint32_t length)
+{
+	struct dma_trace_buf *buffer = &d->dmatb;
+	uint32_t contiguous;
+	char *src;
+
+	if (dtrace_calc_buf_overflow(buffer, length))
+		return -ENOSPC;
+
+	src = dtrace_ring_ptr(ring, pos, &contiguous);
+	if (length > contiguous) {
+		dcache_invalidate_region(src, contiguous);
+		dtrace_buf_write(buffer, src, contiguous);
+		dcache_invalidate_region(ring->addr, length - contiguous);
+		dtrace_buf_write(buffer, ring->addr, length - contiguous);
+	} else {
+		dcache_invalidate_region(src, length);
+		dtrace_buf_write(buffer, src, length);
+	}
+
+	return 0;
+}
+
+#if CONFIG_TRACE_COMPACT
+
+/* max. entry size from trace_log() and its max. compact size */
+#define DTRACE_ENTRY_MAX_SIZE	(sizeof(struct log_entry_header) + \
+				 _TRACE_EVENT_MAX_ARGUMENT_COUNT * \
+				 sizeof(uint32_t))
+#define DTRACE_COMPACT_MAX_SIZE	ALIGN_UP(3 + 2 * sizeof(uint32_t) + 10 + \
+					 2 * 2 + \
+					 _TRACE_EVENT_MAX_ARGUMENT_COUNT * 5, \
+					 sizeof(uint32_t))
+
+static uint8_t *dtrace_put_varint(uint8_t *p, uint64_t value)
+{
+	while (value >= 0x80) {
+		*p++ = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+
+	*p++ = value;
+
+	return p;
+}
+
+static uint8_t *dtrace_put_u32(uint8_t *p, uint32_t value)
+{
+	int i;
+
+	for (i = 0; i < sizeof(value); i++)
+		*p++ = value >> (8 * i);
+
+	return p;
+}
+
+/* encodes the entry and returns the padded size of the compact entry */
+static uint32_t dtrace_compact_encode(struct dma_trace_compact *c,
+				      const uint32_t *entry, uint32_t length,
+				      uint8_t *out)
+{
+	const struct log_entry_header *header = (const void *)entry;
+	const uint32_t *args = entry + sizeof(*header) / sizeof(uint32_t);
+	uint32_t nargs = (length - sizeof(*header)) / sizeof(uint32_t);
+	uint32_t slot = trace_compact_slot(header->log_entry_address);
+	int64_t delta = header->timestamp - c->timestamp;
+	uint8_t tag = TRACE_COMPACT_TAG | nargs << 1;
+	uint8_t *p = out;
+	int i;
+
+	/* sync entries let the decoder start anywhere in the stream */
+	if (!c->count) {
+		tag |= TRACE_COMPACT_SYNC;
+		bzero(c->dict, sizeof(c->dict));
+		c->count = TRACE_COMPACT_SYNC_PERIOD;
+	}
+	c->count--;
+	c->timestamp = header->timestamp;
+
+	*p++ = tag;
+	*p++ = header->core_id;
+
+	if (c->dict[slot].uid == header->uid &&
+	    c->dict[slot].log_entry_address == header->log_entry_address) {
+		*p++ = slot | TRACE_COMPACT_SLOT_HIT;
+	} else {
+		c->dict[slot].uid = header->uid;
+		c->dict[slot].log_entry_address = header->log_entry_address;
+		*p++ = slot;
+		p = dtrace_put_u32(p, header->uid);
+		p = dtrace_put_u32(p, header->log_entry_address);
+	}
+
+	if (tag & TRACE_COMPACT_SYNC)
+		p = dtrace_put_varint(p, header->timestamp);
+	else
+		p = dtrace_put_varint(p, ((uint64_t)delta << 1) ^
+				      (uint64_t)(delta >> 63));
+
+	p = dtrace_put_varint(p, header->id_0);
+	p = dtrace_put_varint(p, header->id_1);
+
+	for (i = 0; i < nargs; i++)
+		p = dtrace_put_varint(p, (args[i] << 1) ^
+				      (uint32_t)((int32_t)args[i] >> 31));
+
+	while ((p - out) % sizeof(uint32_t))
+		*p++ = 0;
+
+	return p - out;
+}
+
+/* Copies the entry from core ring to local buffer in compact encoding */
+static int dtrace_move_entry(struct dma_trace_data *d,
+			     struct dma_trace_core_buf *ring, uint32_t pos,
+			     uint32_t length)
+{
+	uint32_t entry[DTRACE_ENTRY_MAX_SIZE / sizeof(uint32_t)];
+	uint8_t out[DTRACE_COMPACT_MAX_SIZE];
+	uint32_t size;
+
+	/* other than trace_log() entries are sent as is */
+	if (length > sizeof(entry) ||
+	    length < sizeof(struct log_entry_header) ||
+	    (length - sizeof(struct log_entry_header)) % sizeof(uint32_t))
+		return dtrace_copy_entry(d, ring, pos, length);
+
+	/* check the space before the encoder state is updated */
+	if (dtrace_calc_buf_overflow(&d->dmatb, sizeof(out)))
+		return -ENOSPC;
+
+	dtrace_ring_read(ring, pos, entry, length);
+	size = dtrace_compact_encode(&d->compact, entry, length, out);
+	dtrace_buf_write(&d->dmatb, (const char *)out, size);
+
+	return 0;
+}
+
+#else
+
+static int dtrace_move_entry(struct dma_trace_data *d,
+			     struct dma_trace_core_buf *ring, uint32_t pos,
+			     uint32_t length)
+{
+	return dtrace_copy_entry(d, ring, pos, length);
+}
+
+#endif /* CONFIG_TRACE_COMPACT */
+
+/* Moves the entries of the core rings to local buffer oldest first. The
+ * entries of one core are already in order, so only the heads of the rings
+ * need to be compared.
+ */
+static void dma_trace_merge(struct dma_trace_data *d)
+{
+	struct dma_trace_core_buf *ring;
+	struct log_entry_header header;
+	uint64_t oldest = 0;
+	uint32_t length;
+	uint32_t dropped;
+	int core;
+	int i;
+
+#if CONFIG_TRACE_COMPACT
+	/* the first entry after dropped ones is a sync entry, so the decoder
+	 * can restart from it
+	 */
+	for (i = 0; i < CONFIG_CORE_COUNT; i++)
+		if (d->cores[i].dropped != d->cores[i].dropped_logged)
+			d->compact.count = 0;
+#endif
+
+	for (;;) {
+		core = -1;
+		for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+			ring = &d->cores[i];
+			if (ring->w_pos == ring->r_pos)
+				continue;
+
+			/* pairs with the release in dtrace_add_event() */
+			barrier_acquire();
+			dtrace_ring_read(ring, ring->r_pos + sizeof(length),
+					 &header, sizeof(header));
+			if (core < 0 || header.timestamp < oldest) {
+				oldest = header.timestamp;
+				core = i;
+			}
 		}
+
+		if (core < 0)
+			break;
+
+		/* keep the rest in the rings until the host has read more */
+		ring = &d->cores[core];
+		dtrace_ring_read(ring, ring->r_pos, &length, sizeof(length));
+		if (dtrace_move_entry(d, ring, ring->r_pos + sizeof(length),
+				      length) < 0)
+			break;
+
+		/* the entry is copied before its space is given back */
+		barrier_release();
+		ring->r_pos += sizeof(length) + ALIGN_UP(length,
+							 sizeof(uint32_t));
+		d->posn.messages++;
 	}
 
-	/* checking overflow */
-	if (!overflow) {
-		/* check for buffer wrap */
-		if (margin > length) {
-			/* no wrap */
-			dcache_invalidate_region(buffer->w_ptr, length);
-			ret = memcpy_s(buffer->w_ptr, length, e, length);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr, length);
-			buffer->w_ptr = (char *)buffer->w_ptr + length;
-		} else {
-			/* data is bigger than remaining margin so we wrap */
-			dcache_invalidate_region(buffer->w_ptr, margin);
-			ret = memcpy_s(buffer->w_ptr, margin, e, margin);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr, margin);
-			buffer->w_ptr = buffer->addr;
-
-			dcache_invalidate_region(buffer->w_ptr,
-						 length - margin);
-			ret = memcpy_s(buffer->w_ptr, length - margin,
-				       e + margin, length - margin);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr,
-						length - margin);
-			buffer->w_ptr = (char *)buffer->w_ptr + length - margin;
+	/* the report goes to the ring of this core and is merged next time */
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		ring = &d->cores[i];
+		dropped = ring->dropped - ring->dropped_logged;
+		if (dropped) {
+			ring->dropped_logged = ring->dropped;
+			tr_err(&dt_tr, "dma_trace_merge(): number of dropped logs = %u on core %d",
+			       dropped, i);
 		}
+	}
+}
 
-		buffer->avail += length;
-		trace_data->posn.messages++;
-	} else {
-		/* if there is not enough memory for new log, we drop it */
-		trace_data->dropped_entries++;
+/* Writes the entry to the ring of the current core. Local interrupts must be
+ * disabled by the caller, the other cores never write to this ring.
+ */
+static void dtrace_add_event(struct dma_trace_core_buf *ring, const char *e,
+			     uint32_t length)
+{
+	uint32_t size = sizeof(length) + ALIGN_UP(length, sizeof(uint32_t));
+
+	/* if there is not enough memory for new log, we drop it */
+	if (ring->w_pos - ring->r_pos + size > DMA_TRACE_CORE_SIZE) {
+		ring->dropped++;
+		return;
 	}
 
-	platform_shared_commit(trace_data, sizeof(*trace_data));
+	dtrace_ring_write(ring, ring->w_pos, &length, sizeof(length));
+	dtrace_ring_write(ring, ring->w_pos + sizeof(length), e, length);
+
+	/* publish the entry only after its data is written back */
+	barrier_release();
+	ring->w_pos += size;
 }
 
 void dtrace_event(const char *e, uint32_t length)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
-	struct dma_trace_buf *buffer = NULL;
-	unsigned long flags;
+	struct dma_trace_core_buf *ring;
+	uint32_t flags;
 
 	if (!trace_data || !trace_data->dmatb.addr ||
 	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0) {
@@ -546,26 +829,24 @@ void dtrace_event(const char *e, uint32_t length)
 		return;
 	}
 
-	buffer = &trace_data->dmatb;
+	ring = &trace_data->cores[cpu_get_id()];
 
-	spin_lock_irq(&trace_data->lock, flags);
-	dtrace_add_event(e, length);
+	irq_local_disable(flags);
+	dtrace_add_event(ring, e, length);
+	irq_local_enable(flags);
 
 	/* if DMA trace copying is working or secondary core
-	 * don't check if local buffer is half full
+	 * don't check if local ring is half full
 	 */
 	if (trace_data->copy_in_progress ||
 	    cpu_get_id() != PLATFORM_PRIMARY_CORE_ID) {
 		platform_shared_commit(trace_data, sizeof(*trace_data));
-		spin_unlock_irq(&trace_data->lock, flags);
 		return;
 	}
 
-	spin_unlock_irq(&trace_data->lock, flags);
-
-	/* schedule copy now if buffer > 50% full */
+	/* schedule copy now if ring > 50% full */
 	if (trace_data->enabled &&
-	    buffer->avail >= (DMA_TRACE_LOCAL_SIZE / 2)) {
+	    ring->w_pos - ring->r_pos >= DMA_TRACE_CORE_SIZE / 2) {
 		reschedule_task(&trace_data->dmat_work,
 				DMA_TRACE_RESCHEDULE_TIME);
 		/* reschedule should not be interrupted
@@ -587,5 +868,5 @@ void dtrace_event_atomic(const char *e, uint32_t length)
 		return;
 	}
 
-	dtrace_add_event(e, length);
+	dtrace_add_event(&trace_data->cores[cpu_get_id()], e, length);
 }
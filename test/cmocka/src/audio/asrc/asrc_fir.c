@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/asrc/asrc_farrow.h>
+#include <sof/audio/format.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define TEST_CHANNELS_MAX	8
+#define TEST_FILTER_LENGTH	128
+#define TEST_RING_LENGTH	(2 * TEST_FILTER_LENGTH)
+#define TEST_FRAMES		4
+
+static int32_t impulse_response[TEST_FILTER_LENGTH];
+static int16_t ring16[TEST_CHANNELS_MAX][TEST_RING_LENGTH];
+static int32_t ring32[TEST_CHANNELS_MAX][TEST_RING_LENGTH];
+static int16_t *ring16_p[TEST_CHANNELS_MAX];
+static int32_t *ring32_p[TEST_CHANNELS_MAX];
+static int16_t out16[TEST_CHANNELS_MAX * TEST_FRAMES];
+static int16_t ref16[TEST_CHANNELS_MAX * TEST_FRAMES];
+static int32_t out32[TEST_CHANNELS_MAX * TEST_FRAMES];
+static int32_t ref32[TEST_CHANNELS_MAX * TEST_FRAMES];
+
+static uint32_t rnd_state;
+
+static uint32_t rnd(void)
+{
+	rnd_state = rnd_state * 1664525 + 1013904223;
+	return rnd_state;
+}
+
+/* Per channel filter as it was before the channel pairs were filtered
+ * in lock step, used as the reference.
+ */
+static void ref_fir_filter16(struct asrc_farrow *src_obj,
+			     int16_t **output_buffers, int index_output_frame)
+{
+	int64_t prod;
+	int32_t prod32;
+	int32_t *filter_p;
+	int16_t *buffer_p;
+	int ch;
+	int n;
+	int i;
+
+	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
+		i = src_obj->num_channels * index_output_frame;
+	else
+		i = index_output_frame;
+
+	for (ch = 0; ch < src_obj->num_channels; ch++) {
+		filter_p = &src_obj->impulse_response[0];
+		buffer_p = &src_obj->ring_buffers16[ch]
+			[src_obj->buffer_write_position];
+		prod = 0;
+		for (n = 0; n < src_obj->filter_length; n++)
+			prod += (int64_t)(*buffer_p--) * (*filter_p++);
+
+		prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
+		output_buffers[ch][i] = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
+	}
+}
+
+static void ref_fir_filter32(struct asrc_farrow *src_obj,
+			     int32_t **output_buffers, int index_output_frame)
+{
+	int64_t prod;
+	const int32_t *filter_p;
+	int32_t *buffer_p;
+	int ch;
+	int n;
+	int i;
+
+	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
+		i = src_obj->num_channels * index_output_frame;
+	else
+		i = index_output_frame;
+
+	for (ch = 0; ch < src_obj->num_channels; ch++) {
+		filter_p = &src_obj->impulse_response[0];
+		buffer_p = &src_obj->ring_buffers32[ch]
+			[src_obj->buffer_write_position];
+		prod = 0;
+		for (n = 0; n < src_obj->filter_length; n++)
+			prod += (int64_t)(*buffer_p--) * (*filter_p++ >> 8);
+
+		output_buffers[ch][i] = sat_int32(Q_SHIFT(prod, 53, 31));
+	}
+}
+
+/* Fills the ring buffers and the impulse response. With a large shift
+ * the coefficients are full scale and the output saturates.
+ */
+static void fill(int coef_shift)
+{
+	int ch;
+	int n;
+
+	for (n = 0; n < TEST_FILTER_LENGTH; n++)
+		impulse_response[n] = (int32_t)rnd() >> coef_shift;
+
+	for (ch = 0; ch < TEST_CHANNELS_MAX; ch++) {
+		ring16_p[ch] = ring16[ch];
+		ring32_p[ch] = ring32[ch];
+		for (n = 0; n < TEST_RING_LENGTH; n++) {
+			ring16[ch][n] = (int16_t)rnd();
+			ring32[ch][n] = (int32_t)rnd();
+		}
+	}
+}
+
+/* Sets output buffer pointers for interleaved or deinterleaved output */
+static void set_outputs(void **out, void **ref, void *out_data,
+			void *ref_data, int sample_bytes, int nch,
+			enum asrc_io_format format)
+{
+	int step = format == ASRC_IOF_INTERLEAVED ? 1 : TEST_FRAMES;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		out[ch] = (uint8_t *)out_data + ch * step * sample_bytes;
+		ref[ch] = (uint8_t *)ref_data + ch * step * sample_bytes;
+	}
+}
+
+static void test_fir(int bit_depth, int coef_shift,
+		     enum asrc_io_format format)
+{
+	struct asrc_farrow src_obj = {0};
+	void *out[TEST_CHANNELS_MAX];
+	void *ref[TEST_CHANNELS_MAX];
+	int frame;
+	int nch;
+
+	rnd_state = 1;
+	src_obj.impulse_response = impulse_response;
+	src_obj.ring_buffers16 = ring16_p;
+	src_obj.ring_buffers32 = ring32_p;
+	src_obj.output_format = format;
+	src_obj.bit_depth = bit_depth;
+
+	for (nch = 1; nch <= TEST_CHANNELS_MAX; nch++) {
+		src_obj.num_channels = nch;
+		if (bit_depth == 16)
+			set_outputs(out, ref, out16, ref16, sizeof(int16_t),
+				    nch, format);
+		else
+			set_outputs(out, ref, out32, ref32, sizeof(int32_t),
+				    nch, format);
+
+		for (frame = 0; frame < TEST_FRAMES; frame++) {
+			fill(coef_shift);
+			src_obj.filter_length = TEST_FILTER_LENGTH - frame;
+			src_obj.buffer_write_position = TEST_RING_LENGTH - 1 -
+				frame;
+			if (bit_depth == 16) {
+				asrc_fir_filter16(&src_obj, (int16_t **)out,
+						  frame);
+				ref_fir_filter16(&src_obj, (int16_t **)ref,
+						 frame);
+			} else {
+				asrc_fir_filter32(&src_obj, (int32_t **)out,
+						  frame);
+				ref_fir_filter32(&src_obj, (int32_t **)ref,
+						 frame);
+			}
+		}
+
+		if (bit_depth == 16)
+			assert_memory_equal(out16, ref16,
+					    nch * TEST_FRAMES * sizeof(int16_t));
+		else
+			assert_memory_equal(out32, ref32,
+					    nch * TEST_FRAMES * sizeof(int32_t));
+	}
+}
+
+static void test_asrc_fir_filter16(void **state)
+{
+	(void)state;
+
+	test_fir(16, 8, ASRC_IOF_DEINTERLEAVED);
+	test_fir(16, 8, ASRC_IOF_INTERLEAVED);
+}
+
+static void test_asrc_fir_filter16_saturate(void **state)
+{
+	(void)state;
+
+	test_fir(16, 0, ASRC_IOF_INTERLEAVED);
+}
+
+static void test_asrc_fir_filter32(void **state)
+{
+	(void)state;
+
+	test_fir(32, 4, ASRC_IOF_DEINTERLEAVED);
+	test_fir(32, 4, ASRC_IOF_INTERLEAVED);
+}
+
+static void test_asrc_fir_filter32_saturate(void **state)
+{
+	(void)state;
+
+	test_fir(32, 0, ASRC_IOF_INTERLEAVED);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_asrc_fir_filter16),
+		cmocka_unit_test(test_asrc_fir_filter16_saturate),
+		cmocka_unit_test(test_asrc_fir_filter32),
+		cmocka_unit_test(test_asrc_fir_filter32_saturate),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
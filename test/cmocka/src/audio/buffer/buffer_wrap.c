@@ -73,11 +73,62 @@ static void test_audio_buffer_write_fill_10_bytes_and_write_5(void **state)
 	buffer_free(buf);
 }
 
+static void test_audio_buffer_inter_core_overwrite_and_read(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 10
+	};
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+	buf->inter_core = true;
+
+	uint8_t bytes[15] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+			     10, 11, 12, 13, 14};
+	void *r_ptr = buf->stream.r_ptr;
+	int i;
+	uint8_t *ptr;
+
+	for (i = 0; i < 10; i++) {
+		ptr = audio_stream_write_frag(&buf->stream, i, sizeof(uint8_t));
+		*ptr = bytes[i];
+	}
+	comp_update_buffer_produce(buf, 10);
+
+	for (i = 0; i < 5; i++) {
+		ptr = audio_stream_write_frag(&buf->stream, i, sizeof(uint8_t));
+		*ptr = bytes[10 + i];
+	}
+	comp_update_buffer_produce(buf, 5);
+
+	/* producer of an inter core buffer does not move the read position */
+	assert_ptr_equal(buf->stream.r_ptr, r_ptr);
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 10);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 0);
+
+	/* consumer skips the overwritten data */
+	comp_update_buffer_consume(buf, 5);
+
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 5);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 5);
+	for (i = 0; i < 5; i++) {
+		ptr = audio_stream_read_frag(&buf->stream, i, sizeof(uint8_t));
+		assert_int_equal(*ptr, bytes[10 + i]);
+	}
+
+	buffer_free(buf);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test
-			(test_audio_buffer_write_fill_10_bytes_and_write_5)
+			(test_audio_buffer_write_fill_10_bytes_and_write_5),
+		cmocka_unit_test
+			(test_audio_buffer_inter_core_overwrite_and_read)
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
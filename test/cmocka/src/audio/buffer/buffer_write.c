@@ -7,6 +7,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/buffer.h>
 #include <sof/drivers/ipc.h>
+#include <sof/lib/notifier.h>
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -79,12 +80,58 @@ static void test_audio_buffer_fill_10_bytes(void **state)
 	buffer_free(buf);
 }
 
+static void buffer_produce_cb(void *arg, enum notify_id type, void *data)
+{
+	struct buffer_cb_transact *cb_data = data;
+	uint32_t *produced = arg;
+
+	*produced += cb_data->transaction_amount;
+}
+
+static void test_audio_buffer_produce_notifies_subscriber(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+	struct comp_buffer *other = buffer_new(&test_buf_desc);
+	uint32_t produced = 0;
+
+	assert_non_null(buf);
+	assert_non_null(other);
+	assert_true(list_is_empty(&buf->cb_list));
+
+	assert_int_equal(notifier_obj_register(&produced, &buf->cb_list,
+					       buf->lock,
+					       NOTIFIER_ID_BUFFER_PRODUCE,
+					       &buffer_produce_cb), 0);
+
+	/* only the subscribed buffer and event type are delivered */
+	comp_update_buffer_produce(buf, 10);
+	comp_update_buffer_consume(buf, 10);
+	comp_update_buffer_produce(other, 20);
+	assert_int_equal(produced, 10);
+
+	notifier_obj_unregister(&produced, &buf->cb_list, buf->lock,
+				NOTIFIER_ID_BUFFER_PRODUCE);
+	assert_true(list_is_empty(&buf->cb_list));
+
+	comp_update_buffer_produce(buf, 10);
+	assert_int_equal(produced, 10);
+
+	buffer_free(other);
+	buffer_free(buf);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test
 			(test_audio_buffer_write_10_bytes_out_of_256_and_read_back),
-		cmocka_unit_test(test_audio_buffer_fill_10_bytes)
+		cmocka_unit_test(test_audio_buffer_fill_10_bytes),
+		cmocka_unit_test(test_audio_buffer_produce_notifies_subscriber)
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/coef_store.h>
+#include <sof/lib/alloc.h>
+#include <sof/sof.h>
+#include <ipc/topology.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define TEST_BLOB_SIZE	64
+
+static int init_count;
+
+static void *test_blob(int seed)
+{
+	uint8_t *blob = rballoc(0, SOF_MEM_CAPS_RAM, TEST_BLOB_SIZE);
+	int i;
+
+	assert_non_null(blob);
+	for (i = 0; i < TEST_BLOB_SIZE; i++)
+		blob[i] = seed + i;
+
+	return blob;
+}
+
+static void test_init(void *data, void *ctx)
+{
+	init_count++;
+	*(int32_t *)data = *(int32_t *)ctx;
+}
+
+static int setup(void **state)
+{
+	coef_store_init(sof_get());
+	init_count = 0;
+	return 0;
+}
+
+static void test_coef_store_adopt_identical(void **state)
+{
+	void *a = coef_store_adopt(test_blob(1), TEST_BLOB_SIZE);
+	void *b = coef_store_adopt(test_blob(1), TEST_BLOB_SIZE);
+	void *c = coef_store_adopt(test_blob(2), TEST_BLOB_SIZE);
+	void *d;
+
+	assert_ptr_equal(a, b);
+	assert_ptr_not_equal(a, c);
+
+	coef_store_put(a);
+	coef_store_put(b);
+	coef_store_put(c);
+
+	/* released blob is not found anymore */
+	d = test_blob(1);
+	assert_ptr_equal(coef_store_adopt(d, TEST_BLOB_SIZE), d);
+	coef_store_put(d);
+}
+
+static void test_coef_store_derive_shared(void **state)
+{
+	void *a = coef_store_adopt(test_blob(3), TEST_BLOB_SIZE);
+	void *b = coef_store_adopt(test_blob(3), TEST_BLOB_SIZE);
+	int32_t *src_a = (int32_t *)a + 4;
+	int32_t *src_b = (int32_t *)b + 4;
+	void *t1 = coef_store_derive(src_a, COEF_STORE_LR4, 0,
+				     sizeof(int32_t), test_init, src_a);
+	void *t2 = coef_store_derive(src_b, COEF_STORE_LR4, 0,
+				     sizeof(int32_t), test_init, src_b);
+	void *t3 = coef_store_derive(src_a, COEF_STORE_LR4, 1,
+				     sizeof(int32_t), test_init, src_a);
+
+	assert_ptr_equal(t1, t2);
+	assert_ptr_not_equal(t1, t3);
+	assert_int_equal(init_count, 2);
+	assert_int_equal(*(int32_t *)t1, *src_a);
+
+	/* tables keep the blob alive */
+	coef_store_put(a);
+	coef_store_put(b);
+	assert_int_equal(*(int32_t *)t1, *src_a);
+
+	coef_store_put(t1);
+	coef_store_put(t2);
+	coef_store_put(t3);
+}
+
+static void test_coef_store_derive_private(void **state)
+{
+	int32_t src = 5;
+	void *t1 = coef_store_derive(&src, COEF_STORE_LR4, 0,
+				     sizeof(int32_t), test_init, &src);
+	void *t2 = coef_store_derive(&src, COEF_STORE_LR4, 0,
+				     sizeof(int32_t), test_init, &src);
+
+	/* source outside of stored blobs can't be identified */
+	assert_ptr_not_equal(t1, t2);
+	assert_int_equal(init_count, 2);
+
+	coef_store_put(t1);
+	coef_store_put(t2);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_coef_store_adopt_identical, setup),
+		cmocka_unit_test_setup(test_coef_store_derive_shared, setup),
+		cmocka_unit_test_setup(test_coef_store_derive_private, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __DRC_CORES_H__
+#define __DRC_CORES_H__
+
+#include <ipc/stream.h>
+#include <sof/audio/drc/drc.h>
+
+/* Processing functions of the fixed and floating point DRC cores */
+drc_func drc_fixed_find_proc_func(enum sof_ipc_frame src_fmt);
+drc_func drc_float_find_proc_func(enum sof_ipc_frame src_fmt);
+
+#endif /* __DRC_CORES_H__ */
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/component.h>
+#include <sof/audio/drc/drc.h>
+#include <sof/audio/format.h>
+#include <sof/math/numbers.h>
+#include <user/drc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include "drc_cores.h"
+
+#define TEST_CHANNELS		2
+#define TEST_RATE		48000
+#define TEST_PERIOD_FRAMES	48
+#define TEST_FRAMES		(340 * TEST_PERIOD_FRAMES)
+#define TEST_LEVEL_FRAMES	2048
+
+/* Max. difference of the fixed point core to the floating point core,
+ * -70 dB relative to full scale for S32_LE and 10 LSB for S16_LE. Most
+ * of it comes from the single precision envelope rate of the floating
+ * point core that accumulates during the long release phases.
+ */
+#define TEST_MAX_DIFF_S32	(int32_t)(2147483648.0 * 3.1623e-4)
+#define TEST_MAX_DIFF_S16	10
+
+/* Parameters of the default blob tools/topology/m4/drc_coef_default.m4 */
+static const struct sof_drc_params drc_default_params = {
+	.enabled = 1,
+	.db_threshold = (int32_t)0xe8000000,
+	.db_knee = 0x1e000000,
+	.ratio = 0x01000000,
+	.pre_delay_time = 0x00624dd3,
+	.linear_threshold = 0x0409c2b1,
+	.slope = 0x40000000,
+	.K = 0x000199a6,
+	.knee_alpha = 0x0a0fd8ce,
+	.knee_beta = (int32_t)0xf5f01a1f,
+	.knee_threshold = 0x01fec983,
+	.ratio_base = 0x3a6130df,
+	.master_linear_gain = 0x010e83cb,
+	.attack_frames = 0x017384ef,
+	.sat_release_frames_inv_neg = (int32_t)0xff6b646d,
+	.sat_release_rate_at_neg_two_db = 0x00224103,
+	.kSpacingDb = 5,
+	.kA = 0x00f81000,
+	.kB = 0x001081aa,
+	.kC = 0x008af0f4,
+	.kD = 0x0022e1aa,
+	.kE = 0x00029bb9,
+};
+
+struct test_drc {
+	struct comp_dev dev;
+	struct drc_comp_data cd;
+	struct sof_drc_config config;
+	int32_t pre_delay[TEST_CHANNELS * DRC_MAX_PRE_DELAY_FRAMES];
+	struct audio_stream source;
+	struct audio_stream sink;
+};
+
+static struct test_drc drc_fixed;
+static struct test_drc drc_float;
+static int32_t input[TEST_CHANNELS * TEST_FRAMES];
+static int32_t output_fixed[TEST_CHANNELS * TEST_FRAMES];
+static int32_t output_float[TEST_CHANNELS * TEST_FRAMES];
+
+/* Same state as after drc_setup() in drc.c */
+static void drc_init(struct test_drc *drc, size_t sample_bytes)
+{
+	struct drc_state *state = &drc->cd.state;
+	int32_t pre_delay_frames;
+	int ch;
+
+	memset(drc, 0, sizeof(*drc));
+	drc->config.size = sizeof(drc->config);
+	drc->config.params = drc_default_params;
+	drc->cd.config = &drc->config;
+	drc->dev.priv_data = &drc->cd;
+
+	for (ch = 0; ch < TEST_CHANNELS; ch++)
+		state->pre_delay_buffers[ch] = (int8_t *)drc->pre_delay +
+			ch * sample_bytes * DRC_MAX_PRE_DELAY_FRAMES;
+
+	state->compressor_gain = Q_CONVERT_FLOAT(1.0f, 30);
+	state->max_attack_compression_diff_db = INT32_MIN;
+
+	pre_delay_frames = Q_MULTSR_32X32((int64_t)drc->config.params.pre_delay_time,
+					  TEST_RATE, 30, 0, 0);
+	pre_delay_frames = MIN(pre_delay_frames, DRC_MAX_PRE_DELAY_FRAMES - 1);
+	pre_delay_frames &= ~DRC_DIVISION_FRAMES_MASK;
+	pre_delay_frames = MAX(pre_delay_frames, DRC_DIVISION_FRAMES);
+	state->last_pre_delay_frames = pre_delay_frames;
+	state->pre_delay_write_index = pre_delay_frames;
+
+	drc->source.channels = TEST_CHANNELS;
+	drc->sink.channels = TEST_CHANNELS;
+}
+
+/* Sine wave with a level that changes every TEST_LEVEL_FRAMES to run
+ * the compressor through attack and release.
+ */
+static void generate_input(int bits)
+{
+	static const double level_db[] = {-40, -20, -6, 0, -30, -10, -3, -50};
+	double amplitude;
+	double scale = bits == 16 ? 32767.0 : 2147483647.0;
+	int ch;
+	int i;
+
+	for (i = 0; i < TEST_FRAMES; i++) {
+		amplitude = pow(10, level_db[(i / TEST_LEVEL_FRAMES) %
+					     ARRAY_SIZE(level_db)] / 20);
+		for (ch = 0; ch < TEST_CHANNELS; ch++)
+			input[i * TEST_CHANNELS + ch] = (int32_t)(scale *
+				amplitude * sin(2 * M_PI * 997 * i / TEST_RATE +
+						ch * M_PI / 3));
+	}
+}
+
+static void drc_run(struct test_drc *drc, drc_func func, void *in, void *out,
+		    size_t sample_bytes)
+{
+	size_t period_bytes = TEST_PERIOD_FRAMES * TEST_CHANNELS * sample_bytes;
+	int i;
+
+	for (i = 0; i < TEST_FRAMES; i += TEST_PERIOD_FRAMES) {
+		audio_stream_init(&drc->source, (uint8_t *)in + i *
+				  TEST_CHANNELS * sample_bytes, period_bytes);
+		audio_stream_init(&drc->sink, (uint8_t *)out + i *
+				  TEST_CHANNELS * sample_bytes, period_bytes);
+		func(&drc->dev, &drc->source, &drc->sink, TEST_PERIOD_FRAMES);
+	}
+}
+
+static void test_drc_fixed_point_s16(void **state)
+{
+	int16_t *in = (int16_t *)input;
+	int16_t *out_fixed = (int16_t *)output_fixed;
+	int16_t *out_float = (int16_t *)output_float;
+	int diff;
+	int max_diff = 0;
+	int i;
+
+	(void)state;
+
+	generate_input(16);
+	for (i = 0; i < TEST_CHANNELS * TEST_FRAMES; i++)
+		in[i] = input[i];
+
+	drc_init(&drc_fixed, sizeof(int16_t));
+	drc_init(&drc_float, sizeof(int16_t));
+	drc_run(&drc_fixed, drc_fixed_find_proc_func(SOF_IPC_FRAME_S16_LE),
+		in, out_fixed, sizeof(int16_t));
+	drc_run(&drc_float, drc_float_find_proc_func(SOF_IPC_FRAME_S16_LE),
+		in, out_float, sizeof(int16_t));
+
+	for (i = 0; i < TEST_CHANNELS * TEST_FRAMES; i++) {
+		diff = out_fixed[i] - out_float[i];
+		max_diff = MAX(max_diff, ABS(diff));
+	}
+
+	printf("%s: max. difference %d LSB\n", __func__, max_diff);
+	assert_true(max_diff <= TEST_MAX_DIFF_S16);
+}
+
+static void test_drc_fixed_point_s32(void **state)
+{
+	int64_t diff;
+	int64_t max_diff = 0;
+	int i;
+
+	(void)state;
+
+	generate_input(32);
+	drc_init(&drc_fixed, sizeof(int32_t));
+	drc_init(&drc_float, sizeof(int32_t));
+	drc_run(&drc_fixed, drc_fixed_find_proc_func(SOF_IPC_FRAME_S32_LE),
+		input, output_fixed, sizeof(int32_t));
+	drc_run(&drc_float, drc_float_find_proc_func(SOF_IPC_FRAME_S32_LE),
+		input, output_float, sizeof(int32_t));
+
+	for (i = 0; i < TEST_CHANNELS * TEST_FRAMES; i++) {
+		diff = (int64_t)output_fixed[i] - output_float[i];
+		max_diff = MAX(max_diff, ABS(diff));
+	}
+
+	printf("%s: max. difference %.1f dB\n", __func__,
+	       20 * log10((max_diff + 1) / 2147483648.0));
+	assert_true(max_diff <= TEST_MAX_DIFF_S32);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE
+		cmocka_unit_test(test_drc_fixed_point_s16),
+#endif
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test(test_drc_fixed_point_s32),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+/* Builds the fixed point DRC core with its own symbol names so that
+ * both cores can be linked to the same test.
+ */
+
+#undef CONFIG_COMP_DRC_FIXED_POINT
+#define CONFIG_COMP_DRC_FIXED_POINT 1
+
+#define drc_proc_fnmap drc_fixed_fnmap
+#define drc_proc_fnmap_pass drc_fixed_fnmap_pass
+#define drc_proc_fncount drc_fixed_fncount
+
+#include "../../../../../src/audio/drc/drc_generic.c"
+#include "drc_cores.h"
+
+drc_func drc_fixed_find_proc_func(enum sof_ipc_frame src_fmt)
+{
+	return drc_find_proc_func(src_fmt);
+}
@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/pcm_converter.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <ipc/stream.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../../util.h"
+
+#define TEST_CHANNELS	4
+#define TEST_FRAMES	8
+
+static const struct comp_driver drv_planar = {
+	.caps = COMP_CAPS_PLANAR,
+};
+
+static const struct comp_driver drv_interleaved;
+
+static int16_t test_sample(int frame, int ch)
+{
+	return (ch + 1) * 1000 + frame;
+}
+
+static void test_pcm_planar_deinterleave(void **state)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	int16_t *in;
+	int32_t *out;
+	int frame;
+	int ch;
+	int ret;
+
+	source = create_test_source(NULL, 0, SOF_IPC_FRAME_S16_LE,
+				    TEST_CHANNELS,
+				    TEST_FRAMES * TEST_CHANNELS * 2);
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S32_LE, TEST_CHANNELS,
+				TEST_FRAMES * TEST_CHANNELS * 4);
+	audio_stream_set_buffer_fmt(&sink->stream,
+				    SOF_IPC_BUFFER_NONINTERLEAVED);
+
+	in = source->stream.w_ptr;
+	for (frame = 0; frame < TEST_FRAMES; frame++)
+		for (ch = 0; ch < TEST_CHANNELS; ch++)
+			*in++ = test_sample(frame, ch);
+	audio_stream_produce(&source->stream, source->stream.size);
+
+	ret = pcm_convert_planar(&source->stream, 0, &sink->stream, 0,
+				 TEST_FRAMES * TEST_CHANNELS);
+	assert_int_equal(ret, TEST_FRAMES * TEST_CHANNELS);
+
+	/* each channel is contiguous */
+	out = sink->stream.addr;
+	for (ch = 0; ch < TEST_CHANNELS; ch++)
+		for (frame = 0; frame < TEST_FRAMES; frame++)
+			assert_int_equal(*out++, test_sample(frame, ch) << 16);
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+static void test_pcm_planar_wrap(void **state)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct audio_stream *planar;
+	int32_t *in;
+	int16_t *out;
+	int frame;
+	int ch;
+
+	source = create_test_source(NULL, 0, SOF_IPC_FRAME_S32_LE,
+				    TEST_CHANNELS,
+				    TEST_FRAMES * TEST_CHANNELS * 4);
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S16_LE, TEST_CHANNELS,
+				TEST_FRAMES * TEST_CHANNELS * 2);
+	planar = &source->stream;
+	audio_stream_set_buffer_fmt(planar, SOF_IPC_BUFFER_NONINTERLEAVED);
+
+	/* move the planar pointers by 5 frames */
+	audio_stream_produce(planar, 5 * TEST_CHANNELS * 4);
+	audio_stream_consume(planar, 5 * TEST_CHANNELS * 4);
+	assert_ptr_equal(planar->r_ptr, (int32_t *)planar->addr + 5);
+
+	/* write 6 frames with wrap in each channel ring */
+	for (ch = 0; ch < TEST_CHANNELS; ch++) {
+		in = audio_stream_channel_ptr(planar, planar->addr, ch);
+		for (frame = 0; frame < 6; frame++)
+			in[(5 + frame) % TEST_FRAMES] =
+				test_sample(frame, ch) << 16;
+	}
+	audio_stream_produce(planar, 6 * TEST_CHANNELS * 4);
+	assert_ptr_equal(planar->w_ptr, (int32_t *)planar->addr + 3);
+
+	pcm_convert_planar(planar, 0, &sink->stream, 0, 6 * TEST_CHANNELS);
+
+	out = sink->stream.w_ptr;
+	for (frame = 0; frame < 6; frame++)
+		for (ch = 0; ch < TEST_CHANNELS; ch++)
+			assert_int_equal(*out++, test_sample(frame, ch));
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+static void test_pcm_planar_copy(void **state)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct audio_stream *planar;
+	int16_t *in;
+	int16_t *out;
+	int frame;
+	int ch;
+	int ret;
+
+	source = create_test_source(NULL, 0, SOF_IPC_FRAME_S16_LE,
+				    TEST_CHANNELS,
+				    TEST_FRAMES * TEST_CHANNELS * 2);
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S16_LE, TEST_CHANNELS,
+				TEST_FRAMES * TEST_CHANNELS * 2);
+	planar = &sink->stream;
+	audio_stream_set_buffer_fmt(planar, SOF_IPC_BUFFER_NONINTERLEAVED);
+
+	in = source->stream.w_ptr;
+	for (frame = 0; frame < TEST_FRAMES; frame++)
+		for (ch = 0; ch < TEST_CHANNELS; ch++)
+			*in++ = test_sample(frame, ch);
+	audio_stream_produce(&source->stream, source->stream.size);
+
+	/* copy 6 frames with wrap in each channel ring of the sink */
+	audio_stream_produce(planar, 5 * TEST_CHANNELS * 2);
+	audio_stream_consume(planar, 5 * TEST_CHANNELS * 2);
+	ret = audio_stream_copy(&source->stream, 0, planar, 0,
+				6 * TEST_CHANNELS);
+	assert_int_equal(ret, 6 * TEST_CHANNELS);
+
+	for (ch = 0; ch < TEST_CHANNELS; ch++) {
+		out = audio_stream_channel_ptr(planar, planar->addr, ch);
+		for (frame = 0; frame < 6; frame++)
+			assert_int_equal(out[(5 + frame) % TEST_FRAMES],
+					 test_sample(frame, ch));
+	}
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+static void test_pcm_planar_negotiate(void **state)
+{
+	struct sof_ipc_stream_params params = {
+		.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		.buffer_fmt = SOF_IPC_BUFFER_NONINTERLEAVED,
+		.channels = TEST_CHANNELS,
+		.rate = 48000,
+	};
+	struct comp_buffer *buffer;
+
+	buffer = create_test_source(NULL, 0, SOF_IPC_FRAME_S32_LE,
+				    TEST_CHANNELS,
+				    TEST_FRAMES * TEST_CHANNELS * 4);
+	buffer->sink = calloc(1, sizeof(struct comp_dev));
+
+	buffer->source->drv = &drv_planar;
+	buffer->sink->drv = &drv_interleaved;
+	buffer_set_params(buffer, &params, BUFFER_UPDATE_FORCE);
+	assert_false(audio_stream_is_planar(&buffer->stream));
+	assert_ptr_equal(buffer->stream.end_addr,
+			 (char *)buffer->stream.addr + buffer->stream.size);
+
+	buffer->sink->drv = &drv_planar;
+	buffer_set_params(buffer, &params, BUFFER_UPDATE_FORCE);
+	assert_true(audio_stream_is_planar(&buffer->stream));
+	assert_ptr_equal(buffer->stream.end_addr,
+			 (char *)buffer->stream.addr + TEST_FRAMES * 4);
+
+	/* no planar float */
+	params.frame_fmt = SOF_IPC_FRAME_FLOAT;
+	buffer_set_params(buffer, &params, BUFFER_UPDATE_FORCE);
+	assert_false(audio_stream_is_planar(&buffer->stream));
+
+	free(buffer->sink);
+	free_test_source(buffer);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_pcm_planar_deinterleave),
+		cmocka_unit_test(test_pcm_planar_wrap),
+		cmocka_unit_test(test_pcm_planar_copy),
+		cmocka_unit_test(test_pcm_planar_negotiate),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
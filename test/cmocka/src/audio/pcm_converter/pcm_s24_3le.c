@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/pcm_converter.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/audio/buffer.h>
+#include <ipc/stream.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../../util.h"
+
+#define TEST_CHANNELS	2
+#define TEST_FRAMES	6
+#define TEST_SAMPLES	(TEST_FRAMES * TEST_CHANNELS)
+
+static const int32_t test_s24[TEST_SAMPLES] = {
+	0, 1, -1, 0x123456, -0x123456, 0x7fffff,
+	-0x800000, 0x100, -0x100, 0x7fff80, 0x55aa55, -2,
+};
+
+static struct comp_buffer *create_s24_3le_source(void)
+{
+	struct comp_buffer *source;
+	uint8_t *in;
+	int i;
+
+	source = create_test_source(NULL, 0, SOF_IPC_FRAME_S24_3LE,
+				    TEST_CHANNELS, TEST_SAMPLES * 3);
+	in = source->stream.w_ptr;
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		in[3 * i] = test_s24[i];
+		in[3 * i + 1] = test_s24[i] >> 8;
+		in[3 * i + 2] = test_s24[i] >> 16;
+	}
+	audio_stream_produce(&source->stream, source->stream.size);
+
+	return source;
+}
+
+static void test_pcm_s24_3le_load_store(void **state)
+{
+	uint8_t packed[3];
+	int i;
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		store_s24_3le(packed, test_s24[i]);
+		assert_int_equal(load_s24_3le(packed), test_s24[i]);
+	}
+
+	assert_int_equal(get_sample_bytes(SOF_IPC_FRAME_S24_3LE), 3);
+}
+
+static void test_pcm_s24_3le_to_s24(void **state)
+{
+	pcm_converter_func fn = pcm_get_conversion_function(
+		SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S24_4LE);
+	pcm_converter_func back = pcm_get_conversion_function(
+		SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_3LE);
+	struct comp_buffer *source = create_s24_3le_source();
+	struct comp_buffer *sink;
+	struct comp_buffer *packed;
+	int32_t *out;
+	int i;
+
+	assert_non_null(fn);
+	assert_non_null(back);
+
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S24_4LE,
+				TEST_CHANNELS, TEST_SAMPLES * 4);
+	fn(&source->stream, 0, &sink->stream, 0, TEST_SAMPLES);
+
+	out = sink->stream.w_ptr;
+	for (i = 0; i < TEST_SAMPLES; i++)
+		assert_int_equal(out[i], test_s24[i]);
+
+	/* and back to packed */
+	audio_stream_produce(&sink->stream, sink->stream.size);
+	packed = create_test_sink(NULL, 0, SOF_IPC_FRAME_S24_3LE,
+				  TEST_CHANNELS, TEST_SAMPLES * 3);
+	back(&sink->stream, 0, &packed->stream, 0, TEST_SAMPLES);
+	assert_memory_equal(packed->stream.addr, source->stream.addr,
+			    TEST_SAMPLES * 3);
+
+	free_test_source(source);
+	free_test_sink(sink);
+	free_test_sink(packed);
+}
+
+static void test_pcm_s24_3le_to_s16(void **state)
+{
+	pcm_converter_func fn = pcm_get_conversion_function(
+		SOF_IPC_FRAME_S24_3LE, SOF_IPC_FRAME_S16_LE);
+	struct comp_buffer *source = create_s24_3le_source();
+	struct comp_buffer *sink;
+	int16_t *out;
+	int i;
+
+	assert_non_null(fn);
+
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S16_LE,
+				TEST_CHANNELS, TEST_SAMPLES * 2);
+	fn(&source->stream, 0, &sink->stream, 0, TEST_SAMPLES);
+
+	out = sink->stream.w_ptr;
+	for (i = 0; i < TEST_SAMPLES; i++)
+		assert_int_equal(out[i],
+				 sat_int16(Q_SHIFT_RND(test_s24[i], 23, 15)));
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+static void test_pcm_s32_to_s24_3le_wrap(void **state)
+{
+	pcm_converter_func fn = pcm_get_conversion_function(
+		SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_3LE);
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	int32_t *in;
+	int i;
+
+	assert_non_null(fn);
+
+	source = create_test_source(NULL, 0, SOF_IPC_FRAME_S32_LE,
+				    TEST_CHANNELS, TEST_SAMPLES * 4);
+	sink = create_test_sink(NULL, 0, SOF_IPC_FRAME_S24_3LE,
+				TEST_CHANNELS, TEST_SAMPLES * 3);
+
+	in = source->stream.w_ptr;
+	for (i = 0; i < TEST_SAMPLES; i++)
+		in[i] = test_s24[i] << 8;
+	/* saturated on rounding */
+	in[5] = INT32_MAX;
+	audio_stream_produce(&source->stream, source->stream.size);
+
+	/* start the packed sink in the middle to wrap it */
+	audio_stream_produce(&sink->stream, 4 * TEST_CHANNELS * 3);
+	audio_stream_consume(&sink->stream, 4 * TEST_CHANNELS * 3);
+	fn(&source->stream, 0, &sink->stream, 0, TEST_SAMPLES);
+	audio_stream_produce(&sink->stream, sink->stream.size);
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		assert_int_equal(load_s24_3le(audio_stream_get_frag(
+					&sink->stream, sink->stream.r_ptr,
+					i, 3)),
+				 test_s24[i]);
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_pcm_s24_3le_load_store),
+		cmocka_unit_test(test_pcm_s24_3le_to_s24),
+		cmocka_unit_test(test_pcm_s24_3le_to_s16),
+		cmocka_unit_test(test_pcm_s32_to_s24_3le_wrap),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+/* Gain at 0 Hz of -0.5 dB per stage, Q1.31 */
+#define TEST_GAIN_2S	2027355295LL
+
+static int setup(void **state)
+{
+	src_design_init();
+	return 0;
+}
+
+/* Returns sum of stage coefficients in Q1.31 */
+static int64_t stage_sum(struct src_stage *stage)
+{
+	int64_t sum = 0;
+	int i;
+
+	for (i = 0; i < stage->filter_length; i++) {
+#if SRC_SHORT
+		sum += (int64_t)((const int16_t *)stage->coefs)[i] << 16;
+#else
+		sum += ((const int32_t *)stage->coefs)[i];
+#endif
+	}
+
+	return stage->shift < 0 ? sum << -stage->shift : sum >> stage->shift;
+}
+
+static void check_stage(struct src_stage *stage)
+{
+	int64_t gain = stage->num_of_subfilters * TEST_GAIN_2S;
+	int64_t sum = stage_sum(stage);
+
+	assert_int_equal(stage->subfilter_length % 4, 0);
+	assert_int_equal(stage->filter_length,
+			 stage->subfilter_length * stage->num_of_subfilters);
+	assert_int_equal(-stage->idm * stage->blk_out +
+			 stage->odm * stage->blk_in, 1);
+
+	/* Gain at 0 Hz within 0.01 dB */
+	assert_true(sum > gain - gain / 800 && sum < gain + gain / 800);
+}
+
+static void test_src_design_get_ratio(void **state)
+{
+	struct src_design *d = src_design_get(44100, 37800, SRC_QUALITY_HIGH);
+
+	assert_non_null(d);
+
+	/* 37800 / 44100 = 6 / 7 is split to two stages */
+	assert_int_equal(d->stage1->blk_out * d->stage2->blk_out, 6);
+	assert_int_equal(d->stage1->blk_in * d->stage2->blk_in, 7);
+
+	check_stage(d->stage1);
+	check_stage(d->stage2);
+
+	src_design_put(d);
+}
+
+static void test_src_design_get_cached(void **state)
+{
+	struct src_design *a = src_design_get(48000, 37800, SRC_QUALITY_HIGH);
+	struct src_design *b = src_design_get(48000, 37800, SRC_QUALITY_HIGH);
+	struct src_design *c = src_design_get(48000, 37800, SRC_QUALITY_LOW);
+
+	assert_non_null(a);
+	assert_non_null(c);
+	assert_ptr_equal(a, b);
+	assert_ptr_not_equal(a, c);
+	assert_int_equal(a->refs, 2);
+
+	/* Shorter filters for lower quality */
+	assert_true(c->stage1->filter_length < a->stage1->filter_length);
+
+	src_design_put(a);
+	src_design_put(b);
+	src_design_put(c);
+
+	/* Unused design is kept */
+	b = src_design_get(48000, 37800, SRC_QUALITY_HIGH);
+	assert_ptr_equal(a, b);
+	src_design_put(b);
+}
+
+static void test_src_design_get_unsupported(void **state)
+{
+	/* Too large prime factor */
+	assert_null(src_design_get(48000, 48383, SRC_QUALITY_HIGH));
+	assert_null(src_design_get(0, 48000, SRC_QUALITY_HIGH));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_src_design_get_ratio, setup),
+		cmocka_unit_test_setup(test_src_design_get_cached, setup),
+		cmocka_unit_test_setup(test_src_design_get_unsupported, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -211,11 +211,21 @@ static struct test_case test_cases[] = {
 		  SOF_MEM_CAPS_DMA, 100, TEST_IMMEDIATE_FREE, "rballoc_dma"),
 };
 
+/* system heap used by init_heap() itself */
+static uint32_t sys_init_used[PLATFORM_HEAP_SYSTEM];
+
 static int setup(void **state)
 {
+	struct mm *memmap;
+	int i;
+
 	platform_init_memmap(sof_get());
 	init_heap(sof_get());
 
+	memmap = memmap_get();
+	for (i = 0; i < ARRAY_SIZE(memmap->system); ++i)
+		sys_init_used[i] = memmap->system[i].info.used;
+
 	return 0;
 }
 
@@ -232,8 +242,9 @@ static int clear_sys(void **state)
 	for (; sysheap_idx < ARRAY_SIZE(memmap->system); ++sysheap_idx) {
 		struct mm_heap *cpu_heap = &memmap->system[sysheap_idx];
 
-		cpu_heap->info.used = 0;
-		cpu_heap->info.free = cpu_heap->size;
+		cpu_heap->info.used = sys_init_used[sysheap_idx];
+		cpu_heap->info.free = cpu_heap->size -
+			sys_init_used[sysheap_idx];
 	}
 
 	return 0;
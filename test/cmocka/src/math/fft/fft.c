@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+
+#define FFT_TEST_SIZE		256
+#define CMP_TOLERANCE		0.00001
+
+static uint8_t plan_data[FFT_SIZE_MAX / 2 * sizeof(struct icomplex32) +
+			 FFT_SIZE_MAX * sizeof(uint16_t)];
+static struct icomplex32 data[FFT_TEST_SIZE];
+
+static void init_plan(struct fft_plan *plan, int size)
+{
+	void *p = plan_data;
+
+	assert_int_equal(fft_plan_init(plan, size, &p), 0);
+	assert_ptr_equal(p, plan_data + fft_plan_size(size));
+}
+
+static void test_math_fft_plan_size(void **state)
+{
+	(void)state;
+
+	assert_int_equal(fft_plan_size(3), -EINVAL);
+	assert_int_equal(fft_plan_size(1), -EINVAL);
+	assert_int_equal(fft_plan_size(2 * FFT_SIZE_MAX), -EINVAL);
+	assert_int_equal(fft_plan_size(8), 4 * sizeof(struct icomplex32) +
+			 8 * sizeof(uint16_t));
+}
+
+static void test_math_fft_tone(void **state)
+{
+	(void)state;
+
+	struct fft_plan plan;
+	const int bin = 10;
+	float re;
+	float im;
+	float ref;
+	int i;
+
+	init_plan(&plan, FFT_TEST_SIZE);
+
+	/* A cosine at the bin center, the scaled spectrum is 0.5 * 0.5 at
+	 * bins k and N - k.
+	 */
+	for (i = 0; i < FFT_TEST_SIZE; i++) {
+		data[i].real = Q_CONVERT_FLOAT(0.5 * cos(2 * M_PI * bin * i /
+							 FFT_TEST_SIZE), 31);
+		data[i].imag = 0;
+	}
+
+	fft_execute_32(&plan, data, false);
+
+	for (i = 0; i < FFT_TEST_SIZE; i++) {
+		re = Q_CONVERT_QTOF(data[i].real, 31);
+		im = Q_CONVERT_QTOF(data[i].imag, 31);
+		ref = (i == bin || i == FFT_TEST_SIZE - bin) ? 0.25 : 0;
+		if (fabsf(re - ref) > CMP_TOLERANCE ||
+		    fabsf(im) > CMP_TOLERANCE)
+			printf("%s: bin %d = %.10f %.10f\n", __func__, i, re, im);
+
+		assert_true(fabsf(re - ref) <= CMP_TOLERANCE);
+		assert_true(fabsf(im) <= CMP_TOLERANCE);
+	}
+}
+
+static void test_math_fft_inverse(void **state)
+{
+	(void)state;
+
+	struct fft_plan plan;
+	int32_t ref[FFT_TEST_SIZE];
+	float diff;
+	int i;
+
+	init_plan(&plan, FFT_TEST_SIZE);
+
+	for (i = 0; i < FFT_TEST_SIZE; i++) {
+		ref[i] = Q_CONVERT_FLOAT(0.9 * sin(0.1 * i * i), 31);
+		data[i].real = ref[i];
+		data[i].imag = 0;
+	}
+
+	/* The inverse of the forward transform returns the input */
+	fft_execute_32(&plan, data, false);
+	fft_execute_32(&plan, data, true);
+
+	for (i = 0; i < FFT_TEST_SIZE; i++) {
+		diff = fabsf(Q_CONVERT_QTOF(data[i].real - ref[i], 31));
+		if (diff > CMP_TOLERANCE)
+			printf("%s: diff for %d = %.10f\n", __func__, i, diff);
+
+		assert_true(diff <= CMP_TOLERANCE);
+		assert_true(fabsf(Q_CONVERT_QTOF(data[i].imag, 31)) <=
+			    CMP_TOLERANCE);
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fft_plan_size),
+		cmocka_unit_test(test_math_fft_tone),
+		cmocka_unit_test(test_math_fft_inverse),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
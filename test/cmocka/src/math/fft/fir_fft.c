@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/fir_generic.h>
+#include <user/fir.h>
+
+#define TEST_LENGTH		200
+#define TEST_BLOCK_MAX		64
+#define TEST_SAMPLES		(40 * TEST_BLOCK_MAX)
+#define TEST_PERIOD		48
+
+/* Max. difference of the FFT filter output to the direct form output in
+ * Q1.31, -120 dB relative to full scale.
+ */
+#define TEST_MAX_DIFF		2147
+
+static int16_t coef_data[SOF_FIR_COEF_NHEADER + TEST_LENGTH];
+static uint8_t plan_data[sizeof(struct fft_plan) +
+			 FFT_SIZE_MAX / 2 * sizeof(struct icomplex32) +
+			 FFT_SIZE_MAX * sizeof(uint16_t)];
+static struct icomplex32 buf[2 * TEST_BLOCK_MAX];
+static uint8_t spectra[(TEST_LENGTH / FIR_FFT_BLOCK_MIN + 1) *
+		       (TEST_BLOCK_MAX + 1) * sizeof(struct icomplex32)];
+static uint8_t delay_mem[(TEST_LENGTH / FIR_FFT_BLOCK_MIN + 1) *
+			 (TEST_BLOCK_MAX + 1) * sizeof(struct icomplex32) +
+			 3 * TEST_BLOCK_MAX * sizeof(int32_t)];
+static int32_t fir_delay[2 * TEST_LENGTH];
+static int32_t input[TEST_SAMPLES];
+static int32_t out_fft[TEST_SAMPLES];
+static int32_t out_direct[TEST_SAMPLES];
+
+static struct sof_fir_coef_data *init_response(int out_shift)
+{
+	struct sof_fir_coef_data *config = (struct sof_fir_coef_data *)coef_data;
+	int i;
+
+	/* Windowed sinc low-pass with a cutoff of 0.2 * Fs */
+	config->length = TEST_LENGTH;
+	config->out_shift = out_shift;
+	config->mode = SOF_FIR_MODE_FFT;
+	for (i = 0; i < TEST_LENGTH; i++) {
+		double t = i - (TEST_LENGTH - 1) / 2.0;
+		double w = 0.54 - 0.46 * cos(2 * M_PI * i / (TEST_LENGTH - 1));
+		double h = t ? sin(2 * M_PI * 0.2 * t) / (M_PI * t) : 0.4;
+
+		config->coef[i] = (int16_t)lrint(32767.0 * w * h);
+	}
+
+	return config;
+}
+
+static void init_input(void)
+{
+	uint32_t seed = 1;
+	int i;
+
+	/* Noise at -6 dBFS to have headroom in the filter */
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		seed = seed * 1664525 + 1013904223;
+		input[i] = (int32_t)seed >> 1;
+	}
+}
+
+static struct fft_plan *init_plan(int block)
+{
+	struct fft_plan *plan = (struct fft_plan *)plan_data;
+	void *p = plan + 1;
+
+	assert_int_equal(fft_plan_init(plan, 2 * block, &p), 0);
+	return plan;
+}
+
+/* Runs the FFT filter in periods that are not aligned to the partitions */
+static void run_fft(struct fir_fft_state *fir)
+{
+	int n;
+	int i;
+
+	for (i = 0; i < TEST_SAMPLES; i += n) {
+		n = MIN(TEST_PERIOD, TEST_SAMPLES - i);
+		fir_fft_32(fir, &input[i], &out_fft[i], n);
+	}
+}
+
+static void run_direct(struct sof_fir_coef_data *config)
+{
+	struct fir_state_32x16 fir;
+	int32_t *delay = fir_delay;
+	int i;
+
+	memset(fir_delay, 0, sizeof(fir_delay));
+	fir_reset(&fir);
+	assert_int_equal(fir_delay_size(config), sizeof(fir_delay));
+	fir_init_coef(&fir, config);
+	fir_init_delay(&fir, &delay);
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		out_direct[i] = fir_32x16(&fir, input[i]);
+}
+
+static void test_fir_fft_vs_direct(int block, int out_shift)
+{
+	struct sof_fir_coef_data *config = init_response(out_shift);
+	struct fir_fft_coef coef;
+	struct fir_fft_state fir;
+	struct fft_plan *plan;
+	void *data;
+	int64_t diff;
+	int64_t max_diff = 0;
+	int i;
+
+	assert_true(fir_fft_coef_size(config, block) <= sizeof(spectra));
+	assert_true(fir_fft_delay_size(config, block) <= sizeof(delay_mem));
+
+	init_input();
+	plan = init_plan(block);
+
+	data = spectra;
+	fir_fft_init_coef(&coef, config, block, plan, buf, &data);
+	assert_ptr_equal(data, spectra + fir_fft_coef_size(config, block));
+
+	memset(delay_mem, 0, sizeof(delay_mem));
+	data = delay_mem;
+	fir_fft_reset(&fir);
+	fir_fft_init_delay(&fir, &coef, plan, buf, &data);
+	assert_ptr_equal(data, delay_mem + fir_fft_delay_size(config, block));
+
+	run_fft(&fir);
+	run_direct(config);
+
+	/* The FFT filter output is delayed by the partition length and
+	 * zero before it.
+	 */
+	for (i = 0; i < block; i++)
+		assert_int_equal(out_fft[i], 0);
+
+	for (i = 0; i < TEST_SAMPLES - block; i++) {
+		diff = (int64_t)out_fft[i + block] - out_direct[i];
+		max_diff = MAX(max_diff, ABS(diff));
+	}
+
+	printf("%s: block %d, out shift %d, max. difference %.1f dB\n",
+	       __func__, block, out_shift,
+	       20 * log10((max_diff + 1) / 2147483648.0));
+	assert_true(max_diff <= TEST_MAX_DIFF);
+}
+
+static void test_math_fir_fft_vs_direct_16(void **state)
+{
+	(void)state;
+
+	test_fir_fft_vs_direct(16, 0);
+}
+
+static void test_math_fir_fft_vs_direct_64(void **state)
+{
+	(void)state;
+
+	test_fir_fft_vs_direct(64, 0);
+}
+
+static void test_math_fir_fft_vs_direct_shift(void **state)
+{
+	(void)state;
+
+	test_fir_fft_vs_direct(32, 1);
+}
+
+static void test_math_fir_fft_bypass(void **state)
+{
+	struct fir_fft_coef coef;
+	struct fir_fft_state fir;
+	struct fft_plan *plan;
+	const int block = 32;
+	void *data;
+	int i;
+
+	(void)state;
+
+	init_input();
+	plan = init_plan(block);
+	fir_fft_init_bypass(&coef, block);
+
+	memset(delay_mem, 0, sizeof(delay_mem));
+	data = delay_mem;
+	fir_fft_reset(&fir);
+	fir_fft_init_delay(&fir, &coef, plan, buf, &data);
+	assert_ptr_equal(data, delay_mem + fir_fft_bypass_delay_size(block));
+
+	run_fft(&fir);
+
+	/* Bypass delays the input exactly as much as the filters do */
+	for (i = 0; i < block; i++)
+		assert_int_equal(out_fft[i], 0);
+
+	for (i = 0; i < TEST_SAMPLES - block; i++)
+		assert_int_equal(out_fft[i + block], input[i]);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fir_fft_vs_direct_16),
+		cmocka_unit_test(test_math_fir_fft_vs_direct_64),
+		cmocka_unit_test(test_math_fir_fft_vs_direct_shift),
+		cmocka_unit_test(test_math_fir_fft_bypass),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
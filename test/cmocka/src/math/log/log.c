@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/log.h>
+
+#define LOG2_TOLERANCE		0.0000001
+#define EXP2_TOLERANCE		0.00000001
+#define POW_TOLERANCE		0.0000001
+
+/* Float precision is not enough for the comparisons */
+#define Q_TO_DOUBLE(x, q)	((double)(x) / ((int64_t)1 << (q)))
+
+static void test_math_log2_fixed(void **state)
+{
+	(void)state;
+
+	double diff;
+	double ref;
+	uint32_t x;
+	int i;
+
+	assert_int_equal(log2_fixed(0), INT32_MIN);
+	assert_int_equal(log2_fixed(1), 0);
+	assert_int_equal(log2_fixed(1 << 30), 30 << LOG2_FIXED_OUTPUT_QY);
+
+	for (i = 0; i < 1000; i++) {
+		x = (uint32_t)(1 + i * 4294967.0);
+		ref = log2((double)x);
+		diff = fabs(Q_TO_DOUBLE(log2_fixed(x), 26) - ref);
+		if (diff > LOG2_TOLERANCE)
+			printf("%s: diff for %u = %.10f\n", __func__, x, diff);
+
+		assert_true(diff <= LOG2_TOLERANCE);
+	}
+}
+
+static void test_math_exp2_fixed(void **state)
+{
+	(void)state;
+
+	double diff;
+	double ref;
+	int32_t x;
+	int i;
+
+	/* Input range -32.0 .. 1.0 */
+	for (i = 0; i <= 1000; i++) {
+		x = Q_CONVERT_FLOAT(-32.0 + i * 0.033, 26);
+		ref = exp2(Q_TO_DOUBLE(x, 26));
+		diff = fabs(Q_TO_DOUBLE(exp2_fixed(x), 30) - ref);
+		if (diff > EXP2_TOLERANCE)
+			printf("%s: diff for %d = %.10f\n", __func__, x, diff);
+
+		assert_true(diff <= EXP2_TOLERANCE);
+	}
+
+	assert_int_equal(exp2_fixed(Q_CONVERT_FLOAT(1.0, 26)), INT32_MAX);
+	assert_int_equal(exp2_fixed(Q_CONVERT_FLOAT(5.0, 26)), INT32_MAX);
+}
+
+static void test_math_pow_fixed(void **state)
+{
+	(void)state;
+
+	double diff;
+	double ref;
+	double x;
+	double y;
+	int i;
+	int j;
+
+	assert_int_equal(pow_fixed(0, Q_CONVERT_FLOAT(0.5, 30)), 0);
+	assert_int_equal(pow_fixed(-1, Q_CONVERT_FLOAT(0.5, 30)), 0);
+
+	for (i = 1; i <= 100; i++) {
+		for (j = 0; j <= 20; j++) {
+			x = i * 0.0195;
+			y = -1.0 + j * 0.1;
+			ref = pow(x, y);
+			if (ref >= 2.0)
+				continue;
+
+			diff = fabs(Q_TO_DOUBLE(pow_fixed(Q_CONVERT_FLOAT(x, 30),
+							  Q_CONVERT_FLOAT(y, 30)),
+						30) - ref);
+			if (diff > POW_TOLERANCE)
+				printf("%s: diff for %f^%f = %.10f\n", __func__,
+				       x, y, diff);
+
+			assert_true(diff <= POW_TOLERANCE);
+		}
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_log2_fixed),
+		cmocka_unit_test(test_math_exp2_fixed),
+		cmocka_unit_test(test_math_pow_fixed),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -16,6 +16,7 @@ struct callback_handle {
 	const void *caller;
 	void (*cb)(void *arg, enum notify_id, void *data);
 	struct list_item list;
+	enum notify_id type;
 };
 
 static struct notify *_notify;
@@ -100,3 +101,63 @@ void notifier_unregister_all(void *receiver, void *caller)
 	for (i = 0; i < NOTIFIER_ID_COUNT; i++)
 		notifier_unregister(receiver, caller, i);
 }
+
+int notifier_obj_register(void *receiver, struct list_item *subscribers,
+			  spinlock_t *lock, enum notify_id type,
+			  void (*cb)(void *arg, enum notify_id type, void *data))
+{
+	struct callback_handle *handle;
+
+	if (type >= NOTIFIER_ID_COUNT)
+		return -EINVAL;
+
+	handle = rzalloc(0, 0, 0, sizeof(struct callback_handle));
+
+	if (!handle)
+		return -ENOMEM;
+
+	handle->receiver = receiver;
+	handle->cb = cb;
+	handle->type = type;
+
+	list_item_append(&handle->list, subscribers);
+
+	return 0;
+}
+
+void notifier_obj_unregister(void *receiver, struct list_item *subscribers,
+			     spinlock_t *lock, enum notify_id type)
+{
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct callback_handle *handle;
+
+	list_for_item_safe(wlist, tlist, subscribers) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if ((!receiver || handle->receiver == receiver) &&
+		    (type == NOTIFIER_ID_COUNT || handle->type == type)) {
+			list_item_del(&handle->list);
+			free(handle);
+		}
+	}
+}
+
+void notifier_obj_unregister_all(void *receiver, struct list_item *subscribers,
+				 spinlock_t *lock)
+{
+	notifier_obj_unregister(receiver, subscribers, lock, NOTIFIER_ID_COUNT);
+}
+
+void notifier_obj_notify(struct list_item *subscribers, spinlock_t *lock,
+			 enum notify_id type, void *data)
+{
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct callback_handle *handle;
+
+	list_for_item_safe(wlist, tlist, subscribers) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if (handle->type == type)
+			handle->cb(handle->receiver, type, data);
+	}
+}
@@ -28,6 +28,7 @@
 #define TRACE_MAX_IDS_STR		10
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
 #define INVALID_TRACE_ID		(-1 & TRACE_IDS_MASK)
+#define LDC_TABLE_BITS_INIT		10
 
 struct ldc_entry_header {
 	uint32_t level;
@@ -38,18 +39,59 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
+/* type of trace parameter, decided from the format text */
+enum ldc_param_type {
+	LDC_PARAM_VALUE = 0,	/* passed to fprintf() as is */
+	LDC_PARAM_STRING,	/* %s, replaced with the string address */
+	LDC_PARAM_UUID,		/* %pUx, replaced with the formatted UUID */
+};
+
+struct ldc_param {
+	enum ldc_param_type type;
+	bool be;		/* big endian UUID */
+	bool upper;		/* upper case UUID */
+};
+
+/* Dictionary entry parsed when it is first used. The text has the %pUx
+ * formats replaced with %s and the file name is formatted for printing.
+ */
 struct ldc_entry {
 	struct ldc_entry_header header;
+	uint32_t address;
 	char *file_name;
+	char *location;
 	char *text;
-	uint32_t *params;
+	struct ldc_param params[TRACE_MAX_PARAMS_COUNT];
+};
+
+/* Log entries section of the ldc file in memory and hash table of the
+ * parsed entries with the entry address as key
+ */
+struct ldc_dict {
+	uint8_t *data;
+	struct ldc_entry **table;
+	uint32_t table_bits;
+	uint32_t count;
+};
+
+/* Mirror of the firmware compact entry encoder state */
+struct compact_state {
+	bool synced;		/* a sync entry has been decoded */
+	uint64_t timestamp;	/* timestamp of the previous entry */
+	struct {
+		uint32_t uid;
+		uint32_t log_entry_address;
+	} dict[TRACE_COMPACT_DICT_SIZE];
+};
+
+/* Compact entry input, the first dword is read before the format is known */
+struct compact_input {
+	uint8_t head[sizeof(uint32_t)];
+	size_t pos;
 };
 
 struct proc_ldc_entry {
 	int subst_mask;
-	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
 	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
 };
 
@@ -61,6 +103,10 @@ static const char *BAD_PTR_STR = "<bad uid ptr %x>";
 /* pointer to config for global context */
 struct convert_config *global_config;
 
+static struct ldc_dict ldc_dict;
+
+static struct compact_state compact;
+
 char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
 		     bool be, bool upper)
 {
@@ -131,98 +177,66 @@ static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool up
 	return str;
 }
 
-/* fmt should point '%pUx`, return pointer to UUID string or zero */
-static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_colors, int *fmt_len)
+/* fmt should point '%pUx`, returns the length of the format */
+static int parse_uuid_fmt(const char *fmt, struct ldc_param *param)
 {
 	const char *fmt_end = fmt + strlen(fmt);
-	int be, upper;
 	int len = 4; /* assure full formating, with x */
 
-	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U') {
-		*fmt_len = 0;
-		return NULL;
-	}
 	/* check 'x' value */
 	switch (fmt + 3 < fmt_end ? fmt[3] : 0) {
 	case 'b':
-		be = 1;
-		upper = 0;
+		param->be = true;
+		param->upper = false;
 		break;
 	case 'B':
-		be = 1;
-		upper = 1;
+		param->be = true;
+		param->upper = true;
 		break;
 	case 'l':
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		break;
 	case 'L':
-		be = 0;
-		upper = 1;
+		param->be = false;
+		param->upper = true;
 		break;
 	default:
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		--len;
 		break;
 	}
-	*fmt_len = len;
-	return format_uid(uuid_key, use_colors, be, upper);
+
+	return len;
 }
 
+/* get the substitutions for the parameters of the entry */
 static void process_params(struct proc_ldc_entry *pe,
-			   const struct ldc_entry *e,
+			   const struct ldc_entry *e, const uint32_t *params,
 			   int use_colors)
 {
-	char *p = e->text;
-	const char *t_end = p + strlen(e->text);
-	int uuid_fmt_len;
-	int i = 0;
+	int i;
 
 	pe->subst_mask = 0;
-	pe->header =  e->header;
-	pe->file_name = e->file_name;
-	pe->text = e->text;
 
-	/*
-	 * Scan the text for possible replacements. We follow the Linux kernel
-	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
-	 * optional and can be one of 'b', 'B', 'l' (default), and 'L'.
-	 */
-	while ((p = strchr(p, '%'))) {
-		/* % can't be the last char */
-		if (p + 1 >= t_end) {
-			log_err("Invalid format string");
-			break;
-		}
-
-		/* scan format string */
-		if (p[1] == '%') {
-			/* Skip "%%" */
-			p += 2;
-		} else if (p[1] == 's') {
-			/* check for string printing, because it leads to logger crash */
-			log_err("String printing is not supported\n");
-			pe->params[i] = (uintptr_t)asprintf("<String @ 0x%08x>", e->params[i]);
+	for (i = 0; i < e->header.params_num; i++) {
+		switch (e->params[i].type) {
+		case LDC_PARAM_STRING:
+			pe->params[i] = (uintptr_t)asprintf("<String @ 0x%08x>", params[i]);
 			pe->subst_mask |= 1 << i;
-			++i;
-			p += 2;
-		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
+			break;
+		case LDC_PARAM_UUID:
 			/* substitute UUID entry address with formatted string pointer from heap */
-			pe->params[i] = (uintptr_t)asprintf_uuid(p, e->params[i], use_colors,
-								 &uuid_fmt_len);
+			pe->params[i] = (uintptr_t)format_uid(params[i], use_colors,
+							      e->params[i].be,
+							      e->params[i].upper);
 			pe->subst_mask |= 1 << i;
-			++i;
-			/* replace uuid formatter with %s */
-			p[1] = 's';
-			memmove(&p[2], &p[uuid_fmt_len], (int)(t_end - &p[uuid_fmt_len]) + 1);
-			p += uuid_fmt_len - 2;
-			t_end -= uuid_fmt_len - 2;
-		} else {
+			break;
+		default:
 			/* arguments different from %pU should be passed without modification */
-			pe->params[i] = e->params[i];
-			++i;
-			p += 2;
+			pe->params[i] = params[i];
+			break;
 		}
 	}
 }
@@ -337,7 +351,8 @@ static char *format_file_name(char *file_name_raw, int full_name)
 }
 
 static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+			       const struct ldc_entry *entry, const uint32_t *params,
+			       uint64_t last_timestamp)
 {
 	FILE *out_fd = global_config->out_fd;
 	int use_colors = global_config->use_colors;
@@ -382,8 +397,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		if (time_precision >= 0)
 			fprintf(out_fd, time_fmt, to_usecs(dma_log->timestamp), dt);
 		if (!hide_location)
-			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
+			fprintf(out_fd, "(%s:%u) ", entry->location,
 				entry->header.line_idx);
 	} else {
 		/* timestamp */
@@ -414,8 +428,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 
 		/* location */
 		if (!hide_location)
-			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
+			fprintf(out_fd, "%24s:%-4u ", entry->location,
 				entry->header.line_idx);
 
 		/* level name */
@@ -424,28 +437,28 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			get_level_name(entry->header.level));
 	}
 
-	process_params(&proc_entry, entry, use_colors);
+	process_params(&proc_entry, entry, params, use_colors);
 
-	switch (proc_entry.header.params_num) {
+	switch (entry->header.params_num) {
 	case 0:
-		ret = fprintf(out_fd, "%s", proc_entry.text);
+		ret = fprintf(out_fd, "%s", entry->text);
 		break;
 	case 1:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0]);
+		ret = fprintf(out_fd, entry->text, proc_entry.params[0]);
 		break;
 	case 2:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1]);
+		ret = fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1]);
 		break;
 	case 3:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
+		ret = fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1],
 			      proc_entry.params[2]);
 		break;
 	case 4:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
+		ret = fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1],
 			      proc_entry.params[2], proc_entry.params[3]);
 		break;
 	default:
-		log_err("Unsupported number of arguments for '%s'", proc_entry.text);
+		log_err("Unsupported number of arguments for '%s'", entry->text);
 		ret = 0; /* don't log ferror */
 		break;
 	}
@@ -453,144 +466,286 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	/* log format text comes from ldc file (may be invalid), so error check is needed here */
 	if (ret < 0)
 		log_err("trace fprintf failed for '%s', %d '%s'",
-			proc_entry.text, ferror(out_fd), strerror(ferror(out_fd)));
+			entry->text, ferror(out_fd), strerror(ferror(out_fd)));
 	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
+
+	/* live input is shown as it comes, a dump file is written in chunks */
+	if (global_config->trace || global_config->input_std ||
+	    global_config->serial_fd >= 0)
+		fflush(out_fd);
 }
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+/* Parse format text of the entry. The %pUx formats are replaced with %s
+ * and the parameter types are stored to the entry.
+ */
+static void parse_entry_text(struct ldc_entry *entry)
 {
-	uint32_t base_address = global_config->logs_header->base_address;
-	uint32_t data_offset = global_config->logs_header->data_offset;
+	char *p = entry->text;
+	char *t_end = p + strlen(entry->text);
+	int uuid_fmt_len;
+	int i = 0;
 
-	int ret;
+	/*
+	 * Scan the text for possible replacements. We follow the Linux kernel
+	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
+	 * optional and can be one of 'b', 'B', 'l' (default), and 'L'.
+	 */
+	while ((p = strchr(p, '%')) && i < TRACE_MAX_PARAMS_COUNT) {
+		/* % can't be the last char */
+		if (p + 1 >= t_end) {
+			log_err("Invalid format string");
+			break;
+		}
 
-	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
+		/* scan format string */
+		if (p[1] == '%') {
+			/* Skip "%%" */
+			p += 2;
+		} else if (p[1] == 's') {
+			/* check for string printing, because it leads to logger crash */
+			log_err("String printing is not supported\n");
+			entry->params[i++].type = LDC_PARAM_STRING;
+			p += 2;
+		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
+			entry->params[i].type = LDC_PARAM_UUID;
+			uuid_fmt_len = parse_uuid_fmt(p, &entry->params[i]);
+			++i;
+			/* replace uuid formatter with %s */
+			p[1] = 's';
+			memmove(&p[2], &p[uuid_fmt_len], (int)(t_end - &p[uuid_fmt_len]) + 1);
+			p += 2;
+			t_end -= uuid_fmt_len - 2;
+		} else {
+			entry->params[i++].type = LDC_PARAM_VALUE;
+			p += 2;
+		}
+	}
+}
+
+static void free_ldc_entry(struct ldc_entry *entry)
+{
+	free(entry->text);
+	free(entry->file_name);
+	free(entry);
+}
 
-	entry->file_name = NULL;
-	entry->text = NULL;
-	entry->params = NULL;
+/* create entry from the log entries section in memory */
+static struct ldc_entry *read_entry_from_ldc(uint32_t log_entry_address)
+{
+	uint32_t base_address = global_config->logs_header->base_address;
+	uint32_t data_length = global_config->logs_header->data_length;
+	struct ldc_entry *entry;
+	uint8_t *data;
 
-	/* set file position to beginning of processed entry */
-	fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
+	/* evaluate entry offset in log entries section */
+	uint32_t entry_offset = log_entry_address - base_address;
 
-	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (!ret) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
+	if (entry_offset >= data_length ||
+	    data_length - entry_offset < sizeof(entry->header)) {
+		log_err("Invalid log entry address 0x%x\n", log_entry_address);
+		return NULL;
 	}
+
+	entry = calloc(1, sizeof(*entry));
+	if (!entry) {
+		log_err("can't allocate %d byte for entry\n", (int)sizeof(*entry));
+		return NULL;
+	}
+
+	data = ldc_dict.data + entry_offset;
+	memcpy(&entry->header, data, sizeof(entry->header));
+	data += sizeof(entry->header);
+	entry->address = log_entry_address;
+
 	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
 		log_err("Invalid filename length or ldc file does not match firmware\n");
-		ret = -EINVAL;
-		goto out;
+		goto err;
 	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len);
 
-	if (!entry->file_name) {
-		log_err("can't allocate %d byte for entry.file_name\n",
-			entry->header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
+	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
+		log_err("Invalid text length.\n");
+		goto err;
 	}
 
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	if (ret != entry->header.file_name_len) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
+		log_err("Invalid number of parameters.\n");
+		goto err;
 	}
 
-	/* fetching text */
-	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
-		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
+	if (entry_offset + sizeof(entry->header) + entry->header.file_name_len +
+	    entry->header.text_len > data_length) {
+		log_err("Log entry at 0x%x exceeds ldc file\n", log_entry_address);
+		goto err;
 	}
-	entry->text = (char *)malloc(entry->header.text_len);
-	if (!entry->text) {
-		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
-		ret = -ENOMEM;
-		goto out;
+
+	/* the strings are copied with terminating null */
+	entry->file_name = calloc(1, entry->header.file_name_len + 1);
+	entry->text = calloc(1, entry->header.text_len + 1);
+	if (!entry->file_name || !entry->text) {
+		log_err("can't allocate memory for entry strings\n");
+		goto err;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
+
+	memcpy(entry->file_name, data, entry->header.file_name_len);
+	data += entry->header.file_name_len;
+	memcpy(entry->text, data, entry->header.text_len);
+
+	entry->location = format_file_name(entry->file_name,
+					   global_config->raw_output);
+	parse_entry_text(entry);
+
+	return entry;
+
+err:
+	free_ldc_entry(entry);
+	return NULL;
+}
+
+static uint32_t ldc_hash(uint32_t address, uint32_t bits)
+{
+	/* Fibonacci hashing */
+	return (address * 0x9e3779b1) >> (32 - bits);
+}
+
+static void ldc_table_insert(struct ldc_entry **table, uint32_t bits,
+			     struct ldc_entry *entry)
+{
+	uint32_t mask = (1 << bits) - 1;
+	uint32_t i = ldc_hash(entry->address, bits);
+
+	while (table[i])
+		i = (i + 1) & mask;
+
+	table[i] = entry;
+}
+
+/* double the hash table size */
+static int ldc_table_grow(void)
+{
+	uint32_t size = 1 << ldc_dict.table_bits;
+	struct ldc_entry **table;
+	uint32_t i;
+
+	table = calloc(2 * size, sizeof(*table));
+	if (!table) {
+		log_err("can't allocate ldc entries table\n");
+		return -ENOMEM;
 	}
 
+	for (i = 0; i < size; i++) {
+		if (ldc_dict.table[i])
+			ldc_table_insert(table, ldc_dict.table_bits + 1,
+					 ldc_dict.table[i]);
+	}
+
+	free(ldc_dict.table);
+	ldc_dict.table = table;
+	ldc_dict.table_bits++;
 	return 0;
+}
 
-out:
-	free(entry->text);
-	entry->text = NULL;
-	free(entry->file_name);
-	entry->file_name = NULL;
+/* get entry from the hash table or parse it from dictionary */
+static struct ldc_entry *get_entry(uint32_t log_entry_address)
+{
+	uint32_t mask = (1 << ldc_dict.table_bits) - 1;
+	uint32_t i = ldc_hash(log_entry_address, ldc_dict.table_bits);
+	struct ldc_entry *entry;
 
-	return ret;
+	for (; ldc_dict.table[i]; i = (i + 1) & mask) {
+		if (ldc_dict.table[i]->address == log_entry_address)
+			return ldc_dict.table[i];
+	}
+
+	entry = read_entry_from_ldc(log_entry_address);
+	if (!entry)
+		return NULL;
+
+	/* keep load factor below 1/2 */
+	if (2 * (ldc_dict.count + 1) > mask + 1 && ldc_table_grow() < 0) {
+		free_ldc_entry(entry);
+		return NULL;
+	}
+
+	ldc_table_insert(ldc_dict.table, ldc_dict.table_bits, entry);
+	ldc_dict.count++;
+	return entry;
+}
+
+/* read the log entries section of ldc file to memory */
+static int ldc_dict_init(void)
+{
+	const struct snd_sof_logs_header *hdr = global_config->logs_header;
+
+	ldc_dict.count = 0;
+	ldc_dict.table_bits = LDC_TABLE_BITS_INIT;
+	ldc_dict.table = calloc(1 << ldc_dict.table_bits, sizeof(*ldc_dict.table));
+	ldc_dict.data = malloc(hdr->data_length);
+	if (!ldc_dict.table || !ldc_dict.data) {
+		log_err("failed to alloc memory for log entries.\n");
+		return -ENOMEM;
+	}
+
+	if (fseek(global_config->ldc_fd, hdr->data_offset, SEEK_SET) ||
+	    fread(ldc_dict.data, hdr->data_length, 1, global_config->ldc_fd) != 1) {
+		log_err("failed to read log entries from %s.\n", global_config->ldc_file);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static void ldc_dict_free(void)
+{
+	uint32_t i;
+
+	if (ldc_dict.table) {
+		for (i = 0; i < 1 << ldc_dict.table_bits; i++) {
+			if (ldc_dict.table[i])
+				free_ldc_entry(ldc_dict.table[i]);
+		}
+	}
+
+	free(ldc_dict.table);
+	free(ldc_dict.data);
+	ldc_dict.table = NULL;
+	ldc_dict.data = NULL;
 }
 
 static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
 {
-	struct ldc_entry entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	struct ldc_entry *entry;
 	int ret;
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
-	if (ret < 0)
-		goto out;
+	entry = get_entry(dma_log->log_entry_address);
+	if (!entry)
+		return -EINVAL;
 
 	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
-	}
-
 	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+		ret = fread(params, sizeof(uint32_t), entry->header.params_num,
 			    global_config->in_fd);
-		if (ret != entry.header.params_num) {
-			ret = -ferror(global_config->in_fd);
-			goto out;
-		}
+		if (ret != entry->header.params_num)
+			return -ferror(global_config->in_fd);
 	} else {
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
+		size_t size = sizeof(uint32_t) * entry->header.params_num;
 		uint8_t *n;
 
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
-			if (ret < 0) {
-				ret = -errno;
-				goto out;
-			}
+			if (ret < 0)
+				return -errno;
+
 			if (ret != size)
 				log_err("Partial read of %u bytes of %lu.\n", ret, size);
 		}
 	}
 
 	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
+	print_entry_params(dma_log, entry, params, *last_timestamp);
 	*last_timestamp = dma_log->timestamp;
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
-
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
-
-	return ret;
+	return 0;
 }
 
 static int serial_read(uint64_t *last_timestamp)
@@ -644,6 +799,212 @@ static int serial_read(uint64_t *last_timestamp)
 	return fetch_entry(&dma_log, last_timestamp);
 }
 
+/*
+ * Reads size bytes from the input and reopens the input in trace mode at
+ * end of file. Returns 0 on success, 1 at end of file or error code.
+ */
+static int read_input(void *data, size_t size)
+{
+	int ret;
+
+	while (fread(data, size, 1, global_config->in_fd) != 1) {
+		/*
+		 * use ferror (not errno) to check fread fail -
+		 * see https://www.gnu.org/software/gnulib/manual/html_node/fread.html
+		 */
+		ret = -ferror(global_config->in_fd);
+		if (ret) {
+			log_err("in %s(), fread(..., %s) failed: %s(%d)\n",
+				__func__, global_config->in_file,
+				strerror(-ret), ret);
+			return ret;
+		}
+
+		/* for trace mode, try to reopen */
+		if (!global_config->trace) {
+			/* EOF */
+			if (!feof(global_config->in_fd))
+				log_err("file '%s' is unaligned with trace entry size (%ld)\n",
+					global_config->in_file, size);
+			return 1;
+		}
+
+		if (!freopen(NULL, "rb", global_config->in_fd)) {
+			log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
+				__func__, global_config->in_file,
+				strerror(errno), errno);
+			return -errno;
+		}
+	}
+
+	return 0;
+}
+
+static int compact_read_byte(struct compact_input *in, uint8_t *byte)
+{
+	int ret;
+
+	if (in->pos < sizeof(in->head)) {
+		*byte = in->head[in->pos++];
+		return 0;
+	}
+
+	ret = read_input(byte, sizeof(*byte));
+	if (!ret)
+		in->pos++;
+
+	return ret;
+}
+
+static int compact_read_u32(struct compact_input *in, uint32_t *value)
+{
+	uint8_t byte;
+	int ret;
+	int i;
+
+	*value = 0;
+	for (i = 0; i < sizeof(*value); i++) {
+		ret = compact_read_byte(in, &byte);
+		if (ret)
+			return ret;
+
+		*value |= (uint32_t)byte << (8 * i);
+	}
+
+	return 0;
+}
+
+static int compact_read_varint(struct compact_input *in, uint64_t *value)
+{
+	uint8_t byte;
+	int shift;
+	int ret;
+
+	*value = 0;
+	for (shift = 0; shift < 64; shift += 7) {
+		ret = compact_read_byte(in, &byte);
+		if (ret)
+			return ret;
+
+		*value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return 0;
+	}
+
+	return -EINVAL;
+}
+
+static uint64_t zigzag_decode(uint64_t value)
+{
+	return (value >> 1) ^ -(value & 1);
+}
+
+/* decodes the compact entry fields following the tag, core and slot bytes */
+static int compact_decode(struct compact_input *in, uint8_t tag, uint8_t slot,
+			  struct log_entry_header *dma_log, uint32_t *params)
+{
+	uint32_t nargs = TRACE_COMPACT_ARGS(tag);
+	uint64_t value;
+	int ret;
+	int i;
+
+	if ((slot & ~TRACE_COMPACT_SLOT_HIT) >= TRACE_COMPACT_DICT_SIZE ||
+	    nargs > TRACE_MAX_PARAMS_COUNT)
+		return -EINVAL;
+
+	if (tag & TRACE_COMPACT_SYNC) {
+		memset(compact.dict, 0, sizeof(compact.dict));
+		compact.synced = true;
+	}
+
+	if (slot & TRACE_COMPACT_SLOT_HIT) {
+		slot &= ~TRACE_COMPACT_SLOT_HIT;
+	} else {
+		ret = compact_read_u32(in, &compact.dict[slot].uid);
+		if (!ret)
+			ret = compact_read_u32(in, &compact.dict[slot].log_entry_address);
+		if (ret)
+			return ret;
+	}
+	dma_log->uid = compact.dict[slot].uid;
+	dma_log->log_entry_address = compact.dict[slot].log_entry_address;
+
+	ret = compact_read_varint(in, &value);
+	if (ret)
+		return ret;
+	if (tag & TRACE_COMPACT_SYNC)
+		compact.timestamp = value;
+	else
+		compact.timestamp += zigzag_decode(value);
+	dma_log->timestamp = compact.timestamp;
+
+	ret = compact_read_varint(in, &value);
+	if (ret)
+		return ret;
+	dma_log->id_0 = value;
+
+	ret = compact_read_varint(in, &value);
+	if (ret)
+		return ret;
+	dma_log->id_1 = value;
+
+	for (i = 0; i < nargs; i++) {
+		ret = compact_read_varint(in, &value);
+		if (ret)
+			return ret;
+		params[i] = zigzag_decode(value);
+	}
+
+	return 0;
+}
+
+/* decodes the compact entry starting with the already read dword */
+static int fetch_compact_entry(uint32_t head, uint64_t *last_timestamp)
+{
+	struct log_entry_header dma_log;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	struct compact_input in = { .pos = 3 };
+	struct ldc_entry *entry;
+	uint8_t pad;
+	int ret;
+	int err;
+
+	memcpy(in.head, &head, sizeof(head));
+	dma_log.core_id = in.head[1];
+
+	err = compact_decode(&in, in.head[0], in.head[2], &dma_log, params);
+	if (err > 0)
+		return err;
+
+	/* keep the input aligned to dwords also after a corrupted entry */
+	while (in.pos % sizeof(uint32_t)) {
+		ret = compact_read_byte(&in, &pad);
+		if (ret)
+			return ret;
+	}
+
+	if (err < 0)
+		return err;
+
+	/* the dictionary is not known before the first sync entry */
+	if (!compact.synced)
+		return 0;
+
+	if (dma_log.log_entry_address < global_config->logs_header->base_address ||
+	    dma_log.log_entry_address > global_config->logs_header->base_address +
+	    global_config->logs_header->data_length)
+		return -EINVAL;
+
+	entry = get_entry(dma_log.log_entry_address);
+	if (!entry || entry->header.params_num != TRACE_COMPACT_ARGS(in.head[0]))
+		return -EINVAL;
+
+	print_entry_params(&dma_log, entry, params, *last_timestamp);
+	*last_timestamp = dma_log.timestamp;
+
+	return 0;
+}
+
 static int logger_read(void)
 {
 	struct log_entry_header dma_log;
@@ -662,39 +1023,28 @@ static int logger_read(void)
 		}
 
 	while (!ferror(global_config->in_fd)) {
-		/* getting entry parameters from dma dump */
-		ret = fread(&dma_log, sizeof(dma_log), 1, global_config->in_fd);
-		if (ret != 1) {
-			/*
-			 * use ferror (not errno) to check fread fail -
-			 * see https://www.gnu.org/software/gnulib/manual/html_node/fread.html
-			 */
-			ret = -ferror(global_config->in_fd);
-			if (ret) {
-				log_err("in %s(), fread(..., %s) failed: %s(%d)\n",
-					__func__, global_config->in_file,
-					strerror(-ret), ret);
-				return ret;
-			}
-			/* for trace mode, try to reopen */
-			if (global_config->trace) {
-				if (freopen(NULL, "rb", global_config->in_fd)) {
-					continue;
-				} else {
-					log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
-						__func__, global_config->in_file,
-						strerror(errno), errno);
-					return -errno;
-				}
-			} else {
-				/* EOF */
-				if (!feof(global_config->in_fd))
-					log_err("file '%s' is unaligned with trace entry size (%ld)\n",
-						global_config->in_file, sizeof(dma_log));
+		/* the first dword tells compact entries apart */
+		ret = read_input(&dma_log, sizeof(uint32_t));
+		if (ret)
+			break;
+
+		if ((dma_log.uid & TRACE_COMPACT_TAG_MASK) == TRACE_COMPACT_TAG) {
+			ret = fetch_compact_entry(dma_log.uid, &last_timestamp);
+			if (ret > 0)
 				break;
-			}
+
+			/* a corrupted entry invalidates the dictionary */
+			if (ret < 0)
+				compact.synced = false;
+			continue;
 		}
 
+		/* getting entry parameters from dma dump */
+		ret = read_input((uint8_t *)&dma_log + sizeof(uint32_t),
+				 sizeof(dma_log) - sizeof(uint32_t));
+		if (ret)
+			break;
+
 		/* checking if received trace address is located in
 		 * entry section in elf file.
 		 */
@@ -715,7 +1065,7 @@ static int logger_read(void)
 			break;
 	}
 
-	return ret;
+	return ret < 0 ? ret : 0;
 }
 
 /* fw verification */
@@ -870,8 +1220,14 @@ int convert(struct convert_config *config)
 		}
 	}
 
+	/* log entries are parsed from memory when first used */
+	ret = ldc_dict_init();
+	if (ret)
+		goto out;
+
 	ret = logger_read();
 out:
+	ldc_dict_free();
 	free(config->uids_dict);
 	return ret;
 }
@@ -17,9 +17,11 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/math/numbers.h>
 #include <ipc/stream.h>
 #include "testbench/common_test.h"
 #include "testbench/file.h"
+#include "wave.h"
 
 /* bfc7488c-75aa-4ce8-9bde-d8da08a698c2 */
 DECLARE_SOF_UUID("file", file_uuid, 0xbfc7488c, 0x75aa, 0x4ce8,
@@ -29,288 +31,326 @@ DECLARE_TR_CTX(file_tr, SOF_UUID(file_uuid), LOG_LEVEL_INFO);
 static const struct comp_driver comp_file_dai;
 static const struct comp_driver comp_file_host;
 
-static inline void buffer_check_wrap_32(int32_t **ptr, int32_t *end,
-					size_t size)
+/* Samples for S24_4LE conversions of binary files */
+#define FILE_CONVERT_SAMPLES	1024
+
+/* stdio buffer size for binary files */
+#define FILE_IO_BUFFER_SIZE	(256 * 1024)
+
+#define WAVE_FORMAT_PCM		0x0001
+#define WAVE_FORMAT_EXTENSIBLE	0xfffe
+
+static int file_sample_bytes(int fmt)
 {
-	if (*ptr >= end)
-		*ptr = (int32_t *)((size_t)*ptr - size);
+	return fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
 }
 
-static inline void buffer_check_wrap_16(int16_t **ptr, int16_t *end,
-					size_t size)
+/* Read n samples of text to contiguous dest */
+static int read_text(struct file_comp_data *cd, void *dest, int n, int fmt)
 {
-	if (*ptr >= end)
-		*ptr = (int16_t *)((size_t)*ptr - size);
+	int16_t *dest16 = dest;
+	int32_t *dest32 = dest;
+	int32_t sample;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		switch (fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			if (fscanf(cd->fs.rfh, "%hd", &dest16[i]) != 1)
+				return i;
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			/* mask bits if 24-bit samples */
+			if (fscanf(cd->fs.rfh, "%d", &sample) != 1)
+				return i;
+			dest32[i] = sample & 0x00ffffff;
+			break;
+		default:
+			if (fscanf(cd->fs.rfh, "%d", &dest32[i]) != 1)
+				return i;
+			break;
+		}
+	}
+
+	return n;
 }
 
-/*
- * Read 32-bit samples from file
- * currently only supports txt files
- */
-static int read_samples_32(struct comp_dev *dev,
-			   const struct audio_stream *sink,
-			   int n, int fmt, int nch)
+/* Read n samples of raw or WAV data to contiguous dest */
+static int read_binary(struct file_comp_data *cd, void *dest, int n, int fmt)
 {
-	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int32_t *dest = (int32_t *)sink->w_ptr;
-	int32_t sample;
-	int n_wrap;
-	int n_min;
+	int sample_bytes = file_sample_bytes(fmt);
+	int32_t *dest32 = dest;
+	int ret;
 	int i;
-	int n_samples = 0;
-	int ret = 0;
 
-	while (n > 0) {
-		n_wrap = (int32_t *)sink->end_addr - dest;
+	/* the data chunk can be followed by other chunks */
+	if (cd->fs.f_format == FILE_WAV)
+		n = MIN(n, cd->fs.data_bytes / sample_bytes);
+
+	ret = fread(dest, sample_bytes, n, cd->fs.rfh);
+	if (cd->fs.f_format == FILE_WAV)
+		cd->fs.data_bytes -= ret * sample_bytes;
+
+	/* mask bits if 24-bit samples, WAV has them in the MSBs */
+	if (fmt == SOF_IPC_FRAME_S24_4LE) {
+		if (cd->fs.f_format == FILE_WAV) {
+			for (i = 0; i < ret; i++)
+				dest32[i] = (dest32[i] >> 8) & 0x00ffffff;
+		} else {
+			for (i = 0; i < ret; i++)
+				dest32[i] &= 0x00ffffff;
+		}
+	}
 
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-				}
-				dest++;
-				n_samples++;
-			}
+	return ret;
+}
+
+/* Write n samples from contiguous src as text */
+static int write_text(struct file_comp_data *cd, const void *src, int n,
+		      int fmt)
+{
+	const int16_t *src16 = src;
+	const int32_t *src32 = src;
+	int ret;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		switch (fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			ret = fprintf(cd->fs.wfh, "%d\n", src16[i]);
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			ret = fprintf(cd->fs.wfh, "%d\n", sign_extend_s24(src32[i]));
+			break;
+		default:
+			ret = fprintf(cd->fs.wfh, "%d\n", src32[i]);
+			break;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_32(&dest, sink->end_addr,
-				     sink->size);
+
+		if (ret < 0)
+			return i;
 	}
-quit:
-	return n_samples;
+
+	return n;
 }
 
-/*
- * Read 16-bit samples from file
- * currently only supports txt files
- */
-static int read_samples_16(struct comp_dev *dev,
-			   const struct audio_stream *sink,
-			   int n, int nch)
+/* Write n samples from contiguous src as raw or WAV data */
+static int write_binary(struct file_comp_data *cd, const void *src, int n,
+			int fmt)
 {
-	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int16_t *dest = (int16_t *)sink->w_ptr;
-	int i, n_wrap, n_min, ret;
+	int32_t tmp[FILE_CONVERT_SAMPLES];
+	const int32_t *src32 = src;
+	int sample_bytes = file_sample_bytes(fmt);
 	int n_samples = 0;
+	int n_min;
+	int ret;
+	int i;
 
-	/* copy samples */
-	while (n > 0) {
-		n_wrap = (int16_t *)sink->end_addr - dest;
-
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-				}
-
-				dest++;
-				n_samples++;
+	if (fmt != SOF_IPC_FRAME_S24_4LE) {
+		n_samples = fwrite(src, sample_bytes, n, cd->fs.wfh);
+	} else {
+		/* 24-bit samples are sign extended for raw files and
+		 * aligned to MSB for WAV files
+		 */
+		while (n_samples < n) {
+			n_min = MIN(n - n_samples, FILE_CONVERT_SAMPLES);
+			for (i = 0; i < n_min; i++) {
+				if (cd->fs.f_format == FILE_WAV)
+					tmp[i] = (uint32_t)src32[i] << 8;
+				else
+					tmp[i] = sign_extend_s24(src32[i]);
 			}
+
+			ret = fwrite(tmp, sample_bytes, n_min, cd->fs.wfh);
+			n_samples += ret;
+			if (ret != n_min)
+				break;
+
+			src32 += n_min;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_16(&dest, sink->end_addr,
-				     sink->size);
 	}
 
-quit:
+	cd->fs.data_bytes += n_samples * sample_bytes;
 	return n_samples;
 }
 
 /*
- * Write 16-bit samples from file
- * currently only supports txt files
+ * Read samples from file to sink. The samples are read to the
+ * contiguous regions of the sink buffer.
  */
-static int write_samples_16(struct comp_dev *dev, struct audio_stream *source,
-			    int n, int nch)
+static int read_samples(struct comp_dev *dev, const struct audio_stream *sink,
+			int n, int fmt)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src = (int16_t *)source->r_ptr;
-	int i, n_wrap, n_min, ret;
+	int sample_bytes = file_sample_bytes(fmt);
+	char *dest = sink->w_ptr;
 	int n_samples = 0;
+	int n_wrap;
+	int n_min;
+	int ret;
 
-	/* copy samples */
 	while (n > 0) {
-		n_wrap = (int16_t *)source->end_addr - src;
-
 		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
-
-				src++;
-				n_samples++;
-			}
+		n_wrap = ((char *)sink->end_addr - dest) / sample_bytes;
+		n_min = MIN(n, n_wrap);
+		if (cd->fs.f_format == FILE_TEXT)
+			ret = read_text(cd, dest, n_min, fmt);
+		else
+			ret = read_binary(cd, dest, n_min, fmt);
+
+		n_samples += ret;
+
+		/* quit if eof is reached */
+		if (ret < n_min) {
+			cd->fs.reached_eof = 1;
+			break;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_16(&src, source->end_addr,
-				     source->size);
+
+		n -= n_min;
+		dest = audio_stream_wrap(sink, dest + n_min * sample_bytes);
 	}
-quit:
+
 	return n_samples;
 }
 
 /*
- * Write 32-bit samples from file
- * currently only supports txt files
+ * Write samples from source to file. The samples are written from the
+ * contiguous regions of the source buffer.
  */
-static int write_samples_32(struct comp_dev *dev, struct audio_stream *source,
-			    int n, int fmt, int nch)
+static int write_samples(struct comp_dev *dev, struct audio_stream *source,
+			 int n, int fmt)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src = (int32_t *)source->r_ptr;
-	int i, n_wrap, n_min, ret;
+	int sample_bytes = file_sample_bytes(fmt);
+	char *src = source->r_ptr;
 	int n_samples = 0;
-	int32_t sample;
+	int n_wrap;
+	int n_min;
+	int ret;
 
-	/* copy samples */
 	while (n > 0) {
-		n_wrap = (int32_t *)source->end_addr - src;
-
 		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
-				}
-
-				/* increment read pointer */
-				src++;
-
-				/* increment number of samples written */
-				n_samples++;
+		n_wrap = ((char *)source->end_addr - src) / sample_bytes;
+		n_min = MIN(n, n_wrap);
+		if (cd->fs.f_format == FILE_TEXT)
+			ret = write_text(cd, src, n_min, fmt);
+		else
+			ret = write_binary(cd, src, n_min, fmt);
+
+		n_samples += ret;
+		if (ret < n_min)
+			break;
+
+		n -= n_min;
+		src = audio_stream_wrap(source, src + n_min * sample_bytes);
+	}
+
+	return n_samples;
+}
+
+/* Parse WAV header and leave file position to start of data */
+static int file_read_wave_header(struct file_comp_data *cd)
+{
+	struct riff_chunk riff;
+	struct fmt_subchunk fmt;
+	uint32_t chunk[2];
+	uint16_t ext[12];
+	uint32_t skip;
+	int fmt_found = 0;
+
+	if (fread(&riff, sizeof(riff), 1, cd->fs.rfh) != 1 ||
+	    riff.chunk_id != HEADER_RIFF || riff.format != HEADER_WAVE) {
+		fprintf(stderr, "error: %s is not a WAV file\n", cd->fs.fn);
+		return -EINVAL;
+	}
+
+	/* find format and data chunks, skip other chunks */
+	while (fread(chunk, sizeof(chunk), 1, cd->fs.rfh) == 1) {
+		skip = chunk[1] + (chunk[1] & 1);
+		switch (chunk[0]) {
+		case HEADER_FMT:
+			if (chunk[1] < sizeof(fmt) - offsetof(struct fmt_subchunk, audio_format) ||
+			    fread(&fmt.audio_format, sizeof(fmt) -
+				  offsetof(struct fmt_subchunk, audio_format), 1,
+				  cd->fs.rfh) != 1)
+				goto err;
+
+			skip -= sizeof(fmt) - offsetof(struct fmt_subchunk, audio_format);
+
+			/* sub format GUID starts with the format tag */
+			if (fmt.audio_format == WAVE_FORMAT_EXTENSIBLE &&
+			    skip >= sizeof(ext)) {
+				if (fread(ext, sizeof(ext), 1, cd->fs.rfh) != 1)
+					goto err;
+
+				fmt.audio_format = ext[4];
+				skip -= sizeof(ext);
+			}
+
+			fmt_found = 1;
+			break;
+		case HEADER_DATA:
+			if (!fmt_found)
+				goto err;
+
+			if (fmt.audio_format != WAVE_FORMAT_PCM ||
+			    fmt.num_channels != cd->channels ||
+			    fmt.bits_per_sample != 8 * file_sample_bytes(cd->frame_fmt)) {
+				fprintf(stderr,
+					"error: %s format %d, %d channels, %d bits mismatch\n",
+					cd->fs.fn, fmt.audio_format,
+					fmt.num_channels, fmt.bits_per_sample);
+				return -EINVAL;
 			}
+
+			if (fmt.sample_rate != cd->rate)
+				fprintf(stderr, "warning: %s rate is %u, not %u\n",
+					cd->fs.fn, fmt.sample_rate, cd->rate);
+
+			cd->fs.data_bytes = chunk[1];
+			return 0;
+		default:
+			break;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_32(&src, source->end_addr,
-				     source->size);
+
+		if (skip && fseek(cd->fs.rfh, skip, SEEK_CUR))
+			goto err;
 	}
-quit:
-	return n_samples;
+
+err:
+	fprintf(stderr, "error: invalid WAV header in %s\n", cd->fs.fn);
+	return -EINVAL;
+}
+
+/* Write WAV header, the sizes are updated when the file is closed */
+static int file_write_wave_header(struct file_comp_data *cd)
+{
+	struct wave header;
+	int sample_bytes = file_sample_bytes(cd->frame_fmt);
+
+	header.riff.chunk_id = HEADER_RIFF;
+	header.riff.chunk_size = sizeof(header) -
+		offsetof(struct riff_chunk, format) + cd->fs.data_bytes;
+	header.riff.format = HEADER_WAVE;
+	header.fmt.subchunk_id = HEADER_FMT;
+	header.fmt.subchunk_size = sizeof(header.fmt) -
+		offsetof(struct fmt_subchunk, audio_format);
+	header.fmt.audio_format = WAVE_FORMAT_PCM;
+	header.fmt.num_channels = cd->channels;
+	header.fmt.sample_rate = cd->rate;
+	header.fmt.byte_rate = cd->rate * cd->channels * sample_bytes;
+	header.fmt.block_align = cd->channels * sample_bytes;
+	header.fmt.bits_per_sample = 8 * sample_bytes;
+	header.data.subchunk_id = HEADER_DATA;
+	header.data.subchunk_size = cd->fs.data_bytes;
+
+	if (fseek(cd->fs.wfh, 0, SEEK_SET) ||
+	    fwrite(&header, sizeof(header), 1, cd->fs.wfh) != 1) {
+		fprintf(stderr, "error: writing WAV header to %s\n", cd->fs.fn);
+		return -EIO;
+	}
+
+	return 0;
 }
 
 /* function for processing 32-bit samples */
@@ -325,14 +365,14 @@ static int file_s32_default(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S32_LE, nch);
+		n_samples = read_samples(dev, sink, frames * nch,
+					 SOF_IPC_FRAME_S32_LE);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S32_LE, nch);
+		n_samples = write_samples(dev, source, frames * nch,
+					  SOF_IPC_FRAME_S32_LE);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -355,12 +395,14 @@ static int file_s16(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_16(dev, sink, frames * nch, nch);
+		n_samples = read_samples(dev, sink, frames * nch,
+					 SOF_IPC_FRAME_S16_LE);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_16(dev, source, frames * nch, nch);
+		n_samples = write_samples(dev, source, frames * nch,
+					  SOF_IPC_FRAME_S16_LE);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -383,14 +425,14 @@ static int file_s24(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S24_4LE, nch);
+		n_samples = read_samples(dev, sink, frames * nch,
+					 SOF_IPC_FRAME_S24_4LE);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S24_4LE, nch);
+		n_samples = write_samples(dev, source, frames * nch,
+					  SOF_IPC_FRAME_S24_4LE);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -405,12 +447,35 @@ static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
+	if (!ext)
+		return FILE_RAW;
+
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
+static FILE *file_open(struct file_comp_data *cd, const char *mode)
+{
+	FILE *fh = fopen(cd->fs.fn, mode);
+
+	if (!fh) {
+		fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
+		return NULL;
+	}
+
+	/* large stdio buffer to access the file in big chunks */
+	cd->fs.iobuf = malloc(FILE_IO_BUFFER_SIZE);
+	if (cd->fs.iobuf)
+		setvbuf(fh, cd->fs.iobuf, _IOFBF, FILE_IO_BUFFER_SIZE);
+
+	return fh;
+}
+
 static struct comp_dev *file_new(const struct comp_driver *drv,
 				 struct sof_ipc_comp *comp)
 {
@@ -463,22 +528,22 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	/* open file handle(s) depending on mode */
 	switch (cd->fs.mode) {
 	case FILE_READ:
-		cd->fs.rfh = fopen(cd->fs.fn, "r");
-		if (!cd->fs.rfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
-		}
+		cd->fs.rfh = file_open(cd, "rb");
+		if (!cd->fs.rfh)
+			goto error;
+
+		if (cd->fs.f_format == FILE_WAV &&
+		    file_read_wave_header(cd) < 0)
+			goto error;
 		break;
 	case FILE_WRITE:
-		cd->fs.wfh = fopen(cd->fs.fn, "w");
-		if (!cd->fs.wfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
-		}
+		cd->fs.wfh = file_open(cd, "wb");
+		if (!cd->fs.wfh)
+			goto error;
+
+		if (cd->fs.f_format == FILE_WAV &&
+		    file_write_wave_header(cd) < 0)
+			goto error;
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -491,6 +556,17 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	dev->state = COMP_STATE_READY;
 
 	return dev;
+
+error:
+	if (cd->fs.rfh)
+		fclose(cd->fs.rfh);
+	if (cd->fs.wfh)
+		fclose(cd->fs.wfh);
+	free(cd->fs.iobuf);
+	free(cd->fs.fn);
+	free(cd);
+	free(dev);
+	return NULL;
 }
 
 static void file_free(struct comp_dev *dev)
@@ -499,11 +575,17 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
-	if (cd->fs.mode == FILE_READ)
+	if (cd->fs.mode == FILE_READ) {
 		fclose(cd->fs.rfh);
-	else
+	} else {
+		/* update the data size to WAV header */
+		if (cd->fs.f_format == FILE_WAV)
+			file_write_wave_header(cd);
+
 		fclose(cd->fs.wfh);
+	}
 
+	free(cd->fs.iobuf);
 	free(cd->fs.fn);
 	free(cd);
 	free(dev);
@@ -31,6 +31,7 @@ struct testbench_prm {
 	char *output_file[MAX_OUTPUT_FILE_NUM]; /* output file names */
 	int output_file_num; /* number of output files */
 	char *bits_in; /* input bit format */
+	char *profile_file; /* component profile output file */
 	/*
 	 * input and output sample rate parameters
 	 * By default, these are calculated from pipeline frames_per_sched
@@ -21,12 +21,15 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
 };
 
 /* file component state */
 struct file_state {
 	char *fn;
 	FILE *rfh, *wfh; /* read/write file handle */
+	void *iobuf; /* stdio buffer of the file handle */
+	uint32_t data_bytes; /* WAV data bytes left to read or written */
 	int reached_eof;
 	int n;
 	enum file_mode mode;
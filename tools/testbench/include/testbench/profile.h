@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2021 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include <stdio.h>
+
+struct sof;
+
+/* Start to measure the copy() execution time of all components */
+int tb_profile_init(struct sof *sof);
+
+/* Print min/avg/max/p99 copy time per component */
+void tb_profile_print(FILE *out);
+
+/* Write the statistics as JSON if the file has .json suffix, else CSV */
+int tb_profile_write(const char *filename);
+
+void tb_profile_free(void);
+
+#endif
@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+/* per component copy() execution time measurement */
+
+#include <sof/sof.h>
+#include <sof/list.h>
+#include <sof/audio/component.h>
+#include <sof/drivers/ipc.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "testbench/common_test.h"
+#include "testbench/profile.h"
+
+#define PROFILE_NAME_LEN	32
+#define PROFILE_SAMPLES_INIT	4096
+
+/* Measured copy() times of one component. The component uses a copy of
+ * its driver with profiling copy() operation so the profile data is
+ * found from the driver pointer.
+ */
+struct tb_comp_profile {
+	struct comp_driver drv;		/* driver with profiling copy() */
+	const struct comp_driver *orig;	/* original driver */
+	char name[PROFILE_NAME_LEN];
+	uint32_t id;
+	uint32_t pipeline_id;
+	uint32_t *samples;		/* execution times in ns */
+	uint32_t count;
+	uint32_t size;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	struct list_item list;
+};
+
+/* statistics computed for the report */
+struct tb_profile_stats {
+	uint32_t min;
+	uint32_t max;
+	uint32_t avg;
+	uint32_t p99;
+};
+
+static struct list_item profile_list;
+
+static int tb_profile_copy(struct comp_dev *dev)
+{
+	struct tb_comp_profile *prof = container_of(dev->drv,
+						    struct tb_comp_profile,
+						    drv);
+	struct timespec t0;
+	struct timespec t1;
+	uint32_t *samples;
+	uint32_t ns;
+	int ret;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	ret = prof->orig->ops.copy(dev);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	ns = (t1.tv_sec - t0.tv_sec) * 1000000000 + t1.tv_nsec - t0.tv_nsec;
+	prof->min = MIN(prof->min, ns);
+	prof->max = MAX(prof->max, ns);
+	prof->total += ns;
+
+	/* all times are kept for the percentile */
+	if (prof->count == prof->size) {
+		samples = realloc(prof->samples,
+				  2 * prof->size * sizeof(uint32_t));
+		if (!samples)
+			return ret;
+
+		prof->samples = samples;
+		prof->size *= 2;
+	}
+
+	prof->samples[prof->count++] = ns;
+	return ret;
+}
+
+/* name the component by its library table entry */
+static void tb_profile_name(struct tb_comp_profile *prof)
+{
+	const struct comp_driver *drv = prof->orig;
+	const char *name = "comp";
+	int i;
+
+	for (i = 0; i < NUM_WIDGETS_SUPPORTED; i++) {
+		if (drv->type != SOF_COMP_NONE &&
+		    drv->type == lib_table[i].widget_type) {
+			name = lib_table[i].comp_name;
+			break;
+		}
+
+		if (drv->type == SOF_COMP_NONE && lib_table[i].uid &&
+		    !memcmp(lib_table[i].uid, drv->uid, UUID_SIZE)) {
+			name = lib_table[i].comp_name;
+			break;
+		}
+	}
+
+	/* file components are both host and dai */
+	if (drv->type == SOF_COMP_DAI)
+		name = "file";
+
+	snprintf(prof->name, PROFILE_NAME_LEN, "%s.%u", name, prof->id);
+}
+
+int tb_profile_init(struct sof *sof)
+{
+	struct tb_comp_profile *prof;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct comp_dev *dev;
+
+	list_init(&profile_list);
+
+	list_for_item(clist, &sof->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		dev = icd->cd;
+		prof = calloc(1, sizeof(*prof));
+		if (!prof)
+			return -ENOMEM;
+
+		prof->samples = malloc(PROFILE_SAMPLES_INIT * sizeof(uint32_t));
+		if (!prof->samples) {
+			free(prof);
+			return -ENOMEM;
+		}
+
+		prof->size = PROFILE_SAMPLES_INIT;
+		prof->min = UINT32_MAX;
+		prof->id = dev_comp_id(dev);
+		prof->pipeline_id = dev_comp_pipe_id(dev);
+		prof->orig = dev->drv;
+		prof->drv = *dev->drv;
+		prof->drv.ops.copy = tb_profile_copy;
+		tb_profile_name(prof);
+		list_item_append(&prof->list, &profile_list);
+
+		dev->drv = &prof->drv;
+	}
+
+	return 0;
+}
+
+static int tb_profile_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void tb_profile_get_stats(struct tb_comp_profile *prof,
+				 struct tb_profile_stats *stats)
+{
+	uint32_t idx;
+
+	memset(stats, 0, sizeof(*stats));
+	if (!prof->count)
+		return;
+
+	stats->min = prof->min;
+	stats->max = prof->max;
+	stats->avg = prof->total / prof->count;
+
+	/* nearest rank percentile */
+	qsort(prof->samples, prof->count, sizeof(uint32_t), tb_profile_cmp);
+	idx = ((uint64_t)prof->count * 99 + 99) / 100 - 1;
+	stats->p99 = prof->samples[idx];
+}
+
+void tb_profile_print(FILE *out)
+{
+	struct tb_profile_stats stats;
+	struct tb_comp_profile *prof;
+	struct list_item *plist;
+	uint64_t total = 0;
+
+	list_for_item(plist, &profile_list) {
+		prof = container_of(plist, struct tb_comp_profile, list);
+		total += prof->total;
+	}
+
+	fprintf(out, "%-16s %4s %9s %9s %9s %9s %9s %6s\n", "Component",
+		"Pipe", "Copies", "Min us", "Avg us", "Max us", "P99 us",
+		"Load");
+	list_for_item(plist, &profile_list) {
+		prof = container_of(plist, struct tb_comp_profile, list);
+		tb_profile_get_stats(prof, &stats);
+		fprintf(out, "%-16s %4u %9u %9.2f %9.2f %9.2f %9.2f %5.1f%%\n",
+			prof->name, prof->pipeline_id, prof->count,
+			stats.min / 1e3, stats.avg / 1e3, stats.max / 1e3,
+			stats.p99 / 1e3,
+			total ? 100.0 * prof->total / total : 0.0);
+	}
+}
+
+int tb_profile_write(const char *filename)
+{
+	struct tb_profile_stats stats;
+	struct tb_comp_profile *prof;
+	struct list_item *plist;
+	const char *ext = strrchr(filename, '.');
+	const char *sep = "";
+	bool json = ext && !strcmp(ext, ".json");
+	FILE *fh;
+
+	fh = fopen(filename, "w");
+	if (!fh) {
+		fprintf(stderr, "error: opening file %s\n", filename);
+		return -EINVAL;
+	}
+
+	if (json)
+		fprintf(fh, "{\n\t\"components\": [");
+	else
+		fprintf(fh, "name,id,pipeline,copies,min_ns,avg_ns,max_ns,p99_ns,total_ns\n");
+
+	list_for_item(plist, &profile_list) {
+		prof = container_of(plist, struct tb_comp_profile, list);
+		tb_profile_get_stats(prof, &stats);
+		if (json) {
+			fprintf(fh, "%s\n\t\t{\"name\": \"%s\", \"id\": %u, \"pipeline\": %u, ",
+				sep, prof->name, prof->id, prof->pipeline_id);
+			fprintf(fh, "\"copies\": %u, \"min_ns\": %u, \"avg_ns\": %u, ",
+				prof->count, stats.min, stats.avg);
+			fprintf(fh, "\"max_ns\": %u, \"p99_ns\": %u, \"total_ns\": %" PRIu64 "}",
+				stats.max, stats.p99, prof->total);
+			sep = ",";
+		} else {
+			fprintf(fh, "%s,%u,%u,%u,%u,%u,%u,%u,%" PRIu64 "\n",
+				prof->name, prof->id, prof->pipeline_id,
+				prof->count, stats.min, stats.avg, stats.max,
+				stats.p99, prof->total);
+		}
+	}
+
+	if (json)
+		fprintf(fh, "\n\t]\n}\n");
+
+	fclose(fh);
+	return 0;
+}
+
+void tb_profile_free(void)
+{
+	struct tb_comp_profile *prof;
+	struct list_item *plist;
+	struct list_item *temp;
+
+	list_for_item_safe(plist, temp, &profile_list) {
+		prof = container_of(plist, struct tb_comp_profile, list);
+		list_item_del(&prof->list);
+		free(prof->samples);
+		free(prof);
+	}
+}
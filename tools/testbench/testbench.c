@@ -6,6 +6,7 @@
 //         Ranjani Sridharan <ranjani.sridharan@linux.intel.com>
 
 #include <sof/drivers/ipc.h>
+#include <sof/lib/alloc.h>
 #include <sof/list.h>
 #include <getopt.h>
 #include <dlfcn.h>
@@ -13,6 +14,7 @@
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
 #include "testbench/file.h"
+#include "testbench/profile.h"
 
 #define DECLARE_SOF_TB_UUID(entity_name, uuid_name,			\
 			 va, vb, vc,					\
@@ -135,8 +137,11 @@ static void print_usage(char *executable)
 	printf("Usage: %s -i <input_file> ", executable);
 	printf("-o <output_file1,output_file2,...> ");
 	printf("-t <tplg_file> -b <input_format> -c <channels>");
-	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
+	printf("-a <comp1=comp1_library,comp2=comp2_library> ");
+	printf("-p <profile.csv|profile.json>\n");
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("files with .txt suffix are text, .wav are WAV, others raw\n");
+	printf("-p measures copy() time of each component\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 -c 2");
@@ -155,30 +160,70 @@ static void free_comps(void)
 		switch (icd->type) {
 		case COMP_TYPE_COMPONENT:
 			comp_free(icd->cd);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		case COMP_TYPE_BUFFER:
 			rfree(icd->cb->stream.addr);
 			rfree(icd->cb);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		default:
 			rfree(icd->pipeline);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		}
 	}
 }
 
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+/* print heap usage of components, buffers and pipelines */
+static void print_mem_usage(void)
+{
+	static const char * const owners[] = { "comp", "buffer", "pipeline" };
+	static const char * const zones[MM_USAGE_ZONES] = {
+		"Sys", "SysRuntime", "Runtime", "Buffer" };
+	struct mm_usage_info *info;
+	int count = mm_usage_get(NULL, 0);
+	int zone;
+	int i;
+
+	if (!count)
+		return;
+
+	info = calloc(count, sizeof(*info));
+	if (!info)
+		return;
+
+	count = MIN(count, mm_usage_get(info, count));
+
+	printf("Heap usage in bytes, current/peak:\n");
+	printf("%-8s %4s %4s", "Owner", "Id", "Pipe");
+	for (zone = 0; zone < MM_USAGE_ZONES; zone++)
+		printf(" %15s", zones[zone]);
+	printf("\n");
+
+	for (i = 0; i < count; i++) {
+		printf("%-8s %4u %4u", owners[info[i].owner], info[i].id,
+		       info[i].pipeline_id);
+		for (zone = 0; zone < MM_USAGE_ZONES; zone++)
+			printf(" %7u/%-7u", info[i].used[zone],
+			       info[i].peak[zone]);
+		printf("\n");
+	}
+
+	free(info);
+}
+#endif
+
 static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 {
 	int option = 0;
 	int ret = 0;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:c:")) != -1) {
+	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:c:p:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -221,6 +266,11 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->channels = atoi(optarg);
 			break;
 
+		/* component profile output file */
+		case 'p':
+			tp->profile_file = strdup(optarg);
+			break;
+
 		/* enable debug prints */
 		case 'd':
 			debug = 1;
@@ -259,6 +309,7 @@ int main(int argc, char **argv)
 	tp.bits_in = 0;
 	tp.input_file = NULL;
 	tp.tplg_file = NULL;
+	tp.profile_file = NULL;
 	for (i = 0; i < MAX_OUTPUT_FILE_NUM; i++)
 		tp.output_file[i] = NULL;
 	tp.output_file_num = 0;
@@ -321,6 +372,12 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	/* measure components copy() */
+	if (tp.profile_file && tb_profile_init(sof_get()) < 0) {
+		fprintf(stderr, "error: profile init\n");
+		exit(EXIT_FAILURE);
+	}
+
 	cd = pcm_dev->cd;
 	tb_enable_trace(false); /* reduce trace output */
 	tic = clock();
@@ -363,9 +420,6 @@ int main(int argc, char **argv)
 	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
 	c_realtime = (double)n_out / tp.channels / tp.fs_out / t_exec;
 
-	/* free all components/buffers in pipeline */
-	free_comps();
-
 	/* print test summary */
 	printf("==========================================================\n");
 	printf("		           Test Summary\n");
@@ -383,11 +437,32 @@ int main(int argc, char **argv)
 	printf("Output sample count: %d\n", n_out);
 	printf("Total execution time: %.2f us, %.2f x realtime\n",
 	       1e3 * t_exec, c_realtime);
+	if (tp.profile_file) {
+		printf("Component copy() times:\n");
+		tb_profile_print(stdout);
+		if (tb_profile_write(tp.profile_file) < 0)
+			ret = -EINVAL;
+		else
+			printf("Profile written to file: \"%s\"\n",
+			       tp.profile_file);
+	}
+
+#if CONFIG_DEBUG_MEMORY_USAGE_COMP
+	print_mem_usage();
+#endif
+
+	/* free all components/buffers in pipeline */
+	free_comps();
+
+	/* profiled components use drivers of the profile data */
+	if (tp.profile_file)
+		tb_profile_free();
 
 	/* free all other data */
 	free(tp.bits_in);
 	free(tp.input_file);
 	free(tp.tplg_file);
+	free(tp.profile_file);
 	for (i = 0; i < tp.output_file_num; i++)
 		free(tp.output_file[i]);
 
@@ -397,5 +472,5 @@ int main(int argc, char **argv)
 			dlclose(lib_table[i].handle);
 	}
 
-	return EXIT_SUCCESS;
+	return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -34,11 +34,13 @@ static const struct frame_types sof_frames[] = {
 	/* TODO: fix topology to use ALSA formats */
 	{"s16le", SOF_IPC_FRAME_S16_LE},
 	{"s24le", SOF_IPC_FRAME_S24_4LE},
+	{"s24_3le", SOF_IPC_FRAME_S24_3LE},
 	{"s32le", SOF_IPC_FRAME_S32_LE},
 	{"float", SOF_IPC_FRAME_FLOAT},
 	/* ALSA formats */
 	{"S16_LE", SOF_IPC_FRAME_S16_LE},
 	{"S24_LE", SOF_IPC_FRAME_S24_4LE},
+	{"S24_3LE", SOF_IPC_FRAME_S24_3LE},
 	{"S32_LE", SOF_IPC_FRAME_S32_LE},
 	{"FLOAT_LE", SOF_IPC_FRAME_FLOAT},
 };
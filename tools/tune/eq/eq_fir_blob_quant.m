@@ -83,7 +83,8 @@ end
 %% Pack data into FIR coefficient format
 %	int16_t length
 %	int16_t out_shift
-%	uint32_t reserved[4]
+%	uint32_t mode, zero for automatic time or frequency domain
+%	uint32_t reserved[3]
 %	int16_t coef[]
 fbr = [nnew shift 0 0 0 0 0 0 0 0 bqp];
 